@@ -0,0 +1,261 @@
+#include "BenchCommon.h"
+#include <core/common/Logger.h>
+#include <core/common/PcapFile.h>
+#include <core/common/ydlidar_help.h>
+#include <core/common/ydlidar_protocol.h>
+#include <arpa/inet.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace ydlidar {
+namespace bench {
+
+using namespace core::common;
+
+#ifndef BENCH_SDK_VERSION
+#define BENCH_SDK_VERSION "unknown"
+#endif
+
+static void usage(const char *name) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --pcap FILE        recorded capture instead of synthetic frames\n"
+            "  --data-port P      data port of the capture (8000)\n"
+            "  --frames N         synthetic frames (20000)\n"
+            "  --iterations N     passes over the stream (decode, 10) or scans per\n"
+            "                     strategy (filter, 1000)\n"
+            "  --speed HZ         synthetic scan frequency (10)\n"
+            "  --samplerate K     synthetic thousands of points per second (20)\n"
+            "  --label TEXT       copied to every record\n"
+            "  --csv              CSV instead of JSON lines\n"
+            "  --verbose          keep the SDK log\n",
+            name);
+}
+
+bool parseOptions(int argc, char *argv[], BenchOptions &options) {
+    for (int i = 1; i < argc; i++) {
+        const char *opt = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!strcmp(opt, "--csv")) {
+            options.csv = true;
+            continue;
+        }
+        if (!strcmp(opt, "--verbose")) {
+            options.verbose = true;
+            continue;
+        }
+        if (!val) {
+            usage(argv[0]);
+            return false;
+        }
+        i++;
+        if (!strcmp(opt, "--pcap")) {
+            options.pcap = val;
+        } else if (!strcmp(opt, "--data-port")) {
+            options.dataPort = atoi(val);
+        } else if (!strcmp(opt, "--frames")) {
+            options.frames = atoi(val);
+        } else if (!strcmp(opt, "--iterations")) {
+            options.iterations = atoi(val);
+        } else if (!strcmp(opt, "--speed")) {
+            options.speed = atoi(val);
+        } else if (!strcmp(opt, "--samplerate")) {
+            options.samplerate = atoi(val);
+        } else if (!strcmp(opt, "--label")) {
+            options.label = val;
+        } else {
+            usage(argv[0]);
+            return false;
+        }
+    }
+    Logger::setLevel(options.verbose ? LogLevelDebug : LogLevelOff);
+    options.speed = options.speed < 1 ? 1 : options.speed;
+    options.samplerate = options.samplerate < 1 ? 1 : options.samplerate;
+    return true;
+}
+
+/*-------------------------------------------------------------
+                        合成数据
+-------------------------------------------------------------*/
+/// range of the room wall seen at angle, in mm
+static double roomRange(double rad) {
+    double c = fabs(cos(rad)), s = fabs(sin(rad));
+    return fmin(c > 1e-6 ? 3000.0 / c : 1e9, s > 1e-6 ? 2000.0 / s : 1e9);
+}
+
+void makeSyntheticStream(const BenchOptions &options,
+                         std::vector<std::vector<uint8_t> > &datagrams) {
+    //帧数取2000的整数倍：824 * 2000字节恰好是500字节的整数倍，且帧计数回到0
+    const uint32_t cycle = 2000;
+    uint32_t frames = (options.frames + cycle - 1) / cycle * cycle;
+    frames = frames ? frames : cycle;
+
+    uint32_t step = 36000 * options.speed / (options.samplerate * 1000);
+    step = step < 1 ? 1 : (step > 63 ? 63 : step);
+
+    std::vector<uint8_t> stream;
+    stream.reserve(static_cast<size_t>(frames) * NETDATAFRAMESIXE);
+    uint32_t angle = 0;
+    uint32_t stamp = 0;
+    uint32_t frameUs = DATABLOCK_COUNT * DATA_COUNT * 1000 / options.samplerate;
+    for (uint32_t f = 0; f < frames; f++) {
+        //成员都有默认值，不足DATA_COUNT的块尾部为0
+        NetDataFrame frame = NetDataFrame();
+        for (int i = 0; i < DATABLOCK_COUNT; i++) {
+            NetDataBlock &block = frame.dataBlock[i];
+            block.frameHead = BigLittleSwap16(0xFFEE);
+            block.startAngle = BigLittleSwap16(angle);
+            uint32_t add = 0;
+            for (int j = 0; j < DATA_COUNT; j++) {
+                add += step;
+                uint32_t a = angle + add;
+                if (a >= 36000) {
+                    break;
+                }
+                double range = roomRange(a * M_PI / 18000.0);
+                uint32_t distance = range > 65535 ? 65535 : static_cast<uint32_t>(range);
+                uint32_t quality = 100 + (a / 100) % 100;
+                block.data[j] = BigLittleSwap32((step << 24) | (quality << 16) | distance);
+            }
+            angle += add;
+            if (angle >= 36000 - step) {
+                angle = 0;
+            }
+        }
+        stamp += frameUs;
+        frame.timeStamp = BigLittleSwap32(stamp);
+        uint8_t *p = reinterpret_cast<uint8_t *>(&frame);
+        p[NETDATAFRAMESIXE - 4] = f & 0x0F;
+        p[NETDATAFRAMESIXE - 3] = 0x65;
+        p[NETDATAFRAMESIXE - 2] = 0x43;
+        p[NETDATAFRAMESIXE - 1] = 0x21;
+        stream.insert(stream.end(), p, p + NETDATAFRAMESIXE);
+    }
+
+    datagrams.clear();
+    for (size_t pos = 0; pos + DATA_ONESIZE <= stream.size(); pos += DATA_ONESIZE) {
+        datagrams.push_back(std::vector<uint8_t>(stream.begin() + pos,
+                                                 stream.begin() + pos + DATA_ONESIZE));
+    }
+}
+
+bool loadCapture(const std::string &path, uint16_t port,
+                 std::vector<std::vector<uint8_t> > &datagrams) {
+    PcapReader reader;
+    if (!reader.open(path.c_str())) {
+        return false;
+    }
+    datagrams.clear();
+    PcapPacket packet;
+    while (reader.next(packet)) {
+        if (packet.protocol == PcapWriter::ProtocolUdp && packet.dstPort == port &&
+            packet.length) {
+            datagrams.push_back(std::vector<uint8_t>(packet.payload,
+                                                     packet.payload + packet.length));
+        }
+    }
+    return !datagrams.empty();
+}
+
+BenchCapture::BenchCapture()
+    : m_port(8000), m_temporary(false) {
+}
+
+BenchCapture::~BenchCapture() {
+    if (m_temporary) {
+        unlink(m_path.c_str());
+    }
+}
+
+bool BenchCapture::open(const BenchOptions &options) {
+    if (!options.pcap.empty()) {
+        m_path = options.pcap;
+        m_port = options.dataPort;
+        return access(m_path.c_str(), R_OK) == 0;
+    }
+
+    std::vector<std::vector<uint8_t> > datagrams;
+    makeSyntheticStream(options, datagrams);
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/tea_bench_%d.pcap", static_cast<int>(getpid()));
+    PcapWriter writer;
+    if (!writer.open(path)) {
+        return false;
+    }
+    m_path = path;
+    m_port = 8000;
+    m_temporary = true;
+    //按500字节数据报在雷达采样率下的间隔打时间戳
+    uint64_t stamp = 1700000000000000ull;
+    uint64_t gap = DATA_ONESIZE * (DATABLOCK_COUNT * DATA_COUNT * 1000ull / options.samplerate) /
+                   NETDATAFRAMESIXE;
+    for (size_t i = 0; i < datagrams.size(); i++) {
+        writer.writeUdp(inet_addr("192.168.0.11"), 8000, 0, m_port,
+                        &datagrams[i][0], datagrams[i].size(), stamp);
+        stamp += gap;
+    }
+    writer.close();
+    return true;
+}
+
+void makeSyntheticScan(size_t points, LaserScan &scan) {
+    points = points < 2 ? 2 : points;
+    scan.points.resize(points);
+    //与CYdLidar输出一致，点的角度单位为度
+    scan.config.min_angle = 0;
+    scan.config.max_angle = 2 * M_PI;
+    scan.config.angle_increment = 2 * M_PI / points;
+    scan.config.time_increment = 0;
+    scan.config.scan_time = 0.1f;
+    scan.config.min_range = 0.01f;
+    scan.config.max_range = 64.0f;
+    for (size_t i = 0; i < points; i++) {
+        LaserPoint &p = scan.points[i];
+        p.angle = i * 360.0f / points;
+        p.range = roomRange(p.angle * M_PI / 180.0) / 1000.0;
+        p.intensity = 100;
+        //每个0.5米的柱子后面拖出一段逐渐变远的混合点
+        size_t k = i % (points / 8 ? points / 8 : 1);
+        if (k < 10) {
+            p.range = 0.5f + k * 0.15f;
+        }
+    }
+}
+
+/*-------------------------------------------------------------
+                        输出
+-------------------------------------------------------------*/
+BenchReporter::BenchReporter(const BenchOptions &options)
+    : m_csv(options.csv), m_header(false), m_label(options.label) {
+}
+
+void BenchReporter::report(const BenchRecord &r) {
+    double throughput = r.seconds > 0 ? r.items / r.seconds : 0;
+    double nsPerItem = r.items ? r.seconds * 1e9 / r.items : 0;
+    if (m_csv) {
+        if (!m_header) {
+            fprintf(stdout, "sdk,label,benchmark,unit,items,seconds,throughput,ns_per_item,"
+                    "samples,p50_us,p99_us,p999_us,max_us\n");
+            m_header = true;
+        }
+        fprintf(stdout, "%s,%s,%s,%s,%llu,%.6f,%.1f,%.1f,%llu,%u,%u,%u,%u\n",
+                BENCH_SDK_VERSION, m_label.c_str(), r.benchmark.c_str(), r.unit.c_str(),
+                (unsigned long long)r.items, r.seconds, throughput, nsPerItem,
+                (unsigned long long)r.latency.count, r.latency.p50, r.latency.p99,
+                r.latency.p999, r.latency.max);
+    } else {
+        fprintf(stdout, "{\"sdk\":\"%s\",\"label\":\"%s\",\"benchmark\":\"%s\",\"unit\":\"%s\","
+                "\"items\":%llu,\"seconds\":%.6f,\"throughput\":%.1f,\"ns_per_item\":%.1f,"
+                "\"samples\":%llu,\"p50_us\":%u,\"p99_us\":%u,\"p999_us\":%u,\"max_us\":%u}\n",
+                BENCH_SDK_VERSION, m_label.c_str(), r.benchmark.c_str(), r.unit.c_str(),
+                (unsigned long long)r.items, r.seconds, throughput, nsPerItem,
+                (unsigned long long)r.latency.count, r.latency.p50, r.latency.p99,
+                r.latency.p999, r.latency.max);
+    }
+    fflush(stdout);
+}
+
+}//bench
+}//ydlidar
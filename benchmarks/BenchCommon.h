@@ -0,0 +1,120 @@
+#pragma once
+#include <core/base/v8stdint.h>
+#include <core/common/ydlidar_def.h>
+#include <core/common/ydlidar_datatype.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace ydlidar {
+namespace bench {
+
+/**
+ * @brief Command line options shared by all benchmarks.
+ */
+struct BenchOptions {
+    std::string pcap;       ///< recorded capture, synthetic frames if empty
+    uint16_t dataPort;      ///< data port of the capture
+    uint32_t frames;        ///< synthetic frames, rounded up to a whole stream cycle
+    uint32_t iterations;    ///< passes or scans of the in-memory benchmarks, 0 for their default
+    int speed;              ///< synthetic scan frequency in Hz
+    int samplerate;         ///< synthetic thousands of points per second
+    bool csv;               ///< CSV instead of JSON lines
+    bool verbose;           ///< keep the SDK log, off by default to keep stdout parseable
+    std::string label;      ///< free text copied to every record, e.g. the host name
+
+    BenchOptions()
+        : dataPort(8000), frames(20000), iterations(0), speed(10), samplerate(20),
+          csv(false), verbose(false) {}
+};
+
+/**
+ * @brief Parse the shared options and silence the SDK log unless verbose
+ * @return false if an option is unknown, the usage has been printed.
+ */
+bool parseOptions(int argc, char *argv[], BenchOptions &options);
+
+/**
+ * @brief Build a deterministic TEA data stream of a 4 m x 6 m room.
+ * The frame count is rounded up so that the stream ends on both a frame and
+ * a datagram boundary with the 4 bit frame counter back at zero, which lets
+ * the stream be replayed in a loop without a resync.
+ * @param[out] datagrams  DATA_ONESIZE datagrams
+ */
+void makeSyntheticStream(const BenchOptions &options,
+                         std::vector<std::vector<uint8_t> > &datagrams);
+
+/**
+ * @brief Load the data port datagrams of a capture
+ * @return false if the file cannot be read or holds no datagram.
+ */
+bool loadCapture(const std::string &path, uint16_t port,
+                 std::vector<std::vector<uint8_t> > &datagrams);
+
+/**
+ * @brief Capture file fed to the replay based benchmarks.
+ * Either the recorded capture of the options or a temporary file holding
+ * the synthetic stream, removed on destruction.
+ */
+class BenchCapture {
+public:
+    BenchCapture();
+    ~BenchCapture();
+
+    bool open(const BenchOptions &options);
+
+    const std::string &path() const {
+        return m_path;
+    }
+
+    uint16_t port() const {
+        return m_port;
+    }
+
+private:
+    std::string m_path;
+    uint16_t m_port;
+    bool m_temporary;
+};
+
+/**
+ * @brief A synthetic scan for the filter benchmarks, with mixed pixels
+ * trailing from the near edges. Angles are in degrees like CYdLidar scans.
+ * @param points  points per revolution
+ */
+void makeSyntheticScan(size_t points, LaserScan &scan);
+
+/**
+ * @brief One result line.
+ * Throughput is items per second, latencies are in microseconds.
+ */
+struct BenchRecord {
+    std::string benchmark;  ///< e.g. decode, assembly
+    std::string unit;       ///< what an item is, e.g. frames, scans
+    uint64_t items;
+    double seconds;
+    LidarLatency latency;   ///< per item, count 0 if not measured
+
+    BenchRecord() : items(0), seconds(0) {
+        latency.count = 0;
+        latency.p50 = latency.p99 = latency.p999 = latency.max = 0;
+    }
+};
+
+/**
+ * @brief Write records as JSON lines or CSV to stdout.
+ */
+class BenchReporter {
+public:
+    explicit BenchReporter(const BenchOptions &options);
+
+    void report(const BenchRecord &record);
+
+private:
+    bool m_csv;
+    bool m_header;
+    std::string m_label;
+};
+
+}//bench
+}//ydlidar
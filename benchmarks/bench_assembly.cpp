@@ -0,0 +1,71 @@
+#include "BenchCommon.h"
+#include "PcapReplayDriver.h"
+#include <core/base/timer.h>
+using namespace ydlidar;
+using namespace ydlidar::bench;
+
+//整圈组包和交付：回放驱动以最快速度喂数据，cacheScanData组包，本线程grabScanData取走
+int main(int argc, char *argv[])
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+    BenchCapture capture;
+    if (!capture.open(options)) {
+        fprintf(stderr, "Cannot open the capture\n");
+        return 1;
+    }
+
+    PcapReplayDriver driver(false, false);
+    if (!IS_OK(driver.connect(capture.path().c_str(), capture.port()))) {
+        return 1;
+    }
+    static node_info nodes[DriverInterface::MAX_SCAN_NODES];
+    uint64_t consumed = 0;
+    uint64_t start = getus();
+    if (!IS_OK(driver.startScan())) {
+        return 1;
+    }
+    while (true) {
+        size_t count = _countof(nodes);
+        if (IS_OK(driver.grabScanData(nodes, count, 200))) {
+            consumed++;
+        } else if (driver.isFinished()) {
+            break;
+        }
+    }
+    double seconds = (getus() - start) / 1e6;
+    driver.stopScan();
+
+    LidarMetrics metrics;
+    driver.getMetrics(metrics);
+    BenchReporter reporter(options);
+
+    BenchRecord record;
+    record.benchmark = "replay";
+    record.unit = "frames";
+    record.items = metrics.frames;
+    record.seconds = seconds;
+    reporter.report(record);
+
+    record.benchmark = "assembly";
+    record.unit = "scans";
+    record.items = metrics.scansPublished;
+    driver.getLatency(LatencyStageAssembly, record.latency);
+    reporter.report(record);
+
+    record.benchmark = "handoff";
+    record.unit = "scans";
+    record.items = consumed;
+    driver.getLatency(LatencyStageHandoff, record.latency);
+    reporter.report(record);
+
+    if (metrics.scansDropped) {
+        fprintf(stderr, "%llu of %llu scans dropped by the scan queue\n",
+                (unsigned long long)metrics.scansDropped,
+                (unsigned long long)metrics.scansPublished);
+    }
+    driver.disconnect();
+    return 0;
+}
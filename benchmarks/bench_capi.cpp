@@ -0,0 +1,82 @@
+#include "BenchCommon.h"
+#include "ydlidar_sdk.h"
+#include <core/base/timer.h>
+#include <core/common/LatencyHistogram.h>
+#include <atomic>
+using namespace ydlidar;
+using namespace ydlidar::bench;
+
+/// end of the replay, set by the state callback
+struct ReplayEnd {
+    std::atomic<bool> finished;
+    std::atomic<uint64_t> end;
+
+    ReplayEnd() : finished(false), end(0) {}
+};
+
+static void onState(LidarState state, void *user) {
+    //回放结束后驱动回到已连接状态，不计doProcessSimple随后的超时等待
+    if (state == LidarStateConnected || state == LidarStateDisconnected) {
+        ReplayEnd *replay = static_cast<ReplayEnd *>(user);
+        replay->end = getus();
+        replay->finished = true;
+    }
+}
+
+//C接口封送：与bench_convert相同的回放，经由doProcessSimple(YDLidar*, LaserFan*)取数据，
+//队列中有现成扫描时，调用耗时减去Convert阶段即为LaserScan到LaserFan的拷贝开销
+int main(int argc, char *argv[])
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+    BenchCapture capture;
+    if (!capture.open(options)) {
+        fprintf(stderr, "Cannot open the capture\n");
+        return 1;
+    }
+
+    YDLidar *lidar = lidarCreate();
+    ReplayEnd replay;
+    setStateCallback(lidar, onState, &replay);
+    setReplayFile(lidar, capture.path().c_str(), false);
+    if (!initialize(lidar)) {
+        lidarDestroy(&lidar);
+        return 1;
+    }
+    replay.finished = false;
+    LaserFan scan;
+    LaserFanInit(&scan);
+    core::common::LatencyHistogram latency;
+    uint64_t scans = 0;
+    uint64_t start = getus();
+    bool ret = turnOn(lidar);
+    while (ret && !replay.finished) {
+        uint64_t t = getus();
+        if (doProcessSimple(lidar, &scan)) {
+            latency.record(getus() - t);
+            scans++;
+        }
+    }
+    double seconds = ((replay.finished ? replay.end.load() : getus()) - start) / 1e6;
+    LaserFanDestroy(&scan);
+
+    BenchReporter reporter(options);
+    BenchRecord record;
+    record.benchmark = "capi";
+    record.unit = "scans";
+    record.items = scans;
+    record.seconds = seconds;
+    latency.snapshot(record.latency);
+    reporter.report(record);
+
+    record.benchmark = "capi_convert";
+    getLatency(lidar, LatencyStageConvert, &record.latency);
+    reporter.report(record);
+
+    turnOff(lidar);
+    disconnecting(lidar);
+    lidarDestroy(&lidar);
+    return 0;
+}
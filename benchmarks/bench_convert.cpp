@@ -0,0 +1,99 @@
+#include "BenchCommon.h"
+#include "CYdLidar.h"
+#include <core/common/CloudFusion.h>
+#include <core/base/timer.h>
+#include <atomic>
+using namespace ydlidar;
+using namespace ydlidar::bench;
+
+//doProcessSimple转换：CYdLidar回放抓包文件，统计LaserScan输出速度
+int main(int argc, char *argv[])
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+    BenchCapture capture;
+    if (!capture.open(options)) {
+        fprintf(stderr, "Cannot open the capture\n");
+        return 1;
+    }
+
+    CYdLidar lidar;
+    std::atomic<bool> finished(false);
+    std::atomic<uint64_t> end(0);
+    lidar.setStateCallback([&finished, &end](LidarState state) {
+        //回放结束后驱动回到已连接状态，不计doProcessSimple随后的超时等待
+        if (state == LidarStateConnected || state == LidarStateDisconnected) {
+            end = getus();
+            finished = true;
+        }
+    });
+    lidar.setReplayFile(capture.path().c_str(), false);
+    if (!lidar.initialize()) {
+        return 1;
+    }
+    finished = false;
+    LaserScan scan;
+    uint64_t scans = 0;
+    uint64_t points = 0;
+    //笛卡尔坐标转换单独计时，不计入doProcessSimple
+    CartesianConverter converter;
+    converter.setTransform(0.1f, -0.05f, 90.f);
+    CartesianScan cloud;
+    uint64_t cartesian = 0;
+    //同一圈当作三台不同安装位姿的雷达融合，重叠部分去重
+    CloudFusion fusion;
+    fusion.setExtrinsics(0, 0.3f, 0.f, 0.f);
+    fusion.setExtrinsics(1, -0.2f, 0.25f, 120.f);
+    fusion.setExtrinsics(2, -0.2f, -0.25f, -120.f);
+    fusion.setDeduplication(1.f, 0.05f, 20.f);
+    ScanSet set;
+    set.scans.resize(3);
+    FusedCloud fused;
+    uint64_t fusing = 0;
+    uint64_t start = getus();
+    bool ret = lidar.turnOn();
+    while (ret && !finished) {
+        if (lidar.doProcessSimple(scan)) {
+            scans++;
+            points += scan.points.size();
+            uint64_t convert_start = getus();
+            converter.convert(scan, cloud);
+            cartesian += getus() - convert_start;
+            set.scans.assign(3, scan);
+            uint64_t fuse_start = getus();
+            fusion.fuse(set, fused);
+            fusing += getus() - fuse_start;
+        }
+    }
+    double seconds = ((finished ? end.load() : getus()) - start) / 1e6;
+
+    BenchReporter reporter(options);
+    BenchRecord record;
+    record.benchmark = "convert";
+    record.unit = "scans";
+    record.items = scans;
+    record.seconds = seconds;
+    lidar.getLatency(LatencyStageConvert, record.latency);
+    reporter.report(record);
+
+    record.benchmark = "convert_points";
+    record.unit = "points";
+    record.items = points;
+    record.latency = BenchRecord().latency;
+    reporter.report(record);
+
+    record.benchmark = "convert_cartesian";
+    record.seconds = cartesian / 1e6;
+    reporter.report(record);
+
+    record.benchmark = "convert_fused";
+    record.items = points * 3;
+    record.seconds = fusing / 1e6;
+    reporter.report(record);
+
+    lidar.turnOff();
+    lidar.disconnecting();
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include "BenchCommon.h"
+#include "TEALidarDriver.h"
+#include <core/base/timer.h>
+#include <core/common/LatencyHistogram.h>
+using namespace ydlidar;
+using namespace ydlidar::bench;
+
+/// TEALidarDriver fed from datagrams held in memory, replayed in a loop
+class MemoryDriver : public TEALidarDriver {
+public:
+    explicit MemoryDriver(const std::vector<std::vector<uint8_t> > &datagrams)
+        : m_datagrams(datagrams), m_next(0) {
+    }
+
+    result_t decode(node_info *nodebuffer, size_t &count) {
+        return waitScanData(nodebuffer, count);
+    }
+
+protected:
+    virtual int32_t receiveData(uint8_t *buf, uint32_t len) {
+        const std::vector<uint8_t> &d = m_datagrams[m_next];
+        m_next = (m_next + 1) % m_datagrams.size();
+        uint32_t l = d.size() < len ? d.size() : len;
+        memcpy(buf, &d[0], l);
+        return l;
+    }
+
+private:
+    const std::vector<std::vector<uint8_t> > &m_datagrams;
+    size_t m_next;
+};
+
+//原始帧解码：从内存中的数据报重组并解析大包，不经过网络和线程
+int main(int argc, char *argv[])
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+    std::vector<std::vector<uint8_t> > datagrams;
+    if (!options.pcap.empty()) {
+        if (!loadCapture(options.pcap, options.dataPort, datagrams)) {
+            fprintf(stderr, "No data port datagrams in %s\n", options.pcap.c_str());
+            return 1;
+        }
+    } else {
+        makeSyntheticStream(options, datagrams);
+    }
+
+    MemoryDriver driver(datagrams);
+    static node_info nodes[DATABLOCK_COUNT * DATA_COUNT];
+    size_t count = 0;
+    //每轮数据报能解出的帧数
+    uint64_t bytes = 0;
+    for (size_t i = 0; i < datagrams.size(); i++) {
+        bytes += datagrams[i].size();
+    }
+    uint32_t passes = options.iterations ? options.iterations : 10;
+    uint64_t frames = bytes / NETDATAFRAMESIXE * passes;
+    frames = frames ? frames : 1;
+
+    core::common::LatencyHistogram latency;
+    uint64_t decoded = 0;
+    uint64_t points = 0;
+    uint64_t start = getus();
+    for (uint64_t i = 0; i < frames; i++) {
+        uint64_t t = getus();
+        if (IS_OK(driver.decode(nodes, count))) {
+            latency.record(getus() - t);
+            decoded++;
+            points += count;
+        }
+    }
+    double seconds = (getus() - start) / 1e6;
+
+    BenchReporter reporter(options);
+    BenchRecord record;
+    record.benchmark = "decode";
+    record.unit = "frames";
+    record.items = decoded;
+    record.seconds = seconds;
+    latency.snapshot(record.latency);
+    reporter.report(record);
+
+    record.benchmark = "decode_points";
+    record.unit = "points";
+    record.items = points;
+    record.latency = BenchRecord().latency;
+    reporter.report(record);
+
+    const char *names[] = {"reassembly", "decode_stage"};
+    const int stages[] = {LatencyStageReassembly, LatencyStageDecode};
+    for (int i = 0; i < 2; i++) {
+        record = BenchRecord();
+        record.benchmark = names[i];
+        record.unit = "frames";
+        driver.getLatency(stages[i], record.latency);
+        record.items = record.latency.count;
+        record.seconds = seconds;
+        reporter.report(record);
+    }
+    return 0;
+}
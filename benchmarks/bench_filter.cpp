@@ -0,0 +1,116 @@
+#include "BenchCommon.h"
+#include "filters/NoiseFilter.h"
+#include "filters/StreamingNoiseFilter.h"
+#include "filters/TemporalFilter.h"
+#include <core/base/timer.h>
+#include <core/common/LatencyHistogram.h>
+#include <core/common/ydlidar_help.h>
+#include <core/common/ydlidar_protocol.h>
+#include <algorithm>
+using namespace ydlidar;
+using namespace ydlidar::bench;
+
+//NoiseFilter：对合成的一圈扫描反复滤波，每种策略一条结果；
+//StreamingNoiseFilter：同一圈扫描按192点的扇区连续送入，统计每个扇区的耗时；
+//TemporalFilter：默认5圈历史，两种策略各一条结果
+int main(int argc, char *argv[])
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+    uint32_t scans = options.iterations ? options.iterations : 1000;
+    size_t points = options.samplerate * 1000 / options.speed;
+
+    LaserScan in;
+    LaserScan work;
+    makeSyntheticScan(points, in);
+
+    const char *names[] = {"filter_normal", "filter_tail", "filter_tail_strong",
+                           "filter_tail_week", "filter_tail_strong2"};
+    const int strategies[] = {NoiseFilter::FS_Normal, NoiseFilter::FS_Tail,
+                              NoiseFilter::FS_TailStrong, NoiseFilter::FS_TailWeek,
+                              NoiseFilter::FS_TailStrong2};
+    BenchReporter reporter(options);
+    for (int s = 0; s < _countof(strategies); s++) {
+        NoiseFilter filter;
+        filter.setStrategy(strategies[s]);
+        core::common::LatencyHistogram latency;
+        uint64_t total = 0;
+        for (uint32_t i = 0; i < scans; i++) {
+            //与CYdLidar一样原地滤波，恢复输入不计入耗时
+            work = in;
+            uint64_t t = getus();
+            filter.filter(work, 0, 0, work);
+            uint64_t us = getus() - t;
+            latency.record(us);
+            total += us;
+        }
+
+        BenchRecord record;
+        record.benchmark = names[s];
+        record.unit = "scans";
+        record.items = scans;
+        record.seconds = total / 1e6;
+        latency.snapshot(record.latency);
+        reporter.report(record);
+    }
+
+    const char *temporalNames[] = {"filter_temporal_confirm", "filter_temporal_median"};
+    const int temporalStrategies[] = {TemporalFilter::FS_Confirm, TemporalFilter::FS_Median};
+    for (int s = 0; s < _countof(temporalStrategies); s++) {
+        TemporalFilter filter;
+        filter.setStrategy(temporalStrategies[s]);
+        core::common::LatencyHistogram latency;
+        uint64_t total = 0;
+        for (uint32_t i = 0; i < scans; i++) {
+            work = in;
+            uint64_t t = getus();
+            filter.filter(work, 0, 0, work);
+            uint64_t us = getus() - t;
+            latency.record(us);
+            total += us;
+        }
+
+        BenchRecord record;
+        record.benchmark = temporalNames[s];
+        record.unit = "scans";
+        record.items = scans;
+        record.seconds = total / 1e6;
+        latency.snapshot(record.latency);
+        reporter.report(record);
+    }
+
+    const size_t sectorPoints = DATABLOCK_COUNT * DATA_COUNT;
+    LaserScan sector;
+    LaserScan out;
+    sector.config = in.config;
+    for (int s = 0; s < _countof(strategies); s++) {
+        StreamingNoiseFilter filter;
+        filter.setStrategy(strategies[s]);
+        core::common::LatencyHistogram latency;
+        uint64_t total = 0;
+        uint64_t sectors = 0;
+        for (uint32_t i = 0; i < scans; i++) {
+            for (size_t first = 0; first < in.points.size(); first += sectorPoints) {
+                size_t last = std::min(first + sectorPoints, in.points.size());
+                sector.points.assign(in.points.begin() + first, in.points.begin() + last);
+                uint64_t t = getus();
+                filter.push(sector, out);
+                uint64_t us = getus() - t;
+                latency.record(us);
+                total += us;
+                sectors++;
+            }
+        }
+
+        BenchRecord record;
+        record.benchmark = std::string("stream_") + names[s];
+        record.unit = "sectors";
+        record.items = sectors;
+        record.seconds = total / 1e6;
+        latency.snapshot(record.latency);
+        reporter.report(record);
+    }
+    return 0;
+}
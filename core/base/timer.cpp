@@ -19,6 +19,13 @@ uint32_t getHDTimer() {
   return (uint32_t)(current.QuadPart / (_current_freq.QuadPart));
 }
 
+uint64_t getHDTimerUs() {
+  LARGE_INTEGER current;
+  QueryPerformanceCounter(&current);
+
+  return (uint64_t)(current.QuadPart * 1000 / (_current_freq.QuadPart));
+}
+
 uint64_t getCurrentTime() {
   FILETIME		t;
   GetSystemTimeAsFileTime(&t);
@@ -41,6 +48,12 @@ uint32_t getHDTimer() {
   clock_gettime(CLOCK_MONOTONIC, &t);
   return t.tv_sec * 1000L + t.tv_nsec / 1000000L;
 }
+uint64_t getHDTimerUs() {
+  struct timespec t;
+  t.tv_sec = t.tv_nsec = 0;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return static_cast<uint64_t>(t.tv_sec) * 1000000ULL + t.tv_nsec / 1000L;
+}
 uint64_t getCurrentTime() {
 #if HAS_CLOCK_GETTIME
   struct timespec  tim;
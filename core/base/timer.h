@@ -42,8 +42,10 @@ namespace impl {
 void HPtimer_reset();
 #endif
 uint32_t getHDTimer();
+uint64_t getHDTimerUs();
 uint64_t getCurrentTime();
 } // namespace impl
 
 #define getms() impl::getHDTimer()
+#define getus() impl::getHDTimerUs()
 #define getTime() impl::getCurrentTime()
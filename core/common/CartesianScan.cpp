@@ -0,0 +1,206 @@
+#include "CartesianScan.h"
+#include <core/math/angles.h>
+#include <math.h>
+#include <string.h>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CARTESIAN_SSE2
+#endif
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+/*------ CartesianScan ------*/
+CartesianScan::CartesianScan()
+    : stamp(0),
+      seq(0),
+      dropped(0),
+      m_size(0),
+      m_stride(0) {
+}
+
+CartesianScan::CartesianScan(const CartesianScan &other)
+    : stamp(0),
+      seq(0),
+      dropped(0),
+      m_size(0),
+      m_stride(0) {
+    *this = other;
+}
+
+CartesianScan &CartesianScan::operator=(const CartesianScan &other) {
+    if (this != &other) {
+        //复制后缓冲区的对齐位置可能不同，逐个数组复制
+        resize(other.m_size);
+        memcpy(x(), other.x(), m_size * sizeof(float));
+        memcpy(y(), other.y(), m_size * sizeof(float));
+        memcpy(intensity(), other.intensity(), m_size * sizeof(float));
+        stamp = other.stamp;
+        seq = other.seq;
+        dropped = other.dropped;
+    }
+    return *this;
+}
+
+void CartesianScan::resize(size_t count) {
+    const size_t lanes = ALIGNMENT / sizeof(float);
+    size_t stride = (count + lanes - 1) / lanes * lanes;
+    if (stride > m_stride) {
+        m_buffer.resize(3 * stride + lanes);
+        m_stride = stride;
+    }
+    m_size = count;
+}
+
+float *CartesianScan::base() const {
+    if (m_buffer.empty()) {
+        return NULL;
+    }
+    uintptr_t p = reinterpret_cast<uintptr_t>(&m_buffer[0]);
+    p = (p + ALIGNMENT - 1) & ~static_cast<uintptr_t>(ALIGNMENT - 1);
+    return reinterpret_cast<float *>(p);
+}
+
+/*------ CartesianConverter ------*/
+CartesianConverter::CartesianConverter()
+    : m_cos(ANGLE_STEPS),
+      m_sin(ANGLE_STEPS),
+      m_x(0.f),
+      m_y(0.f),
+      m_yaw(NAN) {
+    setTransform(0.f, 0.f, 0.f);
+}
+
+void CartesianConverter::setTransform(float x, float y, float yaw) {
+    m_x = x;
+    m_y = y;
+    if (yaw == m_yaw) {
+        return;
+    }
+    m_yaw = yaw;
+    for (long k = 0; k < ANGLE_STEPS; k++) {
+        double rad = math::from_degrees(k / 100.0 + yaw);
+        m_cos[k] = static_cast<float>(cos(rad));
+        m_sin[k] = static_cast<float>(sin(rad));
+    }
+}
+
+long CartesianConverter::tableIndex(float angle) {
+    //与0.01度网格相差不到1e-4度时视为在网格上，误差远小于测距精度
+    double steps = angle * 100.0;
+    if (!(steps > -1e9 && steps < 1e9)) {
+        return -1;
+    }
+    long k = lround(steps);
+    if (!(fabs(steps - k) < 0.01)) {
+        return -1;
+    }
+    k %= ANGLE_STEPS;
+    return k < 0 ? k + ANGLE_STEPS : k;
+}
+
+void CartesianConverter::convert(const LaserScan &scan, CartesianScan &out) const {
+    const size_t count = scan.points.size();
+    out.resize(count);
+    out.stamp = scan.stamp;
+    out.seq = scan.seq;
+    out.dropped = scan.dropped;
+    float *xs = out.x();
+    float *ys = out.y();
+    float *intensities = out.intensity();
+
+    size_t i = 0;
+    while (i < count) {
+        i += project(scan, i, xs + i, ys + i, intensities + i);
+    }
+}
+
+void CartesianConverter::convert(const node_info *nodes, size_t count, CartesianScan &out) const {
+    out.resize(count);
+    out.stamp = (count && nodes[0].stamp > 0) ? nodes[0].stamp : 0;
+    float *xs = out.x();
+    float *ys = out.y();
+    float *intensities = out.intensity();
+    const float *cs = count ? &m_cos[0] : NULL;
+    const float *ss = count ? &m_sin[0] : NULL;
+
+    size_t i = 0;
+#ifdef CARTESIAN_SSE2
+    //距离与LaserScan一样除以1000，两条路径的结果逐位相同
+    const __m128 millimeters = _mm_set1_ps(1000.f);
+    const __m128 invalid = _mm_set1_ps(NAN);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 ox = _mm_set1_ps(m_x);
+    const __m128 oy = _mm_set1_ps(m_y);
+    for (; i + 4 <= count; i += 4) {
+        const node_info *n = nodes + i;
+        const uint32_t k0 = n[0].angle_q6_checkbit % ANGLE_STEPS;
+        const uint32_t k1 = n[1].angle_q6_checkbit % ANGLE_STEPS;
+        const uint32_t k2 = n[2].angle_q6_checkbit % ANGLE_STEPS;
+        const uint32_t k3 = n[3].angle_q6_checkbit % ANGLE_STEPS;
+        __m128 c = _mm_setr_ps(cs[k0], cs[k1], cs[k2], cs[k3]);
+        __m128 s = _mm_setr_ps(ss[k0], ss[k1], ss[k2], ss[k3]);
+        __m128 range = _mm_div_ps(_mm_cvtepi32_ps(_mm_setr_epi32(n[0].distance_q2, n[1].distance_q2,
+                                                                 n[2].distance_q2, n[3].distance_q2)),
+                                  millimeters);
+        //无效点的距离记为NaN，乘加后x、y也是NaN
+        __m128 mask = _mm_cmpeq_ps(range, zero);
+        range = _mm_or_ps(_mm_andnot_ps(mask, range), _mm_and_ps(mask, invalid));
+        _mm_storeu_ps(xs + i, _mm_add_ps(_mm_mul_ps(range, c), ox));
+        _mm_storeu_ps(ys + i, _mm_add_ps(_mm_mul_ps(range, s), oy));
+        _mm_storeu_ps(intensities + i, _mm_cvtepi32_ps(_mm_setr_epi32(n[0].sync_quality, n[1].sync_quality,
+                                                                        n[2].sync_quality, n[3].sync_quality)));
+    }
+#endif
+    for (; i < count; i++) {
+        const uint32_t k = nodes[i].angle_q6_checkbit % ANGLE_STEPS;
+        float range = nodes[i].distance_q2 ? nodes[i].distance_q2 / 1000.f : NAN;
+        xs[i] = range * cs[k] + m_x;
+        ys[i] = range * ss[k] + m_y;
+        intensities[i] = static_cast<float>(nodes[i].sync_quality);
+    }
+}
+
+size_t CartesianConverter::project(const LaserScan &scan, size_t first,
+                                   float *x, float *y, float *intensity) const {
+    const size_t count = scan.points.size();
+    size_t lanes = count - first < 4 ? count - first : 4;
+
+    //无效点的距离记为NaN，乘加后x、y也是NaN
+    float c[4];
+    float s[4];
+    float r[4];
+    for (size_t j = 0; j < lanes; j++) {
+        const LaserPoint &p = scan.points[first + j];
+        long k = tableIndex(p.angle);
+        if (k >= 0) {
+            c[j] = m_cos[k];
+            s[j] = m_sin[k];
+        } else {
+            double rad = math::from_degrees(static_cast<double>(p.angle) + m_yaw);
+            c[j] = static_cast<float>(cos(rad));
+            s[j] = static_cast<float>(sin(rad));
+        }
+        r[j] = p.range > 0 ? p.range : NAN;
+        intensity[j] = p.intensity;
+    }
+#ifdef CARTESIAN_SSE2
+    if (4 == lanes) {
+        //输出不要求对齐，CartesianScan内i是4的倍数时地址恰好对齐
+        __m128 range = _mm_loadu_ps(r);
+        _mm_storeu_ps(x, _mm_add_ps(_mm_mul_ps(range, _mm_loadu_ps(c)), _mm_set1_ps(m_x)));
+        _mm_storeu_ps(y, _mm_add_ps(_mm_mul_ps(range, _mm_loadu_ps(s)), _mm_set1_ps(m_y)));
+        return lanes;
+    }
+#endif
+    for (size_t j = 0; j < lanes; j++) {
+        x[j] = r[j] * c[j] + m_x;
+        y[j] = r[j] * s[j] + m_y;
+    }
+    return lanes;
+}
+
+}
+}
+}
@@ -0,0 +1,144 @@
+#pragma once
+#include <core/base/v8stdint.h>
+#include <vector>
+#include "ydlidar_datatype.h"
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+/**
+ * @brief Cartesian points of one scan, stored as separate x, y and
+ * intensity arrays aligned to ALIGNMENT bytes.
+ * Point i is the point i of the LaserScan it was converted from, invalid
+ * points (range 0) are NaN in x and y.
+ * Resizing to a size not larger than before does not allocate.
+ */
+class CartesianScan {
+public:
+    enum {
+        ALIGNMENT = 32, /**< bytes, every array starts on this boundary. */
+    };
+
+    CartesianScan();
+    CartesianScan(const CartesianScan &other);
+    CartesianScan &operator=(const CartesianScan &other);
+
+    /**
+     * @brief Set the number of points, the values are unspecified
+     */
+    void resize(size_t count);
+
+    size_t size() const {
+        return m_size;
+    }
+
+    /// x coordinates in meters
+    float *x() {
+        return base();
+    }
+    const float *x() const {
+        return base();
+    }
+
+    /// y coordinates in meters
+    float *y() {
+        return base() + m_stride;
+    }
+    const float *y() const {
+        return base() + m_stride;
+    }
+
+    /// intensities
+    float *intensity() {
+        return base() + 2 * m_stride;
+    }
+    const float *intensity() const {
+        return base() + 2 * m_stride;
+    }
+
+public:
+    uint64_t stamp; ///< System time when first range was measured in nanoseconds
+    uint64_t seq; ///< scan sequence number, starts from 1
+    uint64_t dropped; ///< total scans dropped before being consumed
+
+private:
+    //缓冲区内第一个对齐的位置
+    float *base() const;
+
+private:
+    std::vector<float> m_buffer; //三个数组依次存放，多分配ALIGNMENT字节用于对齐
+    size_t m_size;
+    size_t m_stride; //每个数组占用的float数，ALIGNMENT字节的整数倍
+};
+
+/**
+ * @brief Converts scan points to CartesianScan with an optional 2D
+ * sensor to body transform.
+ * The rotation is folded into a sin/cos table of every 0.01 degree, built
+ * when the transform changes. Decoded nodes index the table with their
+ * integer angle, and the scaling, multiply-add and stores run four points
+ * at a time with SSE2.
+ * LaserScan angles are floats that may have been remapped, those off the
+ * 0.01 degree grid are computed directly.
+ * Not thread safe, use one converter per thread.
+ */
+class CartesianConverter {
+public:
+    enum {
+        ANGLE_STEPS = 36000, /**< table entries, 0.01 degree each. */
+    };
+
+    CartesianConverter();
+
+    /**
+     * @brief Set the pose of the lidar in the output frame
+     * @param x          meters
+     * @param y          meters
+     * @param yaw        degrees, counterclockwise
+     */
+    void setTransform(float x, float y, float yaw);
+
+    /**
+     * @brief Convert a scan
+     * @param scan       angles in degrees, ranges in meters
+     * @param[out] out   resized to the scan size
+     */
+    void convert(const LaserScan &scan, CartesianScan &out) const;
+
+    /**
+     * @brief Convert decoded nodes, the same points as a LaserScan built
+     * from them without filters
+     * @param nodes      angles in 0.01 degree, distances in millimeters
+     * @param count      node count
+     * @param[out] out   resized to count, stamp of the first node
+     */
+    void convert(const node_info *nodes, size_t count, CartesianScan &out) const;
+
+    /**
+     * @brief Convert at most four points, the building block of ::convert
+     * for callers that filter the points as they go
+     * @param scan       angles in degrees, ranges in meters
+     * @param first      index of the first point
+     * @param[out] x     four entries, NaN for invalid points
+     * @param[out] y     four entries
+     * @param[out] intensity four entries
+     * @return points converted, min(4, scan size - first)
+     */
+    size_t project(const LaserScan &scan, size_t first, float *x, float *y, float *intensity) const;
+
+private:
+    //角度在0.01度网格上时返回表下标，否则返回-1
+    static long tableIndex(float angle);
+
+private:
+    std::vector<float> m_cos; //已加上yaw的cos，单位0.01度
+    std::vector<float> m_sin;
+    float m_x;
+    float m_y;
+    float m_yaw; //单位：度
+};
+
+}
+}
+}
@@ -0,0 +1,129 @@
+#include "CloudFusion.h"
+#include <math.h>
+#include <algorithm>
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+CloudFusion::CloudFusion()
+    : m_generation(0),
+      m_bearings(0),
+      m_rings(0),
+      m_bearingScale(0.f),
+      m_ringScale(0.f) {
+}
+
+bool CloudFusion::setExtrinsics(size_t source, float x, float y, float yaw) {
+    if (source >= MAX_SOURCES) {
+        return false;
+    }
+    if (source >= m_converters.size()) {
+        m_converters.resize(source + 1);
+    }
+    m_converters[source].setTransform(x, y, yaw);
+    return true;
+}
+
+bool CloudFusion::setDeduplication(float angleStep, float rangeStep, float maxRange) {
+    if (angleStep == 0.f) {
+        m_cells.clear();
+        m_bearings = 0;
+        m_rings = 0;
+        return true;
+    }
+    if (!(angleStep > 0.f) || !(rangeStep > 0.f) || !(maxRange > 0.f)) {
+        return false;
+    }
+    double bearings = ceil(360.0 / angleStep);
+    double rings = ceil(static_cast<double>(maxRange) / rangeStep);
+    if (bearings * rings > MAX_CELLS) {
+        return false;
+    }
+    m_bearings = static_cast<size_t>(bearings);
+    m_rings = static_cast<size_t>(rings);
+    m_bearingScale = static_cast<float>(m_bearings / (2 * M_PI));
+    m_ringScale = 1.f / rangeStep;
+    m_cells.assign(m_bearings * m_rings, 0);
+    m_generation = 0;
+    return true;
+}
+
+long CloudFusion::cellOf(float x, float y) const {
+    size_t ring = static_cast<size_t>(sqrtf(x * x + y * y) * m_ringScale);
+    if (ring >= m_rings) {
+        return -1;
+    }
+    //atan2f返回[-pi, pi]，pi处并入最后一格
+    size_t bearing = static_cast<size_t>((atan2f(y, x) + static_cast<float>(M_PI)) * m_bearingScale);
+    bearing = std::min(bearing, m_bearings - 1);
+    return static_cast<long>(ring * m_bearings + bearing);
+}
+
+void CloudFusion::fuse(const ScanSet &set, FusedCloud &out) {
+    const size_t sources = std::min(set.scans.size(), static_cast<size_t>(MAX_SOURCES));
+    if (m_converters.size() < sources) {
+        m_converters.resize(sources);
+    }
+    size_t total = 0;
+    for (size_t i = 0; i < sources; i++) {
+        total += set.scans[i].points.size();
+    }
+    //先按总点数分配，之后只写不再扩容
+    out.resize(total);
+    float *xs = out.x();
+    float *ys = out.y();
+    float *intensities = out.intensity();
+    uint8_t *ids = out.source();
+
+    const bool dedup = !m_cells.empty();
+    if (dedup && ++m_generation >= (1u << 24)) {
+        //代数只占24位，回绕时清空网格
+        std::fill(m_cells.begin(), m_cells.end(), 0);
+        m_generation = 1;
+    }
+
+    size_t n = 0;
+    for (size_t i = 0; i < sources; i++) {
+        const LaserScan &scan = set.scans[i];
+        const CartesianConverter &converter = m_converters[i];
+        const uint32_t claim = (m_generation << 8) | static_cast<uint32_t>(i);
+        const size_t count = scan.points.size();
+        float x[4];
+        float y[4];
+        float intensity[4];
+        size_t first = 0;
+        while (first < count) {
+            size_t lanes = converter.project(scan, first, x, y, intensity);
+            first += lanes;
+            for (size_t j = 0; j < lanes; j++) {
+                if (x[j] != x[j]) {
+                    continue;//无效点
+                }
+                if (dedup) {
+                    long cell = cellOf(x[j], y[j]);
+                    if (cell >= 0) {
+                        uint32_t &owner = m_cells[cell];
+                        if ((owner >> 8) == m_generation && owner != claim) {
+                            continue;//已被其他雷达占用
+                        }
+                        owner = claim;
+                    }
+                }
+                xs[n] = x[j];
+                ys[n] = y[j];
+                intensities[n] = intensity[j];
+                ids[n] = static_cast<uint8_t>(i);
+                n++;
+            }
+        }
+    }
+    out.resize(n);
+    out.stamp = set.stamp;
+    out.seq = set.seq;
+    out.dropped = set.dropped;
+}
+
+}
+}
+}
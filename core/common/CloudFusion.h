@@ -0,0 +1,106 @@
+#pragma once
+#include <core/base/v8stdint.h>
+#include <vector>
+#include "ydlidar_datatype.h"
+#include "CartesianScan.h"
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+/**
+ * @brief Cartesian points of several lidars in one frame, with the index
+ * of the lidar every point comes from.
+ * Unlike a single CartesianScan, invalid and deduplicated points are left
+ * out, so the points of a lidar are contiguous and in scan order but no
+ * longer line up with its LaserScan.
+ */
+class FusedCloud : public CartesianScan {
+public:
+    /**
+     * @brief Set the number of points, the values are unspecified
+     */
+    void resize(size_t count) {
+        CartesianScan::resize(count);
+        m_source.resize(count);
+    }
+
+    /// lidar index of every point
+    uint8_t *source() {
+        return m_source.empty() ? NULL : &m_source[0];
+    }
+    const uint8_t *source() const {
+        return m_source.empty() ? NULL : &m_source[0];
+    }
+
+private:
+    std::vector<uint8_t> m_source;
+};
+
+/**
+ * @brief Merges the scans of several lidars into one FusedCloud.
+ * Every lidar has its own CartesianConverter holding its 2D extrinsics, so
+ * the scans are transformed straight into the output frame and each point
+ * is written once, already compacted.
+ * The optional deduplication splits the output frame into a coarse polar
+ * grid around its origin; the first lidar to put a point in a cell owns it
+ * for the cloud and the points of the other lidars falling in that cell
+ * are dropped, so overlapping fields of view do not double the density.
+ * Lidars are taken in order, a lower index wins.
+ * Not thread safe, use one fusion per thread.
+ */
+class CloudFusion {
+public:
+    enum {
+        MAX_SOURCES = 255, /**< lidars, a source index is one byte. */
+        MAX_CELLS = 1 << 22, /**< deduplication grid cells. */
+    };
+
+    CloudFusion();
+
+    /**
+     * @brief Set the pose of one lidar in the output frame
+     * @param source     lidar index, below MAX_SOURCES
+     * @param x          meters
+     * @param y          meters
+     * @param yaw        degrees, counterclockwise
+     * @return false if the index is out of range.
+     * @note Lidars without pose are at the origin.
+     */
+    bool setExtrinsics(size_t source, float x, float y, float yaw);
+
+    /**
+     * @brief Drop the points of a lidar that land in a grid cell already
+     * holding points of another lidar
+     * @param angleStep  cell width in degrees around the output origin, 0 disables
+     * @param rangeStep  cell depth in meters
+     * @param maxRange   meters, farther points are always kept
+     * @return false if the grid would exceed MAX_CELLS or a step is negative,
+     * the deduplication is unchanged.
+     */
+    bool setDeduplication(float angleStep, float rangeStep, float maxRange);
+
+    /**
+     * @brief Merge the scans of a set in one pass
+     * @param set        scan i comes from lidar i, at most MAX_SOURCES are used
+     * @param[out] out   sized to the points kept, stamp, seq and dropped of the set
+     */
+    void fuse(const ScanSet &set, FusedCloud &out);
+
+private:
+    //点所在的网格单元，不在网格内时返回-1
+    long cellOf(float x, float y) const;
+
+private:
+    std::vector<CartesianConverter> m_converters;
+    std::vector<uint32_t> m_cells; //generation << 8 | source，generation不等于当前值时为空
+    uint32_t m_generation;
+    size_t m_bearings; //方位划分数
+    size_t m_rings; //距离划分数
+    float m_bearingScale; //每弧度的方位格数
+    float m_ringScale; //每米的距离格数
+};
+
+}
+}
+}
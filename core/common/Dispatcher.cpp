@@ -0,0 +1,141 @@
+#include "Dispatcher.h"
+#include <core/base/timer.h>
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+Dispatcher::Dispatcher()
+    : m_running(false),
+      m_dropped(0) {
+}
+
+Dispatcher::~Dispatcher() {
+    stop();
+}
+
+bool Dispatcher::start(size_t threads) {
+    stop();
+    if (threads < 1) {
+        threads = 1;
+    } else if (threads > MAX_THREADS) {
+        threads = MAX_THREADS;
+    }
+
+    bool ok = true;
+    {
+        ScopedLocker l(m_lock);
+        m_running = true;
+        for (size_t i = 0; i < threads; i++) {
+            Worker *worker = new Worker();
+            worker->owner = this;
+            worker->active = true;
+            worker->thread = Thread::createThread(workerProc, worker);
+            if (worker->thread.getHandle() == 0) {
+                delete worker;
+                ok = false;
+                break;
+            }
+            m_workers.push_back(worker);
+        }
+    }
+    if (!ok) {
+        stop();
+    }
+    return ok;
+}
+
+void Dispatcher::stop() {
+    {
+        ScopedLocker l(m_lock);
+        m_running = false;
+        if (m_workers.empty()) {
+            return;
+        }
+    }
+
+    //let the workers leave on their own, Thread::join cancels the thread
+    for (size_t i = 0; i < m_workers.size(); i++) {
+        Worker *worker = m_workers[i];
+        while (true) {
+            {
+                ScopedLocker l(m_lock);
+                if (!worker->active) {
+                    break;
+                }
+            }
+            worker->event.set();
+            delay(1);
+        }
+        worker->thread.join();
+    }
+
+    ScopedLocker l(m_lock);
+    for (size_t i = 0; i < m_workers.size(); i++) {
+        delete m_workers[i];
+    }
+    m_workers.clear();
+}
+
+bool Dispatcher::isRunning() {
+    ScopedLocker l(m_lock);
+    return m_running;
+}
+
+bool Dispatcher::post(const Task &task) {
+    ScopedLocker l(m_lock);
+    Worker *target = NULL;
+    if (m_running) {
+        for (size_t i = 0; i < m_workers.size(); i++) {
+            if (!target || m_workers[i]->tasks.size() < target->tasks.size()) {
+                target = m_workers[i];
+            }
+        }
+    }
+    if (!target || target->tasks.size() >= MAX_PENDING) {
+        m_dropped++;
+        return false;
+    }
+    target->tasks.push_back(task);
+    target->event.set();
+    return true;
+}
+
+uint64_t Dispatcher::dropped() {
+    ScopedLocker l(m_lock);
+    return m_dropped;
+}
+
+_size_t THREAD_PROC Dispatcher::workerProc(void *param) {
+    Worker *worker = static_cast<Worker *>(param);
+    worker->owner->run(worker);
+    return 0;
+}
+
+void Dispatcher::run(Worker *worker) {
+    while (true) {
+        Task task;
+        {
+            ScopedLocker l(m_lock);
+            if (!m_running) {
+                worker->tasks.clear();
+                worker->active = false;
+                break;
+            }
+            if (!worker->tasks.empty()) {
+                task = worker->tasks.front();
+                worker->tasks.pop_front();
+            }
+        }
+
+        if (task) {
+            task();
+        } else {
+            worker->event.wait();
+        }
+    }
+}
+
+}//common
+}//core
+}//ydlidar
@@ -0,0 +1,81 @@
+#pragma once
+#include <core/base/v8stdint.h>
+#include <core/base/thread.h>
+#include <core/base/locker.h>
+#include <deque>
+#include <vector>
+#include <functional>
+
+namespace ydlidar {
+namespace core {
+using namespace base;
+namespace common {
+
+/**
+ * @brief Small worker pool running posted tasks.
+ * Every worker has its own queue, a task goes to the least loaded worker,
+ * so with more than one worker tasks may complete out of order.
+ */
+class Dispatcher {
+public:
+    typedef std::function<void()> Task;
+
+    enum {
+        MAX_THREADS = 8,   /**< Maximum number of workers. */
+        MAX_PENDING = 64,  /**< Maximum queued tasks per worker, newer tasks are dropped. */
+    };
+
+    Dispatcher();
+    ~Dispatcher();
+
+    /**
+     * @brief Start the workers, running workers are stopped first.
+     * @param threads  number of workers, clamped to [1, MAX_THREADS]
+     * @return true if all workers are started, otherwise false.
+     */
+    bool start(size_t threads);
+
+    /**
+     * @brief Stop the workers, pending tasks are discarded.
+     * @note Must not be called from a task.
+     */
+    void stop();
+
+    /**
+     * @brief Whether the workers are running.
+     */
+    bool isRunning();
+
+    /**
+     * @brief Queue a task.
+     * @return false if the pool is stopped or full and the task is dropped.
+     */
+    bool post(const Task &task);
+
+    /**
+     * @brief Total number of dropped tasks.
+     */
+    uint64_t dropped();
+
+private:
+    struct Worker {
+        Dispatcher *owner;
+        Thread thread;
+        std::deque<Task> tasks;
+        Event event;        ///< one waiter per event
+        bool active;        ///< false once the thread has left
+    };
+
+    static _size_t THREAD_PROC workerProc(void *param);
+    void run(Worker *worker);
+
+private:
+    std::vector<Worker *> m_workers;
+    bool m_running;
+    uint64_t m_dropped;
+    Locker m_lock;
+};
+
+}//common
+}//core
+}//ydlidar
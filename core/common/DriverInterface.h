@@ -5,6 +5,14 @@
 #include <map>
 #include "ydlidar_def.h"
 #include "ydlidar_datatype.h"
+#include "ShmScanRing.h"
+#include "ScanQueue.h"
+#include "ScanGate.h"
+#include "SectorIndex.h"
+#include "ZoneEvaluator.h"
+#include "DriverMetrics.h"
+#include "LatencyHistogram.h"
+#include "PcapFile.h"
 #include <ydlidar_config.h>
 
 namespace ydlidar {
@@ -12,6 +20,45 @@ namespace core {
 using namespace base;
 namespace common {
 
+/**
+ * @brief Driver notifications.
+ * All methods are called on the driver threads and must return quickly.
+ */
+class DriverListener {
+public:
+    virtual ~DriverListener() {}
+
+    /**
+     * @brief A complete scan has been assembled
+     * @param nodes     scan nodes, valid during the call only
+     * @param count     node count
+     * @param sequence  scan sequence and drop count
+     */
+    virtual void onScan(const node_info *nodes, size_t count, const scan_sequence &sequence) {}
+
+    /**
+     * @brief One data frame has been decoded
+     * @param nodes     frame nodes, valid during the call only
+     * @param count     node count
+     */
+    virtual void onSector(const node_info *nodes, size_t count) {}
+
+    /**
+     * @brief The driver reported an error
+     */
+    virtual void onError(DriverError error) {}
+
+    /**
+     * @brief The driver state changed
+     */
+    virtual void onStateChanged(LidarState state) {}
+
+    /**
+     * @brief Points of the last decoded data frame fell inside a zone
+     */
+    virtual void onZoneViolation(const ZoneEvent &event) {}
+};
+
 class DriverInterface {
 public:
     enum YDLIDAR_MODLES {
@@ -35,15 +82,23 @@ public:
     };
 
 protected:
-    node_info *m_ScanNodeBuf;
-    size_t m_ScanNodeCount;
+    ScanQueue m_ScanQueue;
+    ScanGate m_ScanGate;
+    SectorIndex m_SectorIndex;      ///< built by the decode thread
+    SectorIndex m_LastSectorIndex;  ///< index of the last published scan
+    Locker m_SectorLock;            ///< guards m_LastSectorIndex
+    ZoneEvaluator m_ZoneEvaluator;
+    DriverMetrics m_Metrics;
+    DriverLatency m_Latency;
     DriverError m_DriverErrno;
     Thread m_Thread;
-    Event m_DataEvent;
     Locker m_Lock;
     Locker m_CmdLock;
     Locker m_DataLock;
     Locker m_ErrorLock;
+    ShmScanPublisher *m_ShmPublisher;
+    PcapWriter *m_Recorder;
+    DriverListener *m_Listener;
     PropertyBuilderByName(bool, IsScanning, protected);
     PropertyBuilderByName(bool, IsConnected, protected);
     PropertyBuilderByName(bool, IsAutoReconnect, protected);
@@ -55,9 +110,10 @@ public:
      *
      */
     DriverInterface(){
-        node_info *m_ScanNodeBuf = NULL; 
-        size_t m_ScanNodeCount = 0;
-        DriverError m_DriverErrno = NoError;
+        m_DriverErrno = NoError;
+        m_ShmPublisher = NULL;
+        m_Recorder = NULL;
+        m_Listener = NULL;
         setIsScanning(false);
         setIsConnected(false);
         setIsAutoReconnect(true);
@@ -93,12 +149,14 @@ public:
      * @param[in] nodebuffer Laser data
      * @param[in] count      one circle of laser points
      * @param[in] timeout    timeout
+     * @param[out] sequence  scan sequence and drop count, may be NULL
      * @return return status
      * @retval RESULT_OK       success
      * @retval RESULT_FAILE    failed
      * @note Before starting, you must start the start the scan successfully with the ::startScan function
      */
-    virtual result_t grabScanData(node_info *nodebuffer, size_t &count, uint32_t timeout = DEFAULT_TIMEOUT) = 0 ;
+    virtual result_t grabScanData(node_info *nodebuffer, size_t &count, uint32_t timeout = DEFAULT_TIMEOUT,
+                                  scan_sequence *sequence = NULL) = 0 ;
 
     /**
      * @brief Turn on scanning \n
@@ -221,14 +279,196 @@ public:
         return YDLIDAR_SDK_VERSION_STR;
     }
 
+    /**
+     * @brief Set the depth and policy of the scan queue
+     * @param depth   number of scans kept for the consumer
+     * @param policy  ::ScanQueuePolicy
+     * @note Queued scans are discarded, set it before ::startScan
+     */
+    virtual void setScanQueue(size_t depth, int policy) {
+        m_ScanQueue.setup(depth, policy, MAX_SCAN_NODES);
+    }
+
+    /**
+     * @brief Drop the points outside an angle window or range limits while
+     * decoding, before they are copied into a sector or a scan
+     * @param minAngle  minimum angle in degrees
+     * @param maxAngle  maximum angle in degrees, 360 degrees or more keeps every angle
+     * @param minRange  minimum range in meters
+     * @param maxRange  maximum range in meters, 0 or less for no limit
+     * @note Set it before ::startScan
+     */
+    virtual void setScanWindow(float minAngle, float maxAngle, float minRange, float maxRange) {
+        m_ScanGate.setWindow(minAngle, maxAngle, minRange, maxRange);
+    }
+
+    /**
+     * @brief Drop the points of some sectors while decoding, e.g. behind
+     * the pillars of the chassis
+     * @param angles    start and end angle pairs in degrees, empty for none
+     * @return false if angles holds an odd count.
+     * @note Set it before ::startScan
+     */
+    virtual bool setIgnoreArray(const std::vector<float> &angles) {
+        return m_ScanGate.setIgnore(angles);
+    }
+
+    /**
+     * @brief Map the decoded angles to the mounting orientation
+     * @param reversion  mounted facing backwards
+     * @param inverted   mounted upside down
+     * @param offset     zero angle offset in degrees
+     * @note Set it before ::startScan
+     */
+    virtual void setOrientation(bool reversion, bool inverted, float offset) {
+        m_ScanGate.setOrientation(reversion, inverted, offset);
+    }
+
+    /**
+     * @brief Set the protective zones the decoded points are tested against,
+     * violations are reported per data frame with DriverListener::onZoneViolation
+     * @param polygons  x, y vertex pairs in meters, in the mounted frame
+     * @return false if a polygon is invalid or there are more than
+     * ZoneEvaluator::MAX_ZONES, no zone is set then.
+     * @note Set it before ::startScan
+     */
+    virtual bool setZones(const std::vector<std::vector<float> > &polygons) {
+        m_ZoneEvaluator.clear();
+        for (size_t i = 0; i < polygons.size(); i++) {
+            if (m_ZoneEvaluator.addZone(polygons[i]) < 0) {
+                m_ZoneEvaluator.clear();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Keep the nearest return of every sector of each complete scan
+     * @param sectors   sectors per revolution, 0 disables the index
+     * @return false if more than SectorIndex::MAX_SECTORS.
+     * @note Set it before ::startScan
+     */
+    virtual bool setSectorIndex(size_t sectors) {
+        ScopedLocker l(m_SectorLock);
+        return m_SectorIndex.setSectors(sectors) && m_LastSectorIndex.setSectors(sectors);
+    }
+
+    /**
+     * @brief Copy the sector index of the last published scan
+     * @param[out] index  sector index
+     * @return false if the index is disabled or no scan was published yet.
+     */
+    virtual bool getSectorIndex(SectorIndex &index) {
+        ScopedLocker l(m_SectorLock);
+        if (!m_LastSectorIndex.sectors() || !m_LastSectorIndex.seq) {
+            return false;
+        }
+        index = m_LastSectorIndex;
+        return true;
+    }
+
+    /**
+     * @brief Set the shared memory ring fed with every complete scan
+     * @param publisher  ring publisher, NULL to disable
+     * @note The caller keeps the ownership, set it before ::startScan
+     */
+    virtual void setShmPublisher(ShmScanPublisher *publisher) {
+        m_ShmPublisher = publisher;
+    }
+
+    /**
+     * @brief Set the capture file fed with the raw data and command traffic
+     * @param recorder  pcap writer, NULL to disable
+     * @note The caller keeps the ownership, set it before ::startScan
+     */
+    virtual void setRecorder(PcapWriter *recorder) {
+        m_Recorder = recorder;
+    }
+
+    /**
+     * @brief Set the listener notified of scans, sectors, errors and state changes
+     * @param listener  listener, NULL to disable
+     * @note The caller keeps the ownership, set it before ::connect
+     */
+    virtual void setListener(DriverListener *listener) {
+        m_Listener = listener;
+    }
+
+    /**
+     * @brief Let a shared reactor own the data socket
+     * @param shared  true to skip opening the data port and starting the decode thread
+     * @return false if the driver has no datagram path
+     * @note Set it before ::connect, then hand every datagram to ::feedDatagram
+     */
+    virtual bool setSharedData(bool shared) {
+        return !shared;
+    }
+
+    /**
+     * @brief Decode one datagram received by a shared reactor
+     * @param data   payload
+     * @param len    payload size
+     * @param addr   sender address, network byte order
+     * @param port   sender port
+     * @param stamp  kernel receive time in microseconds since the epoch, 0 if unknown
+     */
+    virtual void feedDatagram(const uint8_t *data, size_t len, uint32_t addr, uint16_t port,
+                              uint64_t stamp) {}
+
+    /**
+     * @brief The shared reactor received nothing for ::DEFAULT_TIMEOUT
+     */
+    virtual void feedTimeout() {}
+
+    /**
+     * @brief Get a snapshot of the data path metrics
+     * @param[out] metrics  counters and gauges
+     * @note Lock-free, cheap enough to poll at a high rate
+     */
+    virtual void getMetrics(LidarMetrics &metrics) const {
+        m_Metrics.snapshot(metrics);
+    }
+
+    /**
+     * @brief Add a latency sample
+     * @param stage  ::LatencyStage
+     * @param us     latency in microseconds
+     */
+    virtual void recordLatency(int stage, uint64_t us) {
+        m_Latency.record(stage, us);
+    }
+
+    /**
+     * @brief Get the latency percentiles of one stage
+     * @param stage       ::LatencyStage
+     * @param[out] stats  percentiles in microseconds
+     * @return false if the stage is invalid
+     */
+    virtual bool getLatency(int stage, LidarLatency &stats) const {
+        return m_Latency.snapshot(stage, stats);
+    }
+
+    /**
+     * @brief Clear the latency histograms
+     */
+    virtual void resetLatency() {
+        m_Latency.reset();
+    }
+
     /**
      * @brief Set driver error code
      * @param er
      */
     virtual void setDriverError(const DriverError &er) {
-        ScopedLocker l(m_ErrorLock);
-        if(m_DriverErrno == NoError){
-            m_DriverErrno = er;
+        {
+            ScopedLocker l(m_ErrorLock);
+            if(m_DriverErrno == NoError){
+                m_DriverErrno = er;
+            }
+        }
+        if (er != NoError && m_Listener) {
+            m_Listener->onError(er);
         }
     }
 
@@ -241,6 +481,18 @@ public:
         return m_DriverErrno;
     }
 
+protected:
+    /**
+     * @brief Notify the listener of a state change
+     * @param state  new state
+     */
+    void notifyStateChanged(LidarState state) {
+        if (m_Listener) {
+            m_Listener->onStateChanged(state);
+        }
+    }
+
+public:
     /**
      * @brief Returns a human-readable description of the given error code
      *  or the last error code of lidar driver.
@@ -0,0 +1,73 @@
+#pragma once
+#include <core/base/v8stdint.h>
+#include <atomic>
+#include "ydlidar_def.h"
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+/**
+ * @brief Lock-free counter or gauge.
+ * Relaxed ordering, values are independent of each other.
+ */
+class Metric {
+public:
+    Metric() : m_value(0) {}
+
+    void add(uint64_t n = 1) {
+        m_value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void set(uint64_t value) {
+        m_value.store(value, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const {
+        return m_value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> m_value;
+};
+
+/**
+ * @brief Data path metrics of one driver.
+ * Written by the driver threads, read at any time with ::snapshot.
+ */
+struct DriverMetrics {
+    Metric datagrams;       ///< UDP datagrams received
+    Metric bytes;           ///< bytes received
+    Metric frames;          ///< data frames reassembled
+    Metric resyncs;         ///< tail marker found after skipping bytes
+    Metric frameDrops;      ///< frames lost in sequence
+    Metric timeouts;        ///< receive timeouts
+    Metric reconnects;      ///< reconnection attempts
+    Metric scansPublished;  ///< complete scans
+    Metric scansConsumed;   ///< scans taken by the consumer
+    Metric scansDropped;    ///< scans overwritten before being consumed
+    Metric queuedScans;     ///< gauge, scans in the queue
+    Metric scanPoints;      ///< gauge, points of the last scan
+
+    /**
+     * @brief Copy all values, no locking.
+     */
+    void snapshot(LidarMetrics &out) const {
+        out.datagrams = datagrams.value();
+        out.bytes = bytes.value();
+        out.frames = frames.value();
+        out.resyncs = resyncs.value();
+        out.frameDrops = frameDrops.value();
+        out.timeouts = timeouts.value();
+        out.reconnects = reconnects.value();
+        out.scansPublished = scansPublished.value();
+        out.scansConsumed = scansConsumed.value();
+        out.scansDropped = scansDropped.value();
+        out.queuedScans = static_cast<uint32_t>(queuedScans.value());
+        out.scanPoints = static_cast<uint32_t>(scanPoints.value());
+    }
+};
+
+}//common
+}//core
+}//ydlidar
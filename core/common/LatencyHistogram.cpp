@@ -0,0 +1,85 @@
+#include "LatencyHistogram.h"
+#include <string.h>
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+uint32_t LatencyHistogram::bucketIndex(uint32_t value) {
+    if (value < 2 * SUB_COUNT) {
+        return value;
+    }
+    uint32_t msb = 31;
+    while (!(value & (1u << msb))) {
+        msb--;
+    }
+    uint32_t shift = msb - SUB_BITS;
+    return (shift + 1) * SUB_COUNT + ((value >> shift) - SUB_COUNT);
+}
+
+uint32_t LatencyHistogram::bucketUpper(uint32_t index) {
+    if (index < 2 * SUB_COUNT) {
+        return index;
+    }
+    uint32_t shift = index / SUB_COUNT - 1;
+    uint64_t sub = index % SUB_COUNT + SUB_COUNT;
+    uint64_t upper = ((sub + 1) << shift) - 1;
+    return upper > 0xffffffffu ? 0xffffffffu : static_cast<uint32_t>(upper);
+}
+
+void LatencyHistogram::record(uint64_t us) {
+    uint32_t value = us > 0xffffffffu ? 0xffffffffu : static_cast<uint32_t>(us);
+    m_buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    uint32_t max = m_max.load(std::memory_order_relaxed);
+    while (value > max &&
+           !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::snapshot(LidarLatency &stats) const {
+    uint64_t counts[BUCKET_COUNT];
+    uint64_t total = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    memset(&stats, 0, sizeof(LidarLatency));
+    stats.count = total;
+    stats.max = m_max.load(std::memory_order_relaxed);
+    if (!total) {
+        return;
+    }
+
+    //rank of each percentile, rounded up so that p999 of few samples is the max
+    const uint64_t ranks[3] = {
+        (total * 500 + 999) / 1000,
+        (total * 990 + 999) / 1000,
+        (total * 999 + 999) / 1000,
+    };
+    uint32_t *values[3] = {&stats.p50, &stats.p99, &stats.p999};
+    uint64_t seen = 0;
+    int next = 0;
+    for (int i = 0; i < BUCKET_COUNT && next < 3; i++) {
+        seen += counts[i];
+        while (next < 3 && seen >= ranks[next]) {
+            uint32_t upper = bucketUpper(i);
+            *values[next] = upper < stats.max ? upper : stats.max;
+            next++;
+        }
+    }
+}
+
+}//common
+}//core
+}//ydlidar
@@ -0,0 +1,82 @@
+#pragma once
+#include <core/base/v8stdint.h>
+#include <atomic>
+#include "ydlidar_def.h"
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+/**
+ * @brief Fixed-bucket log-linear histogram of microsecond samples.
+ * Values below 32 us get one bucket each, above that every power of two
+ * is split into 16 buckets. Recording is lock-free and never allocates.
+ */
+class LatencyHistogram {
+public:
+    enum {
+        SUB_BITS = 4,                                     /**< log2 of buckets per power of two. */
+        SUB_COUNT = 1 << SUB_BITS,
+        BUCKET_COUNT = (32 - SUB_BITS + 1) * SUB_COUNT,   /**< covers the whole uint32_t range. */
+    };
+
+    LatencyHistogram();
+
+    /**
+     * @brief Add one sample
+     * @param us  latency in microseconds, clamped to uint32_t
+     */
+    void record(uint64_t us);
+
+    /**
+     * @brief Clear all samples
+     */
+    void reset();
+
+    /**
+     * @brief Compute the percentiles of the recorded samples
+     * @param[out] stats  count, percentiles and maximum
+     */
+    void snapshot(LidarLatency &stats) const;
+
+private:
+    static uint32_t bucketIndex(uint32_t value);
+    static uint32_t bucketUpper(uint32_t index);
+
+private:
+    std::atomic<uint64_t> m_buckets[BUCKET_COUNT];
+    std::atomic<uint32_t> m_max;
+};
+
+/**
+ * @brief Histograms of all ::LatencyStage of one driver.
+ */
+class DriverLatency {
+public:
+    void record(int stage, uint64_t us) {
+        if (stage >= 0 && stage < LatencyStageCount) {
+            m_stages[stage].record(us);
+        }
+    }
+
+    bool snapshot(int stage, LidarLatency &stats) const {
+        if (stage < 0 || stage >= LatencyStageCount) {
+            return false;
+        }
+        m_stages[stage].snapshot(stats);
+        return true;
+    }
+
+    void reset() {
+        for (int i = 0; i < LatencyStageCount; i++) {
+            m_stages[i].reset();
+        }
+    }
+
+private:
+    LatencyHistogram m_stages[LatencyStageCount];
+};
+
+}//common
+}//core
+}//ydlidar
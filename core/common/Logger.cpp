@@ -0,0 +1,252 @@
+#include "Logger.h"
+#include <core/base/timer.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+/// one formatted message
+struct LogRecord {
+    uint64_t stamp;     ///< getus() when the message was written
+    uint32_t length;
+    int32_t level;
+    char text[Logger::RECORD_SIZE - 16];
+};
+
+/// single producer single consumer ring of one thread
+struct LogRing {
+    LogRecord records[Logger::RING_RECORDS];
+    std::atomic<uint32_t> head;   ///< next record to read, written by the consumer
+    std::atomic<uint32_t> tail;   ///< next record to write, written by the producer
+    std::atomic<bool> closed;     ///< the producer thread has exited
+};
+
+/// closes the ring of a thread when the thread exits
+struct LogRingHolder {
+    LogRing *ring;
+
+    LogRingHolder() : ring(NULL) {}
+    ~LogRingHolder() {
+        if (ring) {
+            ring->closed.store(true, std::memory_order_release);
+            ring = NULL;
+        }
+    }
+};
+
+static thread_local LogRingHolder t_holder;
+
+std::atomic<int> Logger::s_level(LogLevelDebug);
+
+Logger::Logger()
+    : m_dropped(0),
+      m_reported(0),
+      m_running(true),
+      m_active(true) {
+    atexit(shutdown);
+    m_thread = CLASS_THREAD(Logger, drainThread);
+    if (m_thread.getHandle() == 0) {
+        m_running = false;
+        m_active = false;
+    }
+}
+
+Logger *Logger::instance() {
+    //never deleted, messages may be written from static destructors
+    static Logger *logger = new Logger();
+    return logger;
+}
+
+LogRing *Logger::localRing() {
+    if (!t_holder.ring) {
+        LogRing *ring = new LogRing();
+        ring->head.store(0, std::memory_order_relaxed);
+        ring->tail.store(0, std::memory_order_relaxed);
+        ring->closed.store(false, std::memory_order_relaxed);
+        Logger *logger = instance();
+        ScopedLocker l(logger->m_ringLock);
+        logger->m_rings.push_back(ring);
+        t_holder.ring = ring;
+    }
+    return t_holder.ring;
+}
+
+void Logger::setLevel(int level) {
+    s_level.store(level, std::memory_order_relaxed);
+}
+
+int Logger::level() {
+    return s_level.load(std::memory_order_relaxed);
+}
+
+bool Logger::allow(LogSite &site, uint32_t &suppressed) {
+    uint32_t now = getms();
+    uint64_t state = site.state.load(std::memory_order_relaxed);
+    while (true) {
+        uint32_t start = static_cast<uint32_t>(state >> 32);
+        uint32_t count = static_cast<uint32_t>(state);
+        if (now - start >= RATE_WINDOW) {
+            //窗口起点和计数一起替换，只有一个线程能开始新窗口并上报被抑制的条数
+            uint64_t next = (static_cast<uint64_t>(now) << 32) | 1;
+            if (site.state.compare_exchange_weak(state, next, std::memory_order_relaxed)) {
+                suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+                return true;
+            }
+        } else if (count >= RATE_LIMIT) {
+            site.suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else if (site.state.compare_exchange_weak(state, state + 1, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
+void Logger::write(LogSite &site, int level, const char *format, ...) {
+    uint32_t suppressed = 0;
+    if (!allow(site, suppressed)) {
+        return;
+    }
+
+    LogRing *ring = localRing();
+    uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+    if (tail - ring->head.load(std::memory_order_acquire) >= RING_RECORDS) {
+        instance()->m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    LogRecord &record = ring->records[tail % RING_RECORDS];
+    const int size = sizeof(record.text);
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(record.text, size, format, args);
+    va_end(args);
+    if (length < 0) {
+        length = 0;
+    } else if (length >= size) {
+        length = size - 1;
+    }
+    if (suppressed) {
+        int n = snprintf(record.text + length, size - length,
+                         " (%u similar messages suppressed)", suppressed);
+        if (n > 0) {
+            length = length + n < size ? length + n : size - 1;
+        }
+    }
+    record.length = length;
+    record.level = level;
+    record.stamp = getus();
+    ring->tail.store(tail + 1, std::memory_order_release);
+
+    //后台线程停止后由写入方自己输出
+    if (level >= LogLevelFatal || !instance()->m_running.load(std::memory_order_relaxed)) {
+        flush();
+    }
+}
+
+void Logger::flush() {
+    instance()->drain();
+}
+
+void Logger::shutdown() {
+    Logger *logger = instance();
+    if (!logger->m_running.exchange(false)) {
+        logger->drain();
+        return;
+    }
+    //Thread::join会取消线程，先等它写完自行退出
+    while (logger->m_active) {
+        delay(1);
+    }
+    logger->m_thread.join();
+    logger->drain();
+}
+
+uint64_t Logger::dropped() {
+    return instance()->m_dropped.load(std::memory_order_relaxed);
+}
+
+void Logger::drain() {
+    ScopedLocker drain_lock(m_drainLock);
+    std::vector<LogRing *> rings;
+    {
+        ScopedLocker l(m_ringLock);
+        rings = m_rings;
+    }
+
+    size_t count = rings.size();
+    std::vector<uint32_t> heads(count), tails(count);
+    std::vector<bool> closed(count);
+    for (size_t i = 0; i < count; i++) {
+        //a closed ring gets no more records after this load
+        closed[i] = rings[i]->closed.load(std::memory_order_acquire);
+        heads[i] = rings[i]->head.load(std::memory_order_relaxed);
+        tails[i] = rings[i]->tail.load(std::memory_order_acquire);
+    }
+
+    //merge the rings in time order
+    bool written = false;
+    while (true) {
+        int next = -1;
+        for (size_t i = 0; i < count; i++) {
+            if (heads[i] == tails[i]) {
+                continue;
+            }
+            if (next < 0 ||
+                rings[i]->records[heads[i] % RING_RECORDS].stamp <
+                rings[next]->records[heads[next] % RING_RECORDS].stamp) {
+                next = i;
+            }
+        }
+        if (next < 0) {
+            break;
+        }
+        const LogRecord &record = rings[next]->records[heads[next] % RING_RECORDS];
+        fwrite(record.text, 1, record.length, stdout);
+        fputc('\n', stdout);
+        written = true;
+        heads[next]++;
+        rings[next]->head.store(heads[next], std::memory_order_release);
+    }
+
+    uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != m_reported) {
+        fprintf(stdout, "[LIDAR SDK] [WARRING]> %llu log messages dropped\n",
+                (unsigned long long)(dropped - m_reported));
+        m_reported = dropped;
+        written = true;
+    }
+    if (written) {
+        fflush(stdout);
+    }
+
+    ScopedLocker l(m_ringLock);
+    for (size_t i = 0; i < count; i++) {
+        if (!closed[i]) {
+            continue;
+        }
+        for (size_t j = 0; j < m_rings.size(); j++) {
+            if (m_rings[j] == rings[i]) {
+                m_rings.erase(m_rings.begin() + j);
+                break;
+            }
+        }
+        delete rings[i];
+    }
+}
+
+int Logger::drainThread() {
+    while (m_running) {
+        drain();
+        delay(DRAIN_INTERVAL);
+    }
+    drain();
+    m_active = false;
+    return 0;
+}
+
+}//common
+}//core
+}//ydlidar
@@ -0,0 +1,116 @@
+#pragma once
+#include <core/base/v8stdint.h>
+#include <core/base/thread.h>
+#include <core/base/locker.h>
+#include <atomic>
+#include <vector>
+#include "ydlidar_def.h"
+
+namespace ydlidar {
+namespace core {
+using namespace base;
+namespace common {
+
+/**
+ * @brief Rate limit state of one log call site.
+ * Declared static by the LOG macros, zero initialized.
+ */
+struct LogSite {
+    std::atomic<uint64_t> state;      ///< start of the current window in ms << 32 | messages in it
+    std::atomic<uint32_t> suppressed; ///< messages dropped in the current window
+};
+
+struct LogRing;
+
+/**
+ * @brief Asynchronous logger behind the LOG macros.
+ * Every thread formats its messages into a fixed size record of its own
+ * lock-free ring, a background thread writes the records to stdout.
+ * A full ring drops the message instead of blocking the caller.
+ * Formatting stays on the calling thread, the arguments (%s strings in
+ * particular) only live until write() returns.
+ */
+class Logger {
+public:
+    enum {
+        RECORD_SIZE = 512,      /**< Size of one record, longer messages are truncated. */
+        RING_RECORDS = 128,     /**< Records per thread. */
+        RATE_LIMIT = 10,        /**< Messages per call site and window. */
+        RATE_WINDOW = 1000,     /**< Rate limit window in ms. */
+        DRAIN_INTERVAL = 5,     /**< Background thread period in ms. */
+    };
+
+    /**
+     * @brief Set the runtime level
+     * @param level  ::LogLevel, messages below it are discarded
+     */
+    static void setLevel(int level);
+
+    /**
+     * @brief Get the runtime level
+     */
+    static int level();
+
+    /**
+     * @brief Whether messages of this level are written
+     */
+    static bool isEnabled(int level) {
+        return level >= s_level.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Queue one message, used by the LOG macros
+     * @note Fatal messages and messages after shutdown() are written by the
+     * caller before returning.
+     * @param site    call site rate limit state
+     * @param level   ::LogLevel
+     * @param format  printf format
+     */
+    static void write(LogSite &site, int level, const char *format, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 3, 4)))
+#endif
+    ;
+
+    /**
+     * @brief Write all queued messages now
+     */
+    static void flush();
+
+    /**
+     * @brief Stop the background thread after writing the queued messages,
+     * later messages are written by the caller. Called at exit.
+     */
+    static void shutdown();
+
+    /**
+     * @brief Number of messages dropped because a ring was full
+     */
+    static uint64_t dropped();
+
+private:
+    Logger();
+
+    static Logger *instance();
+    static LogRing *localRing();
+    static bool allow(LogSite &site, uint32_t &suppressed);
+
+    void drain();
+    int drainThread();
+
+private:
+    static std::atomic<int> s_level;
+
+    std::vector<LogRing *> m_rings;
+    Locker m_ringLock;       ///< guards m_rings
+    Locker m_drainLock;      ///< single consumer of the rings
+    std::atomic<uint64_t> m_dropped;
+    uint64_t m_reported;     ///< dropped messages already reported
+    std::atomic<bool> m_running;  ///< the background thread keeps draining
+    std::atomic<bool> m_active;   ///< the background thread has not returned yet
+    Thread m_thread;
+};
+
+}//common
+}//core
+}//ydlidar
@@ -0,0 +1,335 @@
+#include "PcapFile.h"
+#include <core/base/timer.h>
+#include <string.h>
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+#define PCAP_MAGIC_US   0xa1b2c3d4
+#define PCAP_MAGIC_NS   0xa1b23c4d
+#define LINKTYPE_ETHERNET   1
+#define LINKTYPE_LINUX_SLL  113
+#define LINKTYPE_IPV4       228
+
+/// libpcap global header
+struct PcapFileHeader {
+    uint32_t magic;
+    uint16_t versionMajor;
+    uint16_t versionMinor;
+    int32_t thisZone;
+    uint32_t sigFigs;
+    uint32_t snapLen;
+    uint32_t linkType;
+};
+
+/// libpcap record header
+struct PcapRecordHeader {
+    uint32_t sec;
+    uint32_t usec;
+    uint32_t capLen;
+    uint32_t origLen;
+};
+
+static void put16(uint8_t *p, uint16_t v) {
+    p[0] = v >> 8;
+    p[1] = v & 0xff;
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+    p[0] = v >> 24;
+    p[1] = (v >> 16) & 0xff;
+    p[2] = (v >> 8) & 0xff;
+    p[3] = v & 0xff;
+}
+
+static uint16_t get16(const uint8_t *p) {
+    return (p[0] << 8) | p[1];
+}
+
+static uint16_t ipChecksum(const uint8_t *p, size_t len) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i + 1 < len; i += 2) {
+        sum += get16(p + i);
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    return ~sum & 0xffff;
+}
+
+/*-------------------------------------------------------------
+                          PcapWriter
+-------------------------------------------------------------*/
+PcapWriter::PcapWriter()
+    : m_fp(NULL),
+      m_ipId(0) {
+}
+
+PcapWriter::~PcapWriter() {
+    close();
+}
+
+bool PcapWriter::open(const char *path) {
+    ScopedLocker l(m_lock);
+    if (m_fp) {
+        fclose(m_fp);
+        m_fp = NULL;
+    }
+    if (!path) {
+        return false;
+    }
+    m_fp = fopen(path, "wb");
+    if (!m_fp) {
+        return false;
+    }
+    m_tcpSeq.clear();
+
+    PcapFileHeader header;
+    header.magic = PCAP_MAGIC_US;
+    header.versionMajor = 2;
+    header.versionMinor = 4;
+    header.thisZone = 0;
+    header.sigFigs = 0;
+    header.snapLen = SNAPLEN;
+    header.linkType = LINKTYPE_RAW;
+    if (fwrite(&header, sizeof(header), 1, m_fp) != 1) {
+        fclose(m_fp);
+        m_fp = NULL;
+        return false;
+    }
+    return true;
+}
+
+void PcapWriter::close() {
+    ScopedLocker l(m_lock);
+    if (m_fp) {
+        fclose(m_fp);
+        m_fp = NULL;
+    }
+}
+
+bool PcapWriter::isOpen() {
+    ScopedLocker l(m_lock);
+    return m_fp != NULL;
+}
+
+void PcapWriter::writeUdp(uint32_t srcAddr, uint16_t srcPort, uint32_t dstAddr,
+                          uint16_t dstPort, const uint8_t *data, size_t len, uint64_t stamp) {
+    write(ProtocolUdp, srcAddr, srcPort, dstAddr, dstPort, data, len, stamp);
+}
+
+void PcapWriter::writeTcp(uint32_t srcAddr, uint16_t srcPort, uint32_t dstAddr,
+                          uint16_t dstPort, const uint8_t *data, size_t len, uint64_t stamp) {
+    write(ProtocolTcp, srcAddr, srcPort, dstAddr, dstPort, data, len, stamp);
+}
+
+void PcapWriter::write(uint8_t protocol, uint32_t srcAddr, uint16_t srcPort, uint32_t dstAddr,
+                       uint16_t dstPort, const uint8_t *data, size_t len, uint64_t stamp) {
+    if (!data) {
+        return;
+    }
+    if (!stamp) {
+        stamp = getTime() / 1000;
+    }
+
+    uint8_t header[40];
+    size_t ipSize = 20;
+    size_t l4Size = protocol == ProtocolTcp ? 20 : 8;
+    if (len > SNAPLEN - ipSize - l4Size) {
+        len = SNAPLEN - ipSize - l4Size;
+    }
+    memset(header, 0, sizeof(header));
+
+    ScopedLocker l(m_lock);
+    if (!m_fp) {
+        return;
+    }
+
+    //IPv4, addresses are already in network byte order
+    uint8_t *ip = header;
+    ip[0] = 0x45;
+    put16(ip + 2, ipSize + l4Size + len);
+    put16(ip + 4, m_ipId++);
+    ip[8] = 64;
+    ip[9] = protocol;
+    memcpy(ip + 12, &srcAddr, 4);
+    memcpy(ip + 16, &dstAddr, 4);
+    put16(ip + 10, ipChecksum(ip, ipSize));
+
+    //checksums of the transport headers are left zero
+    uint8_t *l4 = header + ipSize;
+    put16(l4, srcPort);
+    put16(l4 + 2, dstPort);
+    if (protocol == ProtocolTcp) {
+        uint64_t source = (static_cast<uint64_t>(srcAddr) << 16) | srcPort;
+        uint64_t peer = (static_cast<uint64_t>(dstAddr) << 16) | dstPort;
+        uint32_t &seq = m_tcpSeq[source];
+        put32(l4 + 4, seq);
+        put32(l4 + 8, m_tcpSeq[peer]);
+        l4[12] = 5 << 4;
+        l4[13] = 0x18; //PSH ACK
+        put16(l4 + 14, 0xffff);
+        seq += len;
+    } else {
+        put16(l4 + 4, l4Size + len);
+    }
+
+    PcapRecordHeader record;
+    record.sec = stamp / 1000000;
+    record.usec = stamp % 1000000;
+    record.capLen = ipSize + l4Size + len;
+    record.origLen = record.capLen;
+    fwrite(&record, sizeof(record), 1, m_fp);
+    fwrite(header, ipSize + l4Size, 1, m_fp);
+    fwrite(data, len, 1, m_fp);
+}
+
+/*-------------------------------------------------------------
+                          PcapReader
+-------------------------------------------------------------*/
+PcapReader::PcapReader()
+    : m_fp(NULL),
+      m_swapped(false),
+      m_nano(false),
+      m_linkType(0),
+      m_dataStart(0) {
+}
+
+PcapReader::~PcapReader() {
+    close();
+}
+
+uint32_t PcapReader::swap32(uint32_t value) const {
+    if (!m_swapped) {
+        return value;
+    }
+    return ((value & 0xff) << 24) | ((value & 0xff00) << 8) |
+           ((value >> 8) & 0xff00) | (value >> 24);
+}
+
+bool PcapReader::open(const char *path) {
+    close();
+    if (!path) {
+        return false;
+    }
+    m_fp = fopen(path, "rb");
+    if (!m_fp) {
+        return false;
+    }
+
+    PcapFileHeader header;
+    if (fread(&header, sizeof(header), 1, m_fp) != 1) {
+        close();
+        return false;
+    }
+    m_swapped = false;
+    uint32_t magic = header.magic;
+    if (magic != PCAP_MAGIC_US && magic != PCAP_MAGIC_NS) {
+        m_swapped = true;
+        magic = swap32(magic);
+    }
+    if (magic != PCAP_MAGIC_US && magic != PCAP_MAGIC_NS) {
+        close();
+        return false;
+    }
+    m_nano = magic == PCAP_MAGIC_NS;
+    m_linkType = swap32(header.linkType);
+    if (m_linkType != PcapWriter::LINKTYPE_RAW && m_linkType != LINKTYPE_IPV4 &&
+        m_linkType != LINKTYPE_ETHERNET && m_linkType != LINKTYPE_LINUX_SLL) {
+        close();
+        return false;
+    }
+    m_dataStart = ftell(m_fp);
+    return true;
+}
+
+void PcapReader::close() {
+    if (m_fp) {
+        fclose(m_fp);
+        m_fp = NULL;
+    }
+}
+
+bool PcapReader::rewind() {
+    if (!m_fp) {
+        return false;
+    }
+    return fseek(m_fp, m_dataStart, SEEK_SET) == 0;
+}
+
+bool PcapReader::next(PcapPacket &packet) {
+    PcapRecordHeader record;
+    while (m_fp && fread(&record, sizeof(record), 1, m_fp) == 1) {
+        uint32_t capLen = swap32(record.capLen);
+        if (capLen > 0x40000) {
+            //corrupt record, give up rather than allocate it
+            return false;
+        }
+        m_buffer.resize(capLen);
+        if (capLen && fread(&m_buffer[0], capLen, 1, m_fp) != 1) {
+            return false;
+        }
+
+        const uint8_t *p = m_buffer.empty() ? NULL : &m_buffer[0];
+        size_t size = capLen;
+        size_t link = 0;
+        uint16_t etherType = 0x0800;
+        if (m_linkType == LINKTYPE_ETHERNET) {
+            link = 14;
+            etherType = size >= link ? get16(p + 12) : 0;
+            if (etherType == 0x8100 && size >= 18) {
+                link = 18;
+                etherType = get16(p + 16);
+            }
+        } else if (m_linkType == LINKTYPE_LINUX_SLL) {
+            link = 16;
+            etherType = size >= link ? get16(p + 14) : 0;
+        }
+        if (etherType != 0x0800 || size < link + 20) {
+            continue;
+        }
+        p += link;
+        size -= link;
+
+        size_t ipSize = (p[0] & 0x0f) * 4;
+        uint16_t fragment = get16(p + 6) & 0x1fff;
+        uint8_t protocol = p[9];
+        if ((p[0] >> 4) != 4 || ipSize < 20 || fragment ||
+            (protocol != PcapWriter::ProtocolUdp && protocol != PcapWriter::ProtocolTcp)) {
+            continue;
+        }
+        size_t total = get16(p + 2);
+        if (total < size) {
+            size = total; //drop the Ethernet padding
+        }
+        size_t l4Size = protocol == PcapWriter::ProtocolUdp ? 8 : 20;
+        if (size < ipSize + l4Size) {
+            continue;
+        }
+        const uint8_t *l4 = p + ipSize;
+        if (protocol == PcapWriter::ProtocolTcp) {
+            l4Size = (l4[12] >> 4) * 4;
+            if (l4Size < 20 || size < ipSize + l4Size) {
+                continue;
+            }
+        }
+
+        uint64_t sec = swap32(record.sec);
+        uint64_t frac = swap32(record.usec);
+        packet.stamp = sec * 1000000 + (m_nano ? frac / 1000 : frac);
+        packet.protocol = protocol;
+        memcpy(&packet.srcAddr, p + 12, 4);
+        memcpy(&packet.dstAddr, p + 16, 4);
+        packet.srcPort = get16(l4);
+        packet.dstPort = get16(l4 + 2);
+        packet.payload = l4 + l4Size;
+        packet.length = size - ipSize - l4Size;
+        return true;
+    }
+    return false;
+}
+
+}//common
+}//core
+}//ydlidar
@@ -0,0 +1,151 @@
+#pragma once
+#include <core/base/v8stdint.h>
+#include <core/base/locker.h>
+#include <stdio.h>
+#include <map>
+#include <vector>
+
+namespace ydlidar {
+namespace core {
+using namespace base;
+namespace common {
+
+/**
+ * @brief One IPv4 UDP or TCP packet of a capture file.
+ * Addresses are in network byte order, ports in host byte order.
+ */
+struct PcapPacket {
+    uint64_t stamp;         ///< capture time in microseconds since the epoch
+    uint8_t protocol;       ///< PcapWriter::ProtocolUdp or PcapWriter::ProtocolTcp
+    uint32_t srcAddr;
+    uint32_t dstAddr;
+    uint16_t srcPort;
+    uint16_t dstPort;
+    const uint8_t *payload; ///< valid until the next call of PcapReader::next
+    size_t length;
+};
+
+/**
+ * @brief Write traffic into a classic libpcap file.
+ * Payloads are wrapped in synthesized IPv4 and UDP/TCP headers
+ * (LINKTYPE_RAW), so tcpdump and Wireshark decode the file as usual.
+ * Thread safe, the data and command paths may write concurrently.
+ */
+class PcapWriter {
+public:
+    enum {
+        ProtocolTcp = 6,
+        ProtocolUdp = 17,
+        LINKTYPE_RAW = 101,     /**< Raw IPv4/IPv6 link type. */
+        SNAPLEN = 65535,        /**< Maximum captured packet size. */
+    };
+
+    PcapWriter();
+    ~PcapWriter();
+
+    /**
+     * @brief Create the file and write the global header
+     * @param path   output file, truncated
+     * @return true if the file is created, otherwise false.
+     */
+    bool open(const char *path);
+
+    /**
+     * @brief Flush and close the file.
+     */
+    void close();
+
+    /**
+     * @brief Whether the file is open.
+     */
+    bool isOpen();
+
+    /**
+     * @brief Append one datagram
+     * @param srcAddr  source address, network byte order
+     * @param srcPort  source port
+     * @param dstAddr  destination address, network byte order
+     * @param dstPort  destination port
+     * @param data     payload
+     * @param len      payload size
+     * @param stamp    capture time in microseconds since the epoch, 0 for now
+     */
+    void writeUdp(uint32_t srcAddr, uint16_t srcPort, uint32_t dstAddr, uint16_t dstPort,
+                  const uint8_t *data, size_t len, uint64_t stamp = 0);
+
+    /**
+     * @brief Append one TCP segment, sequence numbers are kept per direction
+     * @see writeUdp
+     */
+    void writeTcp(uint32_t srcAddr, uint16_t srcPort, uint32_t dstAddr, uint16_t dstPort,
+                  const uint8_t *data, size_t len, uint64_t stamp = 0);
+
+private:
+    void write(uint8_t protocol, uint32_t srcAddr, uint16_t srcPort, uint32_t dstAddr,
+               uint16_t dstPort, const uint8_t *data, size_t len, uint64_t stamp);
+
+private:
+    FILE *m_fp;
+    Locker m_lock;
+    uint16_t m_ipId;
+    std::map<uint64_t, uint32_t> m_tcpSeq;  ///< next sequence number per source
+};
+
+/**
+ * @brief Read IPv4 UDP and TCP packets back from a libpcap file.
+ * Accepts both byte orders, micro and nanosecond files and the raw,
+ * IPv4, Ethernet and Linux cooked link types, so captures taken with
+ * tcpdump replay as well as the ones written by ::PcapWriter.
+ * Not thread safe.
+ */
+class PcapReader {
+public:
+    PcapReader();
+    ~PcapReader();
+
+    /**
+     * @brief Open a capture file
+     * @param path   capture file
+     * @return false if the file is missing or not a supported capture.
+     */
+    bool open(const char *path);
+
+    /**
+     * @brief Close the file.
+     */
+    void close();
+
+    /**
+     * @brief Whether the file is open.
+     */
+    bool isOpen() const {
+        return m_fp != NULL;
+    }
+
+    /**
+     * @brief Go back to the first packet.
+     */
+    bool rewind();
+
+    /**
+     * @brief Read the next UDP or TCP packet, other packets are skipped
+     * @param[out] packet  packet, the payload points into an internal buffer
+     * @return false at the end of the file.
+     */
+    bool next(PcapPacket &packet);
+
+private:
+    uint32_t swap32(uint32_t value) const;
+
+private:
+    FILE *m_fp;
+    bool m_swapped;           ///< file written with the other byte order
+    bool m_nano;              ///< nanosecond time stamps
+    uint32_t m_linkType;
+    long m_dataStart;         ///< offset of the first record
+    std::vector<uint8_t> m_buffer;
+};
+
+}//common
+}//core
+}//ydlidar
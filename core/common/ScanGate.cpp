@@ -0,0 +1,126 @@
+#include "ScanGate.h"
+#include <math.h>
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+ScanGate::ScanGate()
+    : m_angles(ANGLE_MASK_SIZE / 32, 0xffffffff),
+      m_blocks((ANGLE_MASK_SIZE + 99) / 100, 1),
+      m_minDistance(0),
+      m_maxDistance(0xffff),
+      m_active(false),
+      m_minAngle(0.f),
+      m_maxAngle(360.f),
+      m_angleSign(1),
+      m_angleBias(0) {
+}
+
+void ScanGate::clear() {
+    m_minDistance = 0;
+    m_maxDistance = 0xffff;
+    m_minAngle = 0.f;
+    m_maxAngle = 360.f;
+    m_ignore.clear();
+    compile();
+}
+
+void ScanGate::setWindow(float minAngle, float maxAngle, float minRange, float maxRange) {
+    //距离单位为毫米，0.1f之类的值换算后略大于100，留出余量使边界上的点保留
+    double minDistance = ceil(minRange * 1000.0 - 1e-3);
+    double maxDistance = floor(maxRange * 1000.0 + 1e-3);
+    m_minDistance = 0;
+    m_maxDistance = 0xffff;
+    if (minDistance > 0) {
+        m_minDistance = minDistance < 0xffff ? static_cast<uint16_t>(minDistance) : 0xffff;
+    }
+    if (maxRange > 0 && maxDistance < 0xffff) {
+        m_maxDistance = maxDistance > 0 ? static_cast<uint16_t>(maxDistance) : 0;
+    }
+    m_minAngle = minAngle;
+    m_maxAngle = maxAngle;
+    compile();
+}
+
+bool ScanGate::setIgnore(const std::vector<float> &angles) {
+    if (angles.size() % 2) {
+        return false;
+    }
+    m_ignore = angles;
+    compile();
+    return true;
+}
+
+void ScanGate::setOrientation(bool reversion, bool inverted, float offset) {
+    long shift = lround(fmod(offset, 360.f) * 100.0) + (reversion ? ANGLE_STEPS / 2 : 0);
+    shift = (shift % ANGLE_STEPS + ANGLE_STEPS) % ANGLE_STEPS;
+    //反向时-(a + shift)，加3圈使uint16范围内的解码角度结果非负
+    m_angleSign = inverted ? -1 : 1;
+    m_angleBias = inverted ? 3 * ANGLE_STEPS - shift : shift;
+    compile();
+}
+
+void ScanGate::sector(float startAngle, float endAngle, long &first, long &span) {
+    //起点和长度换算为0.01度，起点大于终点时经过0度
+    first = lround(fmod(startAngle, 360.f) * 100.0);
+    if (first < 0) {
+        first += ANGLE_STEPS;
+    }
+    span = lround((endAngle - startAngle) * 100.0);
+    if (span < 0) {
+        span += ANGLE_STEPS;
+    }
+}
+
+void ScanGate::compile() {
+    //先在安装坐标下标记保留的角度
+    std::vector<uint8_t> keep(ANGLE_STEPS, 1);
+    long first = 0;
+    long span = 0;
+
+    bool window = m_maxAngle - m_minAngle < 360.f;
+    if (window) {
+        sector(m_minAngle, m_maxAngle, first, span);
+        for (long a = 0; a < ANGLE_STEPS; a++) {
+            if ((a - first + ANGLE_STEPS) % ANGLE_STEPS > span) {
+                keep[a] = 0;
+            }
+        }
+    }
+
+    for (size_t i = 0; i + 1 < m_ignore.size(); i += 2) {
+        sector(m_ignore[i], m_ignore[i + 1], first, span);
+        if (m_ignore[i + 1] - m_ignore[i] >= 360.f) {
+            span = ANGLE_STEPS - 1;
+        }
+        for (long k = 0; k <= span; k++) {
+            keep[(first + k) % ANGLE_STEPS] = 0;
+        }
+    }
+
+    //再换算到解码角度，超过360度的解码角度经映射后取模
+    m_angles.assign(ANGLE_MASK_SIZE / 32, 0xffffffff);
+    for (long a = 0; a < ANGLE_MASK_SIZE; a++) {
+        if (!keep[mapAngle(static_cast<uint16_t>(a))]) {
+            m_angles[a >> 5] &= ~(1u << (a & 31));
+        }
+    }
+
+    m_active = window || !m_ignore.empty() || m_minDistance > 0 || m_maxDistance < 0xffff;
+
+    //起始角在[d, d + 1)度内的数据块，点的角度落在[100d, 100d + 99 + MAX_BLOCK_SPAN]
+    for (size_t d = 0; d < m_blocks.size(); d++) {
+        uint8_t visible = 0;
+        long last = static_cast<long>(d * 100 + 99 + MAX_BLOCK_SPAN);
+        for (long a = d * 100; a <= last && !visible; a++) {
+            uint16_t angle = static_cast<uint16_t>(a); //与解码相同的uint16回绕
+            visible = (m_angles[angle >> 5] >> (angle & 31)) & 1;
+        }
+        m_blocks[d] = visible;
+    }
+}
+
+}
+}
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <core/base/v8stdint.h>
+#include <vector>
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+/**
+ * @brief Decode time point gate and mounting orientation.
+ * The angle window and the ignored sectors are compiled into one bit per
+ * 0.01 degree, indexed directly by the decoded uint16 angle, and every
+ * degree of block start angle gets a flag telling whether any point of a
+ * data block starting there can be kept, so the decoder skips whole blocks
+ * outside the window and tests every other point with one load and two
+ * compares. The orientation is one add and one modulo per point.
+ * Window and sectors are given in the mounted frame, the bitmask is
+ * compiled back to the decoded angles.
+ * Configure it before the decode thread starts.
+ */
+class ScanGate {
+public:
+    enum {
+        ANGLE_STEPS = 36000,  /**< 0.01 degree steps in a revolution. */
+        ANGLE_MASK_SIZE = 65536, /**< every uint16 angle. */
+        MAX_BLOCK_SPAN = 63 * 16, /**< largest angle span of a 16 point data block. */
+    };
+
+    ScanGate();
+
+    /**
+     * @brief Let every point through, the ignored sectors are removed
+     */
+    void clear();
+
+    /**
+     * @brief Set the window
+     * @param minAngle   minimum angle in degrees
+     * @param maxAngle   maximum angle in degrees, a window of 360 degrees or
+     *  more keeps every angle, minAngle > maxAngle wraps through 0
+     * @param minRange   minimum range in meters
+     * @param maxRange   maximum range in meters, 0 or less for no limit
+     */
+    void setWindow(float minAngle, float maxAngle, float minRange, float maxRange);
+
+    /**
+     * @brief Set the sectors whose points are dropped, on top of the window
+     * @param angles     start and end angle pairs in degrees, a start
+     *  larger than its end wraps through 0, empty for none
+     * @return false if angles holds an odd count, the sectors are unchanged.
+     */
+    bool setIgnore(const std::vector<float> &angles);
+
+    /**
+     * @brief Set the mounting orientation, applied as
+     * angle = inverted ? -(decoded + offset) : decoded + offset, modulo 360
+     * @param reversion  mounted facing backwards, adds 180 degrees to the offset
+     * @param inverted   mounted upside down, the angles turn the other way
+     * @param offset     zero angle offset in degrees
+     */
+    void setOrientation(bool reversion, bool inverted, float offset);
+
+    /**
+     * @brief Angle of a decoded point in the mounted frame
+     * @param angle      decoded angle, 0.01 degree, not wrapped at 360 degrees
+     * @return 0.01 degree, in [0, ANGLE_STEPS)
+     */
+    uint16_t mapAngle(uint16_t angle) const {
+        return static_cast<uint16_t>(
+            static_cast<uint32_t>(m_angleBias + m_angleSign * angle) % ANGLE_STEPS);
+    }
+
+    /**
+     * @brief Whether any point of a data block starting at this angle can
+     * be in the window
+     * @param startAngle block start angle, 0.01 degree
+     */
+    bool blockVisible(uint16_t startAngle) const {
+        return m_blocks[startAngle / 100] != 0;
+    }
+
+    /**
+     * @brief Whether a decoded point is kept
+     * @param angle      0.01 degree, not wrapped at 360 degrees
+     * @param distance   millimeters
+     */
+    bool visible(uint16_t angle, uint16_t distance) const {
+        return ((m_angles[angle >> 5] >> (angle & 31)) & 1) &&
+               distance >= m_minDistance && distance <= m_maxDistance;
+    }
+
+    /**
+     * @brief Whether the gate drops anything
+     */
+    bool isActive() const {
+        return m_active;
+    }
+
+private:
+    //由窗口和忽略区间生成角度位图和数据块标记
+    void compile();
+    static void sector(float startAngle, float endAngle, long &first, long &span);
+
+private:
+    std::vector<uint32_t> m_angles; //每0.01度一位，1表示保留
+    std::vector<uint8_t> m_blocks; //每度一个，以该度为起始角的数据块是否可能有保留的点
+    uint16_t m_minDistance; //单位：毫米
+    uint16_t m_maxDistance;
+    bool m_active;
+    float m_minAngle; //单位：度
+    float m_maxAngle;
+    std::vector<float> m_ignore; //忽略区间的起止角度对，单位：度
+    int32_t m_angleSign; //解码角度到安装坐标的映射：m_angleBias + m_angleSign * 解码角度
+    int32_t m_angleBias; //保证结果非负，单位：0.01度
+};
+
+}
+}
+}
@@ -0,0 +1,165 @@
+#include "ScanQueue.h"
+#include <core/base/timer.h>
+#include <string.h>
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+ScanQueue::ScanQueue()
+    : m_slots(NULL),
+      m_depth(0),
+      m_capacity(0),
+      m_head(0),
+      m_size(0),
+      m_policy(ScanQueueLatestOnly),
+      m_seq(0),
+      m_dropped(0) {
+}
+
+ScanQueue::~ScanQueue() {
+    release();
+}
+
+void ScanQueue::release() {
+    if (m_slots) {
+        for (size_t i = 0; i < m_depth; i++) {
+            delete[] m_slots[i].nodes;
+        }
+        delete[] m_slots;
+        m_slots = NULL;
+    }
+    m_depth = 0;
+    m_head = 0;
+    m_size = 0;
+}
+
+void ScanQueue::setup(size_t depth, int policy, size_t capacity) {
+    if (depth < 1) {
+        depth = 1;
+    } else if (depth > MAX_DEPTH) {
+        depth = MAX_DEPTH;
+    }
+    //latest-only keeps one scan, older ones are dropped anyway
+    if (policy != ScanQueueFifo) {
+        policy = ScanQueueLatestOnly;
+        depth = 1;
+    }
+
+    ScopedLocker l(m_lock);
+    if (depth != m_depth || capacity != m_capacity) {
+        release();
+        m_slots = new Slot[depth];
+        for (size_t i = 0; i < depth; i++) {
+            m_slots[i].nodes = new node_info[capacity];
+            m_slots[i].count = 0;
+            m_slots[i].seq = 0;
+            m_slots[i].pushed = 0;
+        }
+        m_depth = depth;
+        m_capacity = capacity;
+    }
+    m_policy = policy;
+    m_head = 0;
+    m_size = 0;
+    m_event.set(false);
+}
+
+uint64_t ScanQueue::push(const node_info *nodes, size_t count, uint64_t *pushed) {
+    ScopedLocker l(m_lock);
+    uint64_t now = getus();
+    if (pushed) {
+        *pushed = now;
+    }
+    m_seq++;
+    if (!m_slots) {
+        m_dropped++;
+        return m_seq;
+    }
+
+    if (m_size == m_depth) {
+        //overwrite the oldest scan
+        m_head = (m_head + 1) % m_depth;
+        m_size--;
+        m_dropped++;
+    }
+    Slot &slot = m_slots[(m_head + m_size) % m_depth];
+    slot.count = count < m_capacity ? count : m_capacity;
+    slot.seq = m_seq;
+    slot.pushed = now;
+    memcpy(slot.nodes, nodes, slot.count * sizeof(node_info));
+    m_size++;
+    m_event.set();
+    return m_seq;
+}
+
+result_t ScanQueue::pop(node_info *nodes, size_t &count, scan_sequence *sequence,
+                        uint32_t timeout) {
+    bool waited = false;
+    while (true) {
+        {
+            ScopedLocker l(m_lock);
+            if (m_size) {
+                const Slot &slot = m_slots[m_head];
+                size_t size_to_copy = count < slot.count ? count : slot.count;
+                memcpy(nodes, slot.nodes, size_to_copy * sizeof(node_info));
+                count = size_to_copy;
+                if (sequence) {
+                    sequence->seq = slot.seq;
+                    sequence->dropped = m_dropped;
+                    sequence->pushed = slot.pushed;
+                }
+                m_head = (m_head + 1) % m_depth;
+                m_size--;
+                if (!m_size) {
+                    m_event.set(false);
+                }
+                return RESULT_OK;
+            }
+        }
+
+        if (waited) {
+            count = 0;
+            return RESULT_FAIL;
+        }
+
+        switch (m_event.wait(timeout)) {
+            case Event::EVENT_OK:
+                waited = true;
+                break;
+
+            case Event::EVENT_TIMEOUT:
+                count = 0;
+                return RESULT_TIMEOUT;
+
+            default:
+                count = 0;
+                return RESULT_FAIL;
+        }
+    }
+}
+
+void ScanQueue::wakeup() {
+    m_event.set();
+}
+
+void ScanQueue::clear() {
+    ScopedLocker l(m_lock);
+    m_head = 0;
+    m_size = 0;
+    m_event.set(false);
+}
+
+size_t ScanQueue::size() {
+    ScopedLocker l(m_lock);
+    return m_size;
+}
+
+uint64_t ScanQueue::dropped() {
+    ScopedLocker l(m_lock);
+    return m_dropped;
+}
+
+}//common
+}//core
+}//ydlidar
@@ -0,0 +1,101 @@
+#pragma once
+#include <core/base/v8stdint.h>
+#include <core/base/locker.h>
+#include "ydlidar_datatype.h"
+
+namespace ydlidar {
+namespace core {
+using namespace base;
+namespace common {
+
+/**
+ * @brief Bounded queue of complete scans between the decode thread and
+ * the consumer.
+ * Every pushed scan gets a sequence number starting from 1, scans that are
+ * overwritten before being consumed are counted as dropped.
+ */
+class ScanQueue {
+public:
+    enum {
+        MAX_DEPTH = 32, /**< Maximum queue depth. */
+    };
+
+    ScanQueue();
+    ~ScanQueue();
+
+    /**
+     * @brief Resize the queue, queued scans are discarded.
+     * @param depth   number of scans kept, clamped to [1, MAX_DEPTH]
+     * @param policy  ::ScanQueuePolicy
+     * @param capacity maximum nodes per scan
+     */
+    void setup(size_t depth, int policy, size_t capacity);
+
+    /**
+     * @brief Queue one scan
+     * @param nodes  scan nodes
+     * @param count  node count
+     * @param[out] pushed  time the scan was queued, see getus(), may be NULL
+     * @return sequence number of the queued scan
+     */
+    uint64_t push(const node_info *nodes, size_t count, uint64_t *pushed = NULL);
+
+    /**
+     * @brief Take one scan, wait for it if the queue is empty
+     * @param[out] nodes      node buffer
+     * @param[in,out] count   buffer size in, copied nodes out
+     * @param[out] sequence   sequence information, may be NULL
+     * @param timeout         timeout
+     * @return result status
+     * @retval RESULT_OK       success
+     * @retval RESULT_TIMEOUT  no scan within timeout
+     * @retval RESULT_FAIL     woken up by ::wakeup
+     */
+    result_t pop(node_info *nodes, size_t &count, scan_sequence *sequence,
+                 uint32_t timeout);
+
+    /**
+     * @brief Wake up a waiting consumer
+     */
+    void wakeup();
+
+    /**
+     * @brief Discard queued scans
+     */
+    void clear();
+
+    /**
+     * @brief Number of queued scans.
+     */
+    size_t size();
+
+    /**
+     * @brief Total number of dropped scans.
+     */
+    uint64_t dropped();
+
+private:
+    void release();
+
+private:
+    struct Slot {
+        node_info *nodes;
+        size_t count;
+        uint64_t seq;
+        uint64_t pushed;
+    };
+    Slot *m_slots;
+    size_t m_depth;
+    size_t m_capacity;
+    size_t m_head;  ///< oldest scan
+    size_t m_size;
+    int m_policy;
+    uint64_t m_seq;
+    uint64_t m_dropped;
+    Locker m_lock;
+    Event m_event;
+};
+
+}//common
+}//core
+}//ydlidar
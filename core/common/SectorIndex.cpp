@@ -0,0 +1,114 @@
+#include "SectorIndex.h"
+#include <algorithm>
+#include <math.h>
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+SectorIndex::SectorIndex()
+    : seq(0),
+      stamp(0),
+      m_sectors(0),
+      m_levels(0) {
+}
+
+bool SectorIndex::setSectors(size_t sectors) {
+    if (sectors > MAX_SECTORS) {
+        return false;
+    }
+    m_sectors = sectors;
+    m_levels = 1;
+    while ((static_cast<size_t>(1) << m_levels) <= sectors) {
+        m_levels++;
+    }
+    m_table.assign(m_levels * sectors, EMPTY);
+    m_log.assign(sectors + 1, 0);
+    for (size_t len = 2; len <= sectors; len++) {
+        m_log[len] = m_log[len / 2] + 1;
+    }
+    seq = 0;
+    stamp = 0;
+    return true;
+}
+
+size_t SectorIndex::sectorOf(float angle) const {
+    if (!m_sectors) {
+        return 0;
+    }
+    double a = fmod(static_cast<double>(angle), 360.0);
+    if (a < 0) {
+        a += 360.0;
+    }
+    size_t sector = static_cast<size_t>(a * m_sectors / 360.0);
+    return sector < m_sectors ? sector : m_sectors - 1;
+}
+
+void SectorIndex::reset() {
+    std::fill(m_table.begin(), m_table.begin() + m_sectors, static_cast<uint32_t>(EMPTY));
+}
+
+void SectorIndex::finish(uint64_t seq, uint64_t stamp) {
+    this->seq = seq;
+    this->stamp = stamp;
+    for (size_t level = 1; level < m_levels; level++) {
+        const uint32_t *below = &m_table[(level - 1) * m_sectors];
+        uint32_t *row = &m_table[level * m_sectors];
+        size_t half = static_cast<size_t>(1) << (level - 1);
+        size_t count = m_sectors + 1 - (static_cast<size_t>(1) << level);
+        for (size_t i = 0; i < count; i++) {
+            row[i] = std::min(below[i], below[i + half]);
+        }
+    }
+}
+
+uint32_t SectorIndex::query(size_t first, size_t last) const {
+    size_t level = m_log[last - first + 1];
+    const uint32_t *row = &m_table[level * m_sectors];
+    return std::min(row[first], row[last + 1 - (static_cast<size_t>(1) << level)]);
+}
+
+bool SectorIndex::unpack(uint32_t packed, float &range, float &angle) {
+    if (packed == EMPTY) {
+        return false;
+    }
+    range = static_cast<float>((packed >> 16) / 1000.f);//单位：m
+    angle = static_cast<float>((packed & 0xffff) / 100.0f);//单位：度
+    return true;
+}
+
+bool SectorIndex::nearest(size_t sector, float &range, float &angle) const {
+    if (sector >= m_sectors) {
+        return false;
+    }
+    return unpack(m_table[sector], range, angle);
+}
+
+bool SectorIndex::nearest(size_t first, size_t last, float &range, float &angle) const {
+    if (first >= m_sectors || last >= m_sectors) {
+        return false;
+    }
+    uint32_t packed = first <= last ? query(first, last) :
+                      std::min(query(first, m_sectors - 1), query(0, last));
+    return unpack(packed, range, angle);
+}
+
+bool SectorIndex::nearestBetween(float minAngle, float maxAngle, float &range, float &angle) const {
+    if (!m_sectors) {
+        return false;
+    }
+    if (maxAngle - minAngle >= 360.f) {
+        return nearest(0, m_sectors - 1, range, angle);
+    }
+    size_t first = sectorOf(minAngle);
+    size_t last = sectorOf(maxAngle);
+    if (first == last && maxAngle < minAngle) {
+        //经过0度且两端落在同一扇区，整圈都要查
+        return nearest(0, m_sectors - 1, range, angle);
+    }
+    return nearest(first, last, range, angle);
+}
+
+}
+}
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <core/base/v8stdint.h>
+#include <vector>
+#include "ydlidar_datatype.h"
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+/**
+ * @brief Nearest return of every angular sector of one scan.
+ * The decode thread feeds the points with ::add while it assembles the
+ * revolution and ::finish builds a sparse table of the sector minima, so
+ * the nearest return of one sector or of any run of sectors is found in
+ * constant time without the points.
+ * A sector minimum is packed as distance << 16 | angle, the smallest
+ * packed value is the nearest return.
+ */
+class SectorIndex {
+public:
+    enum {
+        MAX_SECTORS = 3600, /**< 0.1 degree sectors. */
+        ANGLE_STEPS = 36000, /**< decoded angle unit, 0.01 degree. */
+        EMPTY = 0xffffffff, /**< packed value of a sector without valid return. */
+    };
+
+    SectorIndex();
+
+    /**
+     * @brief Split the revolution into equal sectors, sector k starts at
+     * k * 360 / sectors degrees
+     * @param sectors    1 to MAX_SECTORS, 0 disables the index
+     * @return false if out of range, the sectors are unchanged.
+     */
+    bool setSectors(size_t sectors);
+
+    /**
+     * @brief Number of sectors, 0 if disabled
+     */
+    size_t sectors() const {
+        return m_sectors;
+    }
+
+    /**
+     * @brief Sector holding an angle
+     * @param angle      degrees
+     */
+    size_t sectorOf(float angle) const;
+
+    /**
+     * @brief Start a revolution
+     */
+    void reset();
+
+    /**
+     * @brief Add a decoded point
+     * @param node       angle in 0.01 degree, distance in millimeters, 0 if invalid
+     */
+    void add(const node_info &node) {
+        if (!node.distance_q2) {
+            return;
+        }
+        uint32_t angle = node.angle_q6_checkbit % ANGLE_STEPS;
+        uint32_t &value = m_table[angle * m_sectors / ANGLE_STEPS];
+        uint32_t packed = (static_cast<uint32_t>(node.distance_q2) << 16) | angle;
+        if (packed < value) {
+            value = packed;
+        }
+    }
+
+    /**
+     * @brief End the revolution and build the range query table
+     * @param seq        scan sequence number
+     * @param stamp      scan stamp
+     */
+    void finish(uint64_t seq, uint64_t stamp);
+
+    /**
+     * @brief Nearest return of one sector
+     * @param sector     sector index
+     * @param[out] range meters
+     * @param[out] angle degrees
+     * @return false if the sector is out of range or has no valid return.
+     */
+    bool nearest(size_t sector, float &range, float &angle) const;
+
+    /**
+     * @brief Nearest return of the sectors first to last
+     * @param first      first sector
+     * @param last       last sector, smaller than first wraps through sector 0
+     * @param[out] range meters
+     * @param[out] angle degrees
+     * @return false if a sector is out of range or none has a valid return.
+     */
+    bool nearest(size_t first, size_t last, float &range, float &angle) const;
+
+    /**
+     * @brief Nearest return between two angles
+     * @param minAngle   degrees
+     * @param maxAngle   degrees, smaller than minAngle wraps through 0
+     * @param[out] range meters
+     * @param[out] angle degrees
+     * @return false if the index is disabled or no sector has a valid return.
+     * @note Whole sectors are searched, the return may lie up to one sector
+     * outside the angles.
+     */
+    bool nearestBetween(float minAngle, float maxAngle, float &range, float &angle) const;
+
+public:
+    uint64_t seq; ///< sequence number of the scan
+    uint64_t stamp; ///< System time when first range was measured in nanoseconds
+
+private:
+    //第0层内[first, last]的最小值，first <= last
+    uint32_t query(size_t first, size_t last) const;
+    static bool unpack(uint32_t packed, float &range, float &angle);
+
+private:
+    size_t m_sectors;
+    size_t m_levels; //稀疏表层数，第l层第i项为[i, i + 2^l)的最小值
+    std::vector<uint32_t> m_table; //按层依次存放，第0层是各扇区的最小值
+    std::vector<uint8_t> m_log; //区间长度的floor(log2)
+};
+
+}
+}
+}
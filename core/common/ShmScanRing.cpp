@@ -0,0 +1,256 @@
+#include "ShmScanRing.h"
+#include "ydlidar_help.h"
+#include <string.h>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+#define SHM_LOAD(p)         __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define SHM_STORE(p, v)     __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define SHM_FENCE_ACQUIRE() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define SHM_FENCE_RELEASE() __atomic_thread_fence(__ATOMIC_RELEASE)
+
+/// slot size rounded up so that every slot header stays 8 byte aligned
+static size_t shmSlotSize(uint32_t capacity) {
+    size_t size = sizeof(ShmScanSlot) + (capacity - 1) * sizeof(node_info);
+    return (size + 7) & ~(size_t)7;
+}
+
+/*-------------------------------------------------------------
+                        ShmScanPublisher
+-------------------------------------------------------------*/
+ShmScanPublisher::ShmScanPublisher()
+    : m_header(NULL),
+      m_size(0),
+      m_inode(0) {
+}
+
+ShmScanPublisher::~ShmScanPublisher() {
+    close();
+}
+
+bool ShmScanPublisher::open(const char *name, uint32_t slots, uint32_t capacity, bool takeOver) {
+    close();
+    if (name == NULL || !slots || !capacity) {
+        return false;
+    }
+#if defined(_WIN32)
+    LOGW("Shared memory scan ring is not supported on this platform");
+    return false;
+#else
+    size_t slotSize = shmSlotSize(capacity);
+    size_t size = sizeof(ShmScanHeader) + slots * slotSize;
+
+    //a live publisher cannot be told from a crashed one, replacing the ring is explicit
+    if (takeOver) {
+        shm_unlink(name);
+    }
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        if (errno == EEXIST) {
+            LOGE("Shared memory scan ring [%s] already exists, take it over to replace it", name);
+        } else {
+            LOGE("shm_open(%s) failed: %s", name, strerror(errno));
+        }
+        return false;
+    }
+    struct stat st;
+    m_inode = fstat(fd, &st) == 0 ? static_cast<uint64_t>(st.st_ino) : 0;
+    if (ftruncate(fd, size) != 0) {
+        LOGE("ftruncate(%s) failed: %s", name, strerror(errno));
+        ::close(fd);
+        shm_unlink(name);
+        return false;
+    }
+    void *addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        LOGE("mmap(%s) failed: %s", name, strerror(errno));
+        shm_unlink(name);
+        return false;
+    }
+
+    memset(addr, 0, size);
+    m_header = static_cast<ShmScanHeader *>(addr);
+    m_header->version = SHM_SCAN_VERSION;
+    m_header->slotCount = slots;
+    m_header->slotCapacity = capacity;
+    m_header->slotSize = slotSize;
+    //readers check the magic last
+    SHM_STORE(&m_header->magic, (uint32_t)SHM_SCAN_MAGIC);
+    m_name = name;
+    m_size = size;
+    LOGD("Shared memory scan ring [%s] created, %u slots", name, slots);
+    return true;
+#endif
+}
+
+void ShmScanPublisher::close() {
+#if !defined(_WIN32)
+    if (m_header) {
+        munmap(m_header, m_size);
+        //the name may have been taken over since, leave the new ring alone
+        int fd = shm_open(m_name.c_str(), O_RDONLY, 0);
+        if (fd >= 0) {
+            struct stat st;
+            bool own = fstat(fd, &st) == 0 && static_cast<uint64_t>(st.st_ino) == m_inode;
+            ::close(fd);
+            if (own) {
+                shm_unlink(m_name.c_str());
+            }
+        }
+    }
+#endif
+    m_header = NULL;
+    m_size = 0;
+    m_inode = 0;
+    m_name.clear();
+}
+
+void ShmScanPublisher::publish(const node_info *nodes, size_t count, uint64_t seq) {
+    if (!m_header) {
+        return;
+    }
+    uint8_t *base = reinterpret_cast<uint8_t *>(m_header + 1);
+    ShmScanSlot *slot = reinterpret_cast<ShmScanSlot *>(
+                            base + (seq % m_header->slotCount) * m_header->slotSize);
+    if (count > m_header->slotCapacity) {
+        count = m_header->slotCapacity;
+    }
+
+    uint32_t lock = slot->lock;
+    SHM_STORE(&slot->lock, lock + 1);
+    SHM_FENCE_RELEASE();
+    slot->count = count;
+    slot->seq = seq;
+    slot->stamp = count ? nodes[0].stamp : 0;
+    memcpy(slot->nodes, nodes, count * sizeof(node_info));
+    SHM_STORE(&slot->lock, lock + 2);
+    SHM_STORE(&m_header->writeSeq, seq);
+}
+
+/*-------------------------------------------------------------
+                        ShmScanReader
+-------------------------------------------------------------*/
+ShmScanReader::ShmScanReader()
+    : m_header(NULL),
+      m_size(0) {
+}
+
+ShmScanReader::~ShmScanReader() {
+    detach();
+}
+
+bool ShmScanReader::attach(const char *name) {
+    detach();
+    if (name == NULL) {
+        return false;
+    }
+#if defined(_WIN32)
+    return false;
+#else
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ShmScanHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void *addr = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+
+    const ShmScanHeader *header = static_cast<const ShmScanHeader *>(addr);
+    if (SHM_LOAD(&header->magic) != SHM_SCAN_MAGIC ||
+        header->version != SHM_SCAN_VERSION ||
+        sizeof(ShmScanHeader) + (size_t)header->slotCount * header->slotSize >
+        (size_t)st.st_size) {
+        munmap(addr, st.st_size);
+        return false;
+    }
+    m_header = header;
+    m_size = st.st_size;
+    return true;
+#endif
+}
+
+void ShmScanReader::detach() {
+#if !defined(_WIN32)
+    if (m_header) {
+        munmap(const_cast<ShmScanHeader *>(m_header), m_size);
+    }
+#endif
+    m_header = NULL;
+    m_size = 0;
+}
+
+uint64_t ShmScanReader::latestSeq() const {
+    if (!m_header) {
+        return 0;
+    }
+    return SHM_LOAD(&m_header->writeSeq);
+}
+
+const ShmScanSlot *ShmScanReader::slotAt(uint64_t seq) const {
+    const uint8_t *base = reinterpret_cast<const uint8_t *>(m_header + 1);
+    return reinterpret_cast<const ShmScanSlot *>(
+               base + (seq % m_header->slotCount) * m_header->slotSize);
+}
+
+const ShmScanSlot *ShmScanReader::acquire(uint64_t seq, uint32_t &ticket) const {
+    if (!m_header || !seq) {
+        return NULL;
+    }
+    const ShmScanSlot *slot = slotAt(seq);
+    ticket = SHM_LOAD(&slot->lock);
+    if (ticket & 1) {
+        return NULL;
+    }
+    if (slot->seq != seq || !validate(slot, ticket)) {
+        return NULL;
+    }
+    return slot;
+}
+
+bool ShmScanReader::validate(const ShmScanSlot *slot, uint32_t ticket) const {
+    SHM_FENCE_ACQUIRE();
+    return __atomic_load_n(&slot->lock, __ATOMIC_RELAXED) == ticket;
+}
+
+bool ShmScanReader::readLatest(node_info *nodes, size_t &count, uint64_t &seq) const {
+    for (int retry = 0; retry < 4; retry++) {
+        uint32_t ticket = 0;
+        uint64_t latest = latestSeq();
+        const ShmScanSlot *slot = acquire(latest, ticket);
+        if (!slot) {
+            continue;
+        }
+        size_t size = slot->count;
+        if (size > count || size > m_header->slotCapacity) {
+            size = count < m_header->slotCapacity ? count : m_header->slotCapacity;
+        }
+        memcpy(nodes, slot->nodes, size * sizeof(node_info));
+        if (validate(slot, ticket)) {
+            count = size;
+            seq = latest;
+            return true;
+        }
+    }
+    count = 0;
+    return false;
+}
+
+}//common
+}//core
+}//ydlidar
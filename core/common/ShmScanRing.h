@@ -0,0 +1,171 @@
+#pragma once
+#include <core/base/v8stdint.h>
+#include <string>
+#include "ydlidar_datatype.h"
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+#define SHM_SCAN_MAGIC   0x52534459 /// "YDSR"
+#define SHM_SCAN_VERSION 1
+
+/**
+ * @brief Shared memory ring header.
+ * The ring holds the N most recent scans, every slot is guarded by a seqlock.
+ */
+struct ShmScanHeader {
+    uint32_t magic;         ///< SHM_SCAN_MAGIC
+    uint32_t version;       ///< SHM_SCAN_VERSION
+    uint32_t slotCount;     ///< number of scan slots
+    uint32_t slotCapacity;  ///< maximum nodes per slot
+    uint32_t slotSize;      ///< size of one slot in bytes
+    uint32_t reserved;
+    uint64_t writeSeq;      ///< sequence of the last published scan, 0 if none
+};
+
+/**
+ * @brief Shared memory scan slot.
+ * @note lock is odd while the publisher is writing the slot.
+ */
+struct ShmScanSlot {
+    uint32_t lock;          ///< seqlock counter
+    uint32_t count;         ///< valid nodes
+    uint64_t seq;           ///< scan sequence
+    uint64_t stamp;         ///< first node stamp
+    node_info nodes[1];     ///< slotCapacity nodes
+};
+
+/**
+ * @brief Publish scans into a POSIX shared memory ring.
+ * Only one publisher per ring name.
+ */
+class ShmScanPublisher {
+public:
+    enum {
+        DEFAULT_SLOTS = 8, /**< Default ring depth. */
+    };
+
+    ShmScanPublisher();
+    ~ShmScanPublisher();
+
+    /**
+     * @brief Create the shared memory ring.
+     * @param name      shared memory name, e.g. "/ydlidar_scan"
+     * @param slots     number of most recent scans kept
+     * @param capacity  maximum nodes per scan
+     * @param takeOver  replace a ring of the same name, left by a crashed
+     *  publisher or still in use; its readers keep the old ring and have
+     *  to reopen
+     * @return true if the ring is mapped, otherwise false, in particular
+     *  when the name exists and takeOver is false.
+     */
+    bool open(const char *name, uint32_t slots, uint32_t capacity, bool takeOver = false);
+
+    /**
+     * @brief Unmap the ring, and unlink it unless another publisher took
+     * the name over.
+     */
+    void close();
+
+    /**
+     * @brief Whether the ring is mapped.
+     */
+    bool isOpen() const {
+        return m_header != NULL;
+    }
+
+    /**
+     * @brief Copy one scan into the next slot.
+     * @param nodes  scan nodes
+     * @param count  node count
+     * @param seq    scan sequence, must be increasing and non zero
+     */
+    void publish(const node_info *nodes, size_t count, uint64_t seq);
+
+private:
+    std::string m_name;
+    ShmScanHeader *m_header;
+    size_t m_size;
+    uint64_t m_inode; ///< shared memory object created by ::open
+};
+
+/**
+ * @brief Read-only view of a shared memory ring.
+ * @par usage
+ * @code
+ * ShmScanReader reader;
+ * reader.attach("/ydlidar_scan");
+ * uint32_t ticket = 0;
+ * const ShmScanSlot *slot = reader.acquire(reader.latestSeq(), ticket);
+ * if (slot) {
+ *     //use slot->nodes in place
+ *     if (!reader.validate(slot, ticket)) {
+ *         //scan has been overwritten while reading, discard it
+ *     }
+ * }
+ * @endcode
+ */
+class ShmScanReader {
+public:
+    ShmScanReader();
+    ~ShmScanReader();
+
+    /**
+     * @brief Map an existing ring read-only.
+     * @param name shared memory name
+     * @return true if the ring is mapped and valid, otherwise false.
+     */
+    bool attach(const char *name);
+
+    /**
+     * @brief Unmap the ring.
+     */
+    void detach();
+
+    /**
+     * @brief Sequence of the most recent complete scan, 0 if none.
+     */
+    uint64_t latestSeq() const;
+
+    /**
+     * @brief Number of slots in the ring.
+     */
+    uint32_t slotCount() const {
+        return m_header ? m_header->slotCount : 0;
+    }
+
+    /**
+     * @brief Get a scan in place.
+     * @param seq           scan sequence
+     * @param[out] ticket   seqlock ticket for ::validate
+     * @return slot pointer, NULL if the scan is being written or is gone.
+     */
+    const ShmScanSlot *acquire(uint64_t seq, uint32_t &ticket) const;
+
+    /**
+     * @brief Check that a slot was not modified since ::acquire.
+     * @return true if the data read from the slot is consistent.
+     */
+    bool validate(const ShmScanSlot *slot, uint32_t ticket) const;
+
+    /**
+     * @brief Copy the most recent scan.
+     * @param[out] nodes  node buffer
+     * @param[in,out] count  buffer size in, copied nodes out
+     * @param[out] seq    scan sequence
+     * @return true if a consistent scan was copied.
+     */
+    bool readLatest(node_info *nodes, size_t &count, uint64_t &seq) const;
+
+private:
+    const ShmScanSlot *slotAt(uint64_t seq) const;
+
+private:
+    const ShmScanHeader *m_header;
+    size_t m_size;
+};
+
+}//common
+}//core
+}//ydlidar
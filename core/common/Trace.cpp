@@ -0,0 +1,208 @@
+#include "Trace.h"
+#include <core/base/locker.h>
+#include <core/base/thread.h>
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <string>
+#include <vector>
+#if defined(_WIN32)
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace ydlidar {
+namespace core {
+using namespace base;
+namespace common {
+
+/// one trace event, seq guards against concurrent overwrite
+struct TraceEvent {
+    std::atomic<uint64_t> seq;  ///< ring index + 1 once written, 0 while writing
+    const char *name;
+    uint64_t ts;
+    uint32_t dur;
+    uint32_t tid;
+    char phase;
+};
+
+std::atomic<bool> Trace::s_enabled(false);
+
+static TraceEvent *s_events = NULL;       ///< allocated once, never freed
+static size_t s_capacity = 0;
+static std::atomic<uint64_t> s_next(0);
+static std::atomic<uint32_t> s_nextTid(1);
+static thread_local uint32_t t_tid = 0;
+
+static Locker s_lock;                     ///< guards allocation, names and dumps
+static std::vector<std::pair<uint32_t, std::string> > s_threadNames;
+
+static std::atomic<bool> s_dumpRequested(false);
+static std::string s_dumpPath;
+static Thread s_dumpThread;
+
+void Trace::enable(size_t events) {
+    ScopedLocker l(s_lock);
+    if (!s_events) {
+        size_t capacity = 1024;
+        while (capacity < events) {
+            capacity <<= 1;
+        }
+        s_events = new TraceEvent[capacity];
+        for (size_t i = 0; i < capacity; i++) {
+            s_events[i].seq.store(0, std::memory_order_relaxed);
+        }
+        s_capacity = capacity;
+    }
+    s_enabled.store(true, std::memory_order_release);
+}
+
+void Trace::disable() {
+    s_enabled.store(false, std::memory_order_release);
+}
+
+uint32_t Trace::threadId() {
+    if (!t_tid) {
+        t_tid = s_nextTid.fetch_add(1, std::memory_order_relaxed);
+    }
+    return t_tid;
+}
+
+static void record(const char *name, char phase, uint64_t ts, uint64_t dur, uint32_t tid) {
+    uint64_t index = s_next.fetch_add(1, std::memory_order_relaxed);
+    TraceEvent &event = s_events[index & (s_capacity - 1)];
+    event.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name = name;
+    event.ts = ts;
+    event.dur = dur > 0xffffffffu ? 0xffffffffu : static_cast<uint32_t>(dur);
+    event.tid = tid;
+    event.phase = phase;
+    event.seq.store(index + 1, std::memory_order_release);
+}
+
+void Trace::complete(const char *name, uint64_t start, uint64_t dur) {
+    if (!isEnabled()) {
+        return;
+    }
+    record(name, 'X', start, dur, threadId());
+}
+
+void Trace::instant(const char *name) {
+    if (!isEnabled()) {
+        return;
+    }
+    record(name, 'i', getus(), 0, threadId());
+}
+
+void Trace::setThreadName(const char *name) {
+    uint32_t tid = threadId();
+    ScopedLocker l(s_lock);
+    for (size_t i = 0; i < s_threadNames.size(); i++) {
+        if (s_threadNames[i].first == tid) {
+            s_threadNames[i].second = name;
+            return;
+        }
+    }
+    s_threadNames.push_back(std::make_pair(tid, std::string(name)));
+}
+
+bool Trace::dump(const char *path) {
+    ScopedLocker l(s_lock);
+    FILE *fp = fopen(path, "w");
+    if (!fp) {
+        return false;
+    }
+
+    int pid = getpid();
+    fprintf(fp, "{\"traceEvents\":[\n");
+    bool first = true;
+    for (size_t i = 0; i < s_threadNames.size(); i++) {
+        fprintf(fp, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,"
+                "\"args\":{\"name\":\"%s\"}}", first ? "" : ",\n", pid,
+                s_threadNames[i].first, s_threadNames[i].second.c_str());
+        first = false;
+    }
+
+    uint64_t end = s_next.load(std::memory_order_acquire);
+    uint64_t begin = end > s_capacity ? end - s_capacity : 0;
+    for (uint64_t index = begin; s_events && index < end; index++) {
+        const TraceEvent &event = s_events[index & (s_capacity - 1)];
+        uint64_t seq = event.seq.load(std::memory_order_acquire);
+        if (seq != index + 1) {
+            continue;
+        }
+        const char *name = event.name;
+        uint64_t ts = event.ts;
+        uint32_t dur = event.dur;
+        uint32_t tid = event.tid;
+        char phase = event.phase;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (event.seq.load(std::memory_order_relaxed) != seq) {
+            continue;
+        }
+
+        if (phase == 'X') {
+            fprintf(fp, "%s{\"name\":\"%s\",\"cat\":\"lidar\",\"ph\":\"X\",\"ts\":%llu,"
+                    "\"dur\":%u,\"pid\":%d,\"tid\":%u}", first ? "" : ",\n", name,
+                    (unsigned long long)ts, dur, pid, tid);
+        } else {
+            fprintf(fp, "%s{\"name\":\"%s\",\"cat\":\"lidar\",\"ph\":\"i\",\"s\":\"t\","
+                    "\"ts\":%llu,\"pid\":%d,\"tid\":%u}", first ? "" : ",\n", name,
+                    (unsigned long long)ts, pid, tid);
+        }
+        first = false;
+    }
+    fprintf(fp, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    return fclose(fp) == 0;
+}
+
+static void onDumpSignal(int) {
+    s_dumpRequested.store(true, std::memory_order_relaxed);
+}
+
+static _size_t THREAD_PROC dumpThread(void *) {
+    while (true) {
+        if (s_dumpRequested.exchange(false, std::memory_order_relaxed)) {
+            std::string path;
+            {
+                ScopedLocker l(s_lock);
+                path = s_dumpPath;
+            }
+            if (Trace::dump(path.c_str())) {
+                fprintf(stderr, "[LIDAR SDK] trace written to %s\n", path.c_str());
+            }
+        }
+        delay(100);
+    }
+    return 0;
+}
+
+bool Trace::dumpOnSignal(int signo, const char *path) {
+#if defined(_WIN32)
+    return false;
+#else
+    if (!path) {
+        return false;
+    }
+    {
+        ScopedLocker l(s_lock);
+        s_dumpPath = path;
+        if (!s_dumpThread.getHandle()) {
+            s_dumpThread = Thread::createThread(dumpThread, NULL);
+        }
+    }
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = onDumpSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    return sigaction(signo, &action, NULL) == 0;
+#endif
+}
+
+}//common
+}//core
+}//ydlidar
@@ -0,0 +1,110 @@
+#pragma once
+#include <core/base/v8stdint.h>
+#include <core/base/timer.h>
+#include <atomic>
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+/**
+ * @brief Process wide trace of driver activity.
+ * Events are kept in a lock-free ring and written as Chrome trace-event
+ * JSON, which chrome://tracing and Perfetto open directly.
+ * While disabled every trace point costs one atomic load.
+ */
+class Trace {
+public:
+    enum {
+        DEFAULT_EVENTS = 1 << 16, /**< Default ring size. */
+    };
+
+    /**
+     * @brief Start recording
+     * @param events  ring size, rounded up to a power of two. The ring is
+     *  allocated by the first call and keeps its size afterwards.
+     */
+    static void enable(size_t events = DEFAULT_EVENTS);
+
+    /**
+     * @brief Stop recording, recorded events are kept for ::dump
+     */
+    static void disable();
+
+    /**
+     * @brief Whether events are recorded
+     */
+    static bool isEnabled() {
+        return s_enabled.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Record a complete event
+     * @param name   static event name
+     * @param start  getus() at the beginning of the event
+     * @param dur    duration in microseconds
+     */
+    static void complete(const char *name, uint64_t start, uint64_t dur);
+
+    /**
+     * @brief Record an instant event
+     * @param name   static event name
+     */
+    static void instant(const char *name);
+
+    /**
+     * @brief Name the calling thread in the trace
+     * @param name   thread name
+     */
+    static void setThreadName(const char *name);
+
+    /**
+     * @brief Write the ring as Chrome trace-event JSON
+     * @param path   output file
+     * @return true if the file is written, otherwise false.
+     */
+    static bool dump(const char *path);
+
+    /**
+     * @brief Dump the ring to path whenever the signal is received.
+     * The handler only sets a flag, the file is written by a helper thread.
+     * @param signo  signal number, e.g. SIGUSR1
+     * @param path   output file
+     * @return false if signals are not supported on this platform.
+     */
+    static bool dumpOnSignal(int signo, const char *path);
+
+private:
+    static uint32_t threadId();
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+/**
+ * @brief Record the enclosing scope as one complete event.
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char *name)
+        : m_name(name),
+          m_start(Trace::isEnabled() ? getus() : 0) {
+    }
+
+    ~TraceScope() {
+        if (m_start) {
+            Trace::complete(m_name, m_start, getus() - m_start);
+        }
+    }
+
+private:
+    const char *m_name;
+    uint64_t m_start;
+};
+
+}//common
+}//core
+}//ydlidar
+
+/// trace the enclosing scope, name must be a string literal
+#define TRACE_SCOPE(name) ydlidar::core::common::TraceScope _trace_scope(name)
@@ -0,0 +1,112 @@
+#include "ZoneEvaluator.h"
+#include <core/math/angles.h>
+#include <algorithm>
+#include <math.h>
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+ZoneEvaluator::ZoneEvaluator()
+    : m_zones(0) {
+    clear();
+}
+
+void ZoneEvaluator::clear() {
+    m_limits.clear();
+    m_zones = 0;
+    for (size_t z = 0; z < MAX_ZONES; z++) {
+        m_hits[z].points = 0;
+        m_hits[z].nearest = 0xffffffff;
+    }
+}
+
+bool ZoneEvaluator::interval(const std::vector<float> &polygon, double c, double s,
+                             double &near, double &far) {
+    //射线t * (c, s)与每条边求交，奇偶规则：起点在区域内时第一段从0开始
+    std::vector<double> hits;
+    const size_t vertices = polygon.size() / 2;
+    for (size_t i = 0; i < vertices; i++) {
+        size_t j = (i + 1) % vertices;
+        double x1 = polygon[2 * i];
+        double y1 = polygon[2 * i + 1];
+        double ex = polygon[2 * j] - x1;
+        double ey = polygon[2 * j + 1] - y1;
+        double det = ex * s - ey * c;
+        if (det == 0) {
+            continue;//与射线平行
+        }
+        double t = (ex * y1 - ey * x1) / det;
+        double u = (c * y1 - s * x1) / det;
+        if (t >= 0 && u >= 0 && u < 1) {
+            hits.push_back(t);
+        }
+    }
+    if (hits.empty()) {
+        return false;
+    }
+    std::sort(hits.begin(), hits.end());
+    if (hits.size() % 2) {
+        near = 0;
+        far = hits[0];
+    } else {
+        near = hits[0];
+        far = hits[1];
+    }
+    return true;
+}
+
+int ZoneEvaluator::addZone(const std::vector<float> &polygon) {
+    if (m_zones >= MAX_ZONES || polygon.size() < 6 || polygon.size() % 2) {
+        return -1;
+    }
+    if (m_limits.empty()) {
+        Limit none = {0, 0};
+        m_limits.assign(ANGLE_STEPS * MAX_ZONES, none);
+    }
+    const size_t z = m_zones;
+    for (long k = 0; k < ANGLE_STEPS; k++) {
+        double rad = math::from_degrees(k / 100.0);
+        double near = 0;
+        double far = 0;
+        Limit &limit = m_limits[k * MAX_ZONES + z];
+        limit.near = 0;
+        limit.span = 0;
+        if (!interval(polygon, cos(rad), sin(rad), near, far)) {
+            continue;
+        }
+        //毫米，距离0是无效点，不计入区域
+        double first = std::max(ceil(near * 1000.0), 1.0);
+        double last = std::min(floor(far * 1000.0), 65534.0);
+        if (first > last) {
+            continue;
+        }
+        limit.near = static_cast<uint16_t>(first);
+        limit.span = static_cast<uint16_t>(last - first + 1);
+    }
+    m_zones++;
+    return static_cast<int>(z);
+}
+
+size_t ZoneEvaluator::collect(ZoneEvent *events, uint64_t stamp) {
+    size_t count = 0;
+    for (size_t z = 0; z < m_zones; z++) {
+        Hit &hit = m_hits[z];
+        if (!hit.points) {
+            continue;
+        }
+        ZoneEvent &event = events[count++];
+        event.zone = static_cast<int>(z);
+        event.points = hit.points;
+        event.range = static_cast<float>((hit.nearest >> 16) / 1000.f);//单位：m
+        event.angle = static_cast<float>((hit.nearest & 0xffff) / 100.0f);//单位：度
+        event.stamp = stamp;
+        hit.points = 0;
+        hit.nearest = 0xffffffff;
+    }
+    return count;
+}
+
+}
+}
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <core/base/v8stdint.h>
+#include <vector>
+#include "ydlidar_def.h"
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+/**
+ * @brief Protective field evaluator run by the decoder.
+ * Every zone polygon is compiled once into the range interval it covers
+ * along each 0.01 degree ray, so a decoded point is tested against a zone
+ * with one table load and one unsigned compare. The points inside each
+ * zone are counted per data frame and reported by ::collect.
+ * Polygons are in meters in the mounted frame, x = range * cos(angle) and
+ * y = range * sin(angle). Along a ray only the interval nearest to the
+ * lidar is kept, which is exact for convex zones and for zones star shaped
+ * around the lidar.
+ * Configure it before the decode thread starts.
+ */
+class ZoneEvaluator {
+public:
+    enum {
+        MAX_ZONES = 8, /**< zones evaluated at once. */
+        ANGLE_STEPS = 36000, /**< decoded angle unit, 0.01 degree. */
+    };
+
+    ZoneEvaluator();
+
+    /**
+     * @brief Add a zone
+     * @note The first zone allocates the tables of all MAX_ZONES zones,
+     * ANGLE_STEPS * MAX_ZONES * 4 bytes, about 1.15 MB
+     * @param polygon    x, y vertex pairs in meters, at least three vertices
+     * @return zone index, -1 if the polygon is invalid or MAX_ZONES are set
+     */
+    int addZone(const std::vector<float> &polygon);
+
+    /**
+     * @brief Remove every zone
+     */
+    void clear();
+
+    size_t size() const {
+        return m_zones;
+    }
+
+    bool isActive() const {
+        return m_zones != 0;
+    }
+
+    /**
+     * @brief Test a decoded point against every zone
+     * @param angle      mounted angle, 0.01 degree in [0, ANGLE_STEPS)
+     * @param distance   millimeters
+     */
+    void check(uint16_t angle, uint16_t distance) {
+        const Limit *limit = &m_limits[angle * MAX_ZONES];
+        for (size_t z = 0; z < m_zones; z++) {
+            //distance在[near, near + span)内，无符号回绕后一次比较
+            if (static_cast<uint16_t>(distance - limit[z].near) < limit[z].span) {
+                m_hits[z].points++;
+                uint32_t packed = (static_cast<uint32_t>(distance) << 16) | angle;
+                if (packed < m_hits[z].nearest) {
+                    m_hits[z].nearest = packed;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Report the zones violated since the last call and start over
+     * @param[out] events    MAX_ZONES entries
+     * @param stamp          stamp of the frame
+     * @return number of events written
+     */
+    size_t collect(ZoneEvent *events, uint64_t stamp);
+
+private:
+    struct Limit {
+        uint16_t near; //单位：毫米
+        uint16_t span; //区间长度，0表示该方向不经过区域
+    };
+    struct Hit {
+        uint32_t points;
+        uint32_t nearest; //distance << 16 | angle
+    };
+
+    //射线与多边形相交的最近区间，单位：米，没有时返回false
+    static bool interval(const std::vector<float> &polygon, double c, double s,
+                         double &near, double &far);
+
+private:
+    std::vector<Limit> m_limits; //按角度存放，每个角度MAX_ZONES项
+    Hit m_hits[MAX_ZONES];
+    size_t m_zones;
+};
+
+}
+}
+}
@@ -109,9 +109,64 @@ typedef struct {
     LaserConfig config;/// Configuration of scan
     int moduleNum = 0;
     uint16_t envFlag = 0; //环境标记（目前只针对GS2）
+    uint64_t seq = 0; //扫描序号，从1开始
+    uint64_t dropped = 0; //未被读取而丢弃的扫描总数
 } LaserScan;
 
 
+/**
+ * @brief A point in the lidar's own integer units, see ::RawScan
+ */
+typedef struct {
+    uint16_t angle;/// angle in RawScan::angle_scale degrees, [0, 36000)
+    uint16_t distance;/// range in RawScan::distance_scale meters, 0 if invalid
+    uint8_t quality;/// signal strength
+    uint8_t reserved;
+} RawPoint;
+
+static_assert(sizeof(RawPoint) == 6, "RawPoint must stay 6 bytes");
+
+/**
+ * @brief The decoded points of one scan without float conversion.
+ * Points are naturally aligned, half the size of a LaserPoint, and are
+ * neither filtered nor binned on the fixed resolution grid; the decode
+ * time window, ignored sectors and orientation do apply.
+ * @par usage
+ * @code
+ * RawScan data;
+ * for(size_t i = 0; i < data.points.size(); i++) {
+ *  //current LiDAR angle in degrees
+ *  float angle = data.points[i].angle * data.angle_scale;
+ *  //current LiDAR range in meters
+ *  float range = data.points[i].distance * data.distance_scale;
+ * }
+ * @endcode
+ */
+typedef struct {
+    uint64_t stamp = 0;/// System time when first range was measured in nanoseconds
+    std::vector<RawPoint> points;/// Array of lidar points
+    float angle_scale = 0.01f;/// degrees per RawPoint::angle unit
+    float distance_scale = 0.001f;/// meters per RawPoint::distance unit
+    uint64_t seq = 0; //扫描序号，从1开始
+    uint64_t dropped = 0; //未被读取而丢弃的扫描总数
+} RawScan;
+
+
+/**
+ * @brief One scan of every lidar of a group, matched by device time stamp.
+ * Scans are in the order the lidars were added to the group, each filtered
+ * as its own lidar is configured.
+ */
+typedef struct {
+    uint64_t stamp = 0;/// earliest stamp of the matched scans
+    std::vector<LaserScan> scans;/// one scan per lidar
+    std::vector<int64_t> stamp_skew;/// scan stamp minus ScanSet::stamp, in LaserScan::stamp units
+    std::vector<int64_t> arrival_skew;/// scan assembled minus the earliest scan assembled, microseconds
+    uint64_t seq = 0; //扫描组序号，从1开始
+    uint64_t dropped = 0; //未被读取而丢弃的扫描组总数
+} ScanSet;
+
+
 //雷达节点信息
 struct node_info {
     uint8_t sync_flag; //首包标记
@@ -128,6 +183,14 @@ struct node_info {
 } __attribute__((packed));
 
 
+/// Scan sequence information
+struct scan_sequence {
+    uint64_t seq;     ///< scan sequence number, starts from 1
+    uint64_t dropped; ///< total scans dropped before being consumed
+    uint64_t pushed;  ///< monotonic time the scan was queued, see getus()
+};
+
+
 /// LiDAR Device Information
 struct device_info {
     uint8_t   model; ///< LiDAR model
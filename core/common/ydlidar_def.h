@@ -58,7 +58,7 @@ typedef enum {
 typedef enum {
     /* char* properties */
     LidarPropSerialPort = 0,/**< Lidar serial port or network ipaddress */
-    LidarPropIgnoreArray,/**< Lidar ignore angle array */
+    LidarPropIgnoreArray,/**< Lidar ignore angle array, "start,end,start,end..." in degrees */
     /* int properties */
     LidarPropSerialBaudrate = 10,/**< lidar serial baudrate or network port */
     LidarPropLidarType,/**< lidar type code */
@@ -66,28 +66,78 @@ typedef enum {
     LidarPropSampleRate,/**< lidar sample rate */
     LidarPropAbnormalCheckCount,/**< abnormal maximum check times */
     LidarPropIntenstiyBit,/**< lidar intensity bit count */
+    LidarPropScanQueueDepth,/**< number of scans kept for the consumer */
+    LidarPropScanQueuePolicy,/**< scan queue policy, see ::ScanQueuePolicy */
+    LidarPropFilterStrategy,/**< NoiseFilter strategy applied to every scan, -1 disables */
+    LidarPropBinPolicy,/**< point kept in a fixed resolution bin, see ::BinPolicy */
     /* float properties */
     LidarPropMaxRange = 20,/**< lidar maximum range */
     LidarPropMinRange,/**< lidar minimum range */
     LidarPropMaxAngle,/**< lidar maximum angle */
     LidarPropMinAngle,/**< lidar minimum angle */
     LidarPropScanFrequency,/**< lidar scanning frequency */
+    LidarPropAngleResolution,/**< bin width in degrees with ::LidarPropFixedResolution */
+    LidarPropAngleOffset,/**< zero angle offset in degrees, added to every point angle */
+    LidarPropSectorWidth,/**< sector width in degrees of the nearest return index, 0 disables it */
     /* bool properties */
-    LidarPropFixedResolution = 30,/**< fixed angle resolution flag */
-    LidarPropReversion,/**< lidar reversion flag */
-    LidarPropInverted,/**< lidar inverted flag */
+    LidarPropFixedResolution = 30,/**< fixed angle resolution flag, scans binned between the minimum and maximum angle */
+    LidarPropReversion,/**< lidar reversion flag, mounted facing backwards, angles turned by 180 degrees */
+    LidarPropInverted,/**< lidar inverted flag, mounted upside down, angles mirrored */
     LidarPropAutoReconnect,/**< lidar hot plug flag */
     LidarPropSingleChannel,/**< lidar single-channel flag */
     LidarPropIntenstiy,/**< lidar intensity flag */
     LidarPropSupportMotorDtrCtrl,/**< lidar support motor Dtr ctrl flag */
     LidarPropSupportHeartBeat,/**< lidar support heartbeat flag */
+    LidarPropSectorFilter,/**< run the NoiseFilter strategy on sectors too, with a fixed delay */
 } LidarProperty;
 
+/** Scan queue policy */
+typedef enum {
+    ScanQueueLatestOnly = 0,/**< keep the newest scan only, lowest latency */
+    ScanQueueFifo = 1,/**< deliver scans in order, the oldest is dropped when full */
+} ScanQueuePolicy;
+
+/** Point kept when several fall in one bin of a fixed resolution scan */
+typedef enum {
+    BinPolicyNearest = 0,/**< the point closest to the bin angle */
+    BinPolicyMin = 1,/**< the shortest valid range, for obstacle avoidance */
+} BinPolicy;
+
+/** Point reduction of a scan subscription */
+typedef enum {
+    DecimationEveryNth = 0,/**< every step-th decoded point */
+    DecimationMinBin = 1,/**< the shortest valid range of each angle bin */
+    DecimationMeanBin = 2,/**< the mean valid range of each angle bin */
+} DecimationMode;
+
+/** SDK log level */
+typedef enum {
+    LogLevelDebug = 0,/**< all messages */
+    LogLevelInfo,/**< information and above */
+    LogLevelWarn,/**< warnings and above */
+    LogLevelError,/**< errors and above */
+    LogLevelFatal,/**< fatal errors only */
+    LogLevelOff,/**< no messages */
+} LogLevel;
+
+/** Lidar driver state */
+typedef enum {
+    LidarStateDisconnected = 0,/**< not connected */
+    LidarStateConnected,/**< connected, not scanning */
+    LidarStateScanning,/**< scanning */
+    LidarStateReconnecting,/**< connection lost, reconnecting */
+} LidarState;
+
 /// lidar instance
 typedef struct {
     void *lidar;///< CYdLidar instance
 } YDLidar;
 
+/// lidar group instance
+typedef struct {
+    void *group;///< CYdLidarGroup instance and its YDLidar handles
+} YDLidarGroup;
+
 typedef enum  {
     NoError = 0,
     DeviceNotFoundError,
@@ -195,6 +245,8 @@ typedef struct {
     uint32_t npoints;/// Array of lidar points
     LaserPoint *points;
     LaserConfig config;/// Configuration of scan
+    uint64_t seq;/// Scan sequence number, starts from 1
+    uint64_t dropped;/// Total scans dropped before being consumed
 } LaserFan;
 
 /**
@@ -222,6 +274,68 @@ typedef struct {
 
 #pragma pack()
 
+/**
+ * @brief Data path counters and gauges of one lidar.
+ * Counters only grow from ::initialize, gauges hold the latest value.
+ */
+typedef struct {
+    uint64_t datagrams;/// UDP datagrams received on the data port
+    uint64_t bytes;/// bytes received on the data port
+    uint64_t frames;/// data frames reassembled
+    uint64_t resyncs;/// frames found after skipping bytes to the tail marker
+    uint64_t frameDrops;/// frames lost according to the frame sequence number
+    uint64_t timeouts;/// data port receive timeouts
+    uint64_t reconnects;/// reconnection attempts
+    uint64_t scansPublished;/// complete scans assembled
+    uint64_t scansConsumed;/// scans taken by the consumer
+    uint64_t scansDropped;/// scans overwritten before being consumed
+    uint32_t queuedScans;/// gauge, scans waiting in the scan queue
+    uint32_t scanPoints;/// gauge, points of the last complete scan
+} LidarMetrics;
+
+/**
+ * @brief Reduction applied to the scans of one subscription
+ */
+typedef struct {
+    int mode;/// ::DecimationMode
+    int step;/// DecimationEveryNth, keep one point out of step
+    float resolution;/// DecimationMinBin and DecimationMeanBin, bin width in degrees
+} ScanDecimation;
+
+/**
+ * @brief Points of one data frame inside a protective zone
+ */
+typedef struct {
+    int zone;/// zone index, in the order the zones were added
+    uint32_t points;/// points of the frame inside the zone
+    float range;/// nearest of them, meters
+    float angle;/// its angle, degrees
+    uint64_t stamp;/// stamp of the last point of the frame
+} ZoneEvent;
+
+/** Data path stages measured by the latency histograms */
+typedef enum {
+    LatencyStageReceive = 0,/**< data socket receive call, including the wait for data */
+    LatencyStageReassembly,/**< frame start found to frame complete */
+    LatencyStageDecode,/**< frame complete to points decoded */
+    LatencyStageAssembly,/**< first frame of a scan decoded to scan queued */
+    LatencyStageHandoff,/**< scan queued to scan taken by the consumer */
+    LatencyStageConvert,/**< doProcessSimple conversion */
+    LatencyStageCount,
+} LatencyStage;
+
+/**
+ * @brief Latency percentiles of one stage, in microseconds.
+ * Percentiles are accurate to about 6 percent.
+ */
+typedef struct {
+    uint64_t count;/// samples recorded
+    uint32_t p50;/// median
+    uint32_t p99;/// 99th percentile
+    uint32_t p999;/// 99.9th percentile
+    uint32_t max;/// largest sample
+} LidarLatency;
+
 /**
  * @brief initialize LaserFan
  * @param to_init
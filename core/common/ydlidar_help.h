@@ -42,6 +42,7 @@
 #pragma once
 #include "DriverInterface.h"
 #include "ydlidar_protocol.h"
+#include "Logger.h"
 #include <sstream>
 #include <vector>
 
@@ -325,12 +326,45 @@ inline void printHex(const uint8_t *data, int size)
     #define PURPLE             
 #endif
 
-#define LOG(Color, Severity, format, ...)  do{ printf(Color "[LIDAR SDK] [%s]> " COLOFF format "\n", #Severity, ##__VA_ARGS__); fflush(stdout); } while(0)
-#define LOGD(...) LOG(GREEN,  DEBUG,   __VA_ARGS__)
-#define LOGI(...) LOG(BLUE,   INFOR,   __VA_ARGS__)
-#define LOGW(...) LOG(YELLOW, WARRING, __VA_ARGS__)
-#define LOGE(...) LOG(RED,    ERROR,   __VA_ARGS__)
-#define LOGF(...) LOG(PURPLE, FALT,    __VA_ARGS__) 
+///日志先写入本线程的无锁缓存，由后台线程输出，不阻塞调用线程
+///低于YDLIDAR_LOG_LEVEL的日志在编译时去除，运行时级别见Logger::setLevel
+#ifndef YDLIDAR_LOG_LEVEL
+#define YDLIDAR_LOG_LEVEL 0
+#endif
+
+#define LOG(Level, Color, Severity, format, ...)  do{ \
+    if (ydlidar::core::common::Logger::isEnabled(Level)) { \
+        static ydlidar::core::common::LogSite _log_site; \
+        ydlidar::core::common::Logger::write(_log_site, Level, \
+            Color "[LIDAR SDK] [" #Severity "]> " COLOFF format, ##__VA_ARGS__); \
+    } } while(0)
+#define LOG_NONE(...) do{} while(0)
+
+#if YDLIDAR_LOG_LEVEL <= 0
+#define LOGD(...) LOG(LogLevelDebug, GREEN,  DEBUG,   __VA_ARGS__)
+#else
+#define LOGD(...) LOG_NONE(__VA_ARGS__)
+#endif
+#if YDLIDAR_LOG_LEVEL <= 1
+#define LOGI(...) LOG(LogLevelInfo,  BLUE,   INFOR,   __VA_ARGS__)
+#else
+#define LOGI(...) LOG_NONE(__VA_ARGS__)
+#endif
+#if YDLIDAR_LOG_LEVEL <= 2
+#define LOGW(...) LOG(LogLevelWarn,  YELLOW, WARRING, __VA_ARGS__)
+#else
+#define LOGW(...) LOG_NONE(__VA_ARGS__)
+#endif
+#if YDLIDAR_LOG_LEVEL <= 3
+#define LOGE(...) LOG(LogLevelError, RED,    ERROR,   __VA_ARGS__)
+#else
+#define LOGE(...) LOG_NONE(__VA_ARGS__)
+#endif
+#if YDLIDAR_LOG_LEVEL <= 4
+#define LOGF(...) LOG(LogLevelFatal, PURPLE, FALT,    __VA_ARGS__)
+#else
+#define LOGF(...) LOG_NONE(__VA_ARGS__)
+#endif
 
 
 /// 短整型大小端互换
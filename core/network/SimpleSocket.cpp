@@ -54,9 +54,11 @@ CSimpleSocket::CSimpleSocket(CSocketType nType) :
   m_pBuffer(NULL), m_nBufferSize(0), m_nSocketDomain(AF_INET),
   m_nSocketType(SocketTypeInvalid), m_nBytesReceived(-1),
   m_nBytesSent(-1), m_nFlags(0),
-  m_bIsBlocking(true), m_open(false) {
+  m_bIsBlocking(true), m_bIsMulticast(false), m_nRecvTimestamp(0),
+  m_open(false) {
   SetConnectTimeout(DEFAULT_CONNECTION_TIMEOUT_SEC,
                     DEFAULT_CONNECTION_TIMEOUT_USEC);
+  memset(&m_stClientSockaddr, 0, sizeof(struct sockaddr_in));
   memset(&m_stRecvTimeout, 0, sizeof(struct timeval));
   memset(&m_stSendTimeout, 0, sizeof(struct timeval));
   memset(&m_stLinger, 0, sizeof(struct linger));
@@ -294,6 +296,17 @@ bool CSimpleSocket::Initialize() {
 
   TranslateSocketError();
 
+#ifdef __linux__
+
+  //-------------------------------------------------------------------------
+  // Have the kernel attach the arrival time to every datagram.
+  //-------------------------------------------------------------------------
+  if (IsSocketValid() && m_nSocketType == CSimpleSocket::SocketTypeUdp) {
+    int32_t nOn = 1;
+    SETSOCKOPT(m_socket, SOL_SOCKET, SO_TIMESTAMP, &nOn, sizeof(nOn));
+  }
+
+#endif
   return (IsSocketValid());
 }
 
@@ -840,6 +853,50 @@ bool CSimpleSocket::SetOptionLinger(bool bEnable, uint16_t nTime) {
 }
 
 
+//------------------------------------------------------------------------------
+//
+// ReceiveDatagram() - recvfrom() keeping the SO_TIMESTAMP control message.
+//
+//------------------------------------------------------------------------------
+int32_t CSimpleSocket::ReceiveDatagram(uint8_t *pBuffer, int32_t nMaxBytes,
+                                       struct sockaddr_in *pSockaddr) {
+  m_nRecvTimestamp = 0;
+#ifdef __linux__
+  struct iovec  stIov;
+  struct msghdr stMsg;
+  char          szControl[CMSG_SPACE(sizeof(struct timeval))];
+
+  stIov.iov_base = pBuffer;
+  stIov.iov_len = nMaxBytes;
+  memset(&stMsg, 0, sizeof(stMsg));
+  stMsg.msg_name = pSockaddr;
+  stMsg.msg_namelen = sizeof(struct sockaddr_in);
+  stMsg.msg_iov = &stIov;
+  stMsg.msg_iovlen = 1;
+  stMsg.msg_control = szControl;
+  stMsg.msg_controllen = sizeof(szControl);
+
+  int32_t nBytes = static_cast<int32_t>(recvmsg(m_socket, &stMsg, 0));
+
+  if (nBytes >= 0) {
+    for (struct cmsghdr *pCmsg = CMSG_FIRSTHDR(&stMsg); pCmsg != NULL;
+         pCmsg = CMSG_NXTHDR(&stMsg, pCmsg)) {
+      if (pCmsg->cmsg_level == SOL_SOCKET && pCmsg->cmsg_type == SCM_TIMESTAMP) {
+        struct timeval tv;
+        memcpy(&tv, CMSG_DATA(pCmsg), sizeof(tv));
+        m_nRecvTimestamp = static_cast<uint64_t>(tv.tv_sec) * 1000000 + tv.tv_usec;
+      }
+    }
+  }
+
+  return nBytes;
+#else
+  uint32_t srcSize = sizeof(struct sockaddr_in);
+  return RECVFROM(m_socket, pBuffer, nMaxBytes, 0, pSockaddr, &srcSize);
+#endif
+}
+
+
 //------------------------------------------------------------------------------
 //
 // Receive() - Attempts to receive a block of data on an established
@@ -927,8 +984,6 @@ int32_t CSimpleSocket::Receive(int32_t nMaxBytes, uint8_t *pBuffer) {
     }
 
     case CSimpleSocket::SocketTypeUdp: {
-      uint32_t srcSize;
-      srcSize = sizeof(struct sockaddr_in);
       if (GetMulticast() == true) {
         do {
           m_timer.SetEndTime();
@@ -938,8 +993,8 @@ int32_t CSimpleSocket::Receive(int32_t nMaxBytes, uint8_t *pBuffer) {
             break;
           }
 
-          m_nBytesReceived = RECVFROM(m_socket, pWorkBuffer, nMaxBytes, 0,
-                                      &m_stMulticastGroup, &srcSize);                          
+          m_nBytesReceived = ReceiveDatagram(pWorkBuffer, nMaxBytes,
+                                             &m_stMulticastGroup);
           TranslateSocketError();
 
           if (m_nBytesReceived >= nMaxBytes) {
@@ -954,8 +1009,8 @@ int32_t CSimpleSocket::Receive(int32_t nMaxBytes, uint8_t *pBuffer) {
             SetSocketError(CSimpleSocket::SocketTimedout);
             break;
           }
-          m_nBytesReceived = RECVFROM(m_socket, pWorkBuffer, nMaxBytes, 0,
-                                      &m_stClientSockaddr, &srcSize);                                
+          m_nBytesReceived = ReceiveDatagram(pWorkBuffer, nMaxBytes,
+                                             &m_stClientSockaddr);
 
           TranslateSocketError();
 
@@ -499,6 +499,23 @@ class CSimpleSocket : public ChannelDevice {
     return ntohs(m_stServerSockaddr.sin_port);
   };
 
+  /// Returns the address of the last datagram sender.
+  const struct sockaddr_in &GetClientSockaddr() const {
+    return m_stClientSockaddr;
+  };
+
+  /// Returns the address of the connected server.
+  const struct sockaddr_in &GetServerSockaddr() const {
+    return m_stServerSockaddr;
+  };
+
+  /// Returns the kernel receive time of the last datagram in microseconds
+  /// since the epoch (Linux SO_TIMESTAMP).
+  ///  @return 0 if the platform or socket type does not provide it.
+  uint64_t GetReceiveTimestamp() const {
+    return m_nRecvTimestamp;
+  };
+
   /// Get the TCP receive buffer window size for the current socket object.
   /// <br><br>\b NOTE: Linux will set the receive buffer to twice the value passed.
   ///  @return zero on failure else the number of bytes of the TCP receive buffer window size if successful.
@@ -645,6 +662,13 @@ class CSimpleSocket : public ChannelDevice {
   /// means that an error has occurred.
   int32_t Writev(const struct iovec *pVector, size_t nCount);
 
+  /// Receive one datagram and its kernel receive time, recvfrom where the
+  /// platform has no SO_TIMESTAMP.
+  /// @param pBuffer buffer of nMaxBytes
+  /// @param pSockaddr sender address
+  /// @return same as recvfrom.
+  int32_t ReceiveDatagram(uint8_t *pBuffer, int32_t nMaxBytes,
+                          struct sockaddr_in *pSockaddr);
 
 
   CSimpleSocket *operator=(CSimpleSocket &socket);
@@ -669,6 +693,7 @@ class CSimpleSocket : public ChannelDevice {
   struct sockaddr_in   m_stClientSockaddr;  /// client address
   struct sockaddr_in   m_stMulticastGroup;  /// multicast group to bind to
   struct linger        m_stLinger;          /// linger flag
+  uint64_t             m_nRecvTimestamp;    /// kernel receive time of the last datagram
   CStatTimer           m_timer;             /// internal statistics.
 #if defined(_WIN32)
   WSADATA              m_hWSAData;          /// Windows
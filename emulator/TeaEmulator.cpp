@@ -0,0 +1,331 @@
+#include "TeaEmulator.h"
+#include <core/base/timer.h>
+#include <core/common/ydlidar_help.h>
+#include <core/tools/cJSON.h>
+#include <math.h>
+#include <string.h>
+#include <stdio.h>
+
+namespace ydlidar {
+namespace emulator {
+
+static const char *kValueNames[] = {
+    "samplerate", "motorSpeed", "angleCompensation", "isMultiPoint", "APD", "LD",
+    "distanceCompensation", "measureMode", "calMode", "heartbeat", "scanType", "restart"
+};
+
+TeaEmulator::TeaEmulator(const EmulatorConfig &config, uint32_t seed)
+    : m_config(config),
+      m_running(false),
+      m_scanning(false),
+      m_active(0),
+      m_cmdSocket(CSimpleSocket::SocketTypeTcp),
+      m_dataSocket(CSimpleSocket::SocketTypeUdp),
+      m_beaconSocket(CSimpleSocket::SocketTypeUdp),
+      m_rng(0x9e3779b97f4a7c15ull ^ seed),
+      m_angle(0),
+      m_frameNum(0) {
+    for (size_t i = 0; i < _countof(kValueNames); i++) {
+        m_values[kValueNames[i]] = 0;
+    }
+    m_values["samplerate"] = config.samplerate;
+    m_values["motorSpeed"] = config.motorSpeed;
+    m_values["scanType"] = config.autoStart ? 0 : -1;
+}
+
+TeaEmulator::~TeaEmulator() {
+    stop();
+}
+
+/// bind the socket to a local address before it is connected
+static bool bindLocal(CSimpleSocket &socket, const std::string &ip) {
+    if (ip.empty()) {
+        return true;
+    }
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = inet_addr(ip.c_str());
+    return bind(socket.GetSocketDescriptor(), (struct sockaddr *)&addr, sizeof(addr)) == 0;
+}
+
+bool TeaEmulator::start() {
+    stop();
+    const char *ip = m_config.ip.empty() ? NULL : m_config.ip.c_str();
+    if (!m_cmdSocket.Initialize() || !m_cmdSocket.Listen(ip, m_config.cmdPort)) {
+        fprintf(stderr, "Cannot listen on %s:%u: %s\n", ip ? ip : "*", m_config.cmdPort,
+                m_cmdSocket.DescribeError());
+        return false;
+    }
+    if (!m_dataSocket.Initialize() || !bindLocal(m_dataSocket, m_config.ip) ||
+        !m_dataSocket.Open(m_config.host.c_str(), m_config.dataPort)) {
+        fprintf(stderr, "Cannot open data port %s:%u: %s\n", m_config.host.c_str(),
+                m_config.dataPort, m_dataSocket.DescribeError());
+        m_cmdSocket.Close();
+        return false;
+    }
+    if (m_config.listPort) {
+        int broadcast = 1;
+        if (!m_beaconSocket.Initialize() || !bindLocal(m_beaconSocket, m_config.ip)) {
+            m_cmdSocket.Close();
+            m_dataSocket.Close();
+            return false;
+        }
+        setsockopt(m_beaconSocket.GetSocketDescriptor(), SOL_SOCKET, SO_BROADCAST,
+                   (const char *)&broadcast, sizeof(broadcast));
+        if (!m_beaconSocket.Open(m_config.host.c_str(), m_config.listPort)) {
+            m_cmdSocket.Close();
+            m_dataSocket.Close();
+            return false;
+        }
+    }
+
+    m_running = true;
+    m_scanning = getValue("scanType") == 0;
+    m_active = m_config.listPort ? 3 : 2;
+    m_cmdThread = CLASS_THREAD(TeaEmulator, commandThread);
+    m_dataThread = CLASS_THREAD(TeaEmulator, dataThread);
+    if (m_config.listPort) {
+        m_beaconThread = CLASS_THREAD(TeaEmulator, beaconThread);
+    }
+    return true;
+}
+
+void TeaEmulator::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    //let the workers leave on their own, Thread::join cancels the thread
+    uint32_t start = getms();
+    while (m_active > 0 && getms() - start < 1000) {
+        delay(10);
+    }
+    m_cmdThread.join();
+    m_dataThread.join();
+    m_beaconThread.join();
+    m_cmdSocket.Close();
+    m_dataSocket.Close();
+    m_beaconSocket.Close();
+    m_scanning = false;
+}
+
+int TeaEmulator::getValue(const std::string &name) {
+    ScopedLocker l(m_valueLock);
+    return m_values[name];
+}
+
+double TeaEmulator::random() {
+    m_rng ^= m_rng << 13;
+    m_rng ^= m_rng >> 7;
+    m_rng ^= m_rng << 17;
+    return (m_rng >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/*-------------------------------------------------------------
+                        命令端口（8090）
+-------------------------------------------------------------*/
+std::string TeaEmulator::handleCommand(const char *request) {
+    cJSON *root = cJSON_Parse(request);
+    if (!root) {
+        return "{}";
+    }
+    std::string reply = "{}";
+    cJSON *item = root->child;
+    if (item && item->string) {
+        char buf[128];
+        ScopedLocker l(m_valueLock);
+        if (!strcmp(item->string, "Read") && cJSON_IsString(item)) {
+            std::map<std::string, int>::iterator it = m_values.find(item->valuestring);
+            if (it != m_values.end()) {
+                snprintf(buf, sizeof(buf), "{\"%s\":%d}", it->first.c_str(), it->second);
+                reply = buf;
+            }
+        } else if (cJSON_IsNumber(item) && m_values.count(item->string)) {
+            m_values[item->string] = item->valueint;
+            if (!strcmp(item->string, "scanType")) {
+                m_scanning = item->valueint == 0;
+            }
+            snprintf(buf, sizeof(buf), "{\"%s\":%d}", item->string, item->valueint);
+            reply = buf;
+        }
+    }
+    cJSON_Delete(root);
+    return reply;
+}
+
+int TeaEmulator::commandThread() {
+    while (m_running) {
+        //short select keeps the loop responsive to stop()
+        if (!m_cmdSocket.Select(0, 100000)) {
+            continue;
+        }
+        CActiveSocket *client = m_cmdSocket.Accept();
+        if (!client) {
+            continue;
+        }
+        client->SetReceiveTimeout(1, 0);
+        char request[256] = {0};
+        int32_t len = client->Receive(sizeof(request) - 1, reinterpret_cast<uint8_t *>(request));
+        if (len > 0) {
+            request[len] = 0;
+            std::string reply = handleCommand(request);
+            client->Send(reinterpret_cast<const uint8_t *>(reply.c_str()), reply.size());
+            m_stats.commands++;
+        }
+        client->Close();
+        delete client;
+    }
+    m_active--;
+    return 0;
+}
+
+/*-------------------------------------------------------------
+                        数据端口（8000）
+-------------------------------------------------------------*/
+void TeaEmulator::buildFrame(std::vector<uint8_t> &stream) {
+    int speed = getValue("motorSpeed");
+    int rate = getValue("samplerate");
+    if (speed < 1) {
+        speed = 1;
+    }
+    if (rate < 1) {
+        rate = 1;
+    }
+    //相邻两点的角度差（0.01度），协议中为6位
+    uint32_t step = 36000 * speed / (rate * 1000);
+    step = step < 1 ? 1 : (step > 63 ? 63 : step);
+
+    NetDataFrame frame;
+    for (int i = 0; i < DATABLOCK_COUNT; i++) {
+        NetDataBlock &block = frame.dataBlock[i];
+        block.frameHead = BigLittleSwap16(0xFFEE);
+        block.startAngle = BigLittleSwap16(m_angle);
+        uint32_t add = 0;
+        for (int j = 0; j < DATA_COUNT; j++) {
+            add += step;
+            uint32_t angle = m_angle + add;
+            if (angle >= 36000) {
+                //零位之后的点从下一小包开始，剩余点为0
+                break;
+            }
+            //一个4m x 6m的房间
+            double rad = angle * M_PI / 18000.0;
+            double c = fabs(cos(rad)), s = fabs(sin(rad));
+            double range = fmin(c > 1e-6 ? 3000.0 / c : 1e9, s > 1e-6 ? 2000.0 / s : 1e9);
+            uint32_t distance = range > 65535 ? 65535 : static_cast<uint32_t>(range);
+            uint32_t quality = 100 + (angle / 100) % 100;
+            block.data[j] = BigLittleSwap32((step << 24) | (quality << 16) | distance);
+        }
+        m_angle += add;
+        if (m_angle >= 36000 - step) {
+            m_angle = 0;
+        }
+    }
+    frame.timeStamp = BigLittleSwap32(static_cast<uint32_t>(getus()));
+
+    uint8_t *p = reinterpret_cast<uint8_t *>(&frame);
+    p[NETDATAFRAMESIXE - 4] = m_frameNum++ & 0x0F;
+    p[NETDATAFRAMESIXE - 3] = 0x65;
+    p[NETDATAFRAMESIXE - 2] = 0x43;
+    p[NETDATAFRAMESIXE - 1] = 0x21;
+    stream.insert(stream.end(), p, p + NETDATAFRAMESIXE);
+    m_stats.frames++;
+}
+
+void TeaEmulator::sendDatagram(const uint8_t *data, size_t len) {
+    const Impairment &imp = m_config.impairment;
+    if (imp.loss > 0 && random() < imp.loss) {
+        m_stats.lost++;
+        return;
+    }
+    if (imp.reorder > 0 && m_held.empty() && random() < imp.reorder) {
+        m_held.assign(data, data + len);
+        m_stats.reordered++;
+        return;
+    }
+    m_dataSocket.Send(data, len);
+    m_stats.datagrams++;
+    if (imp.duplicate > 0 && random() < imp.duplicate) {
+        m_dataSocket.Send(data, len);
+        m_stats.duplicated++;
+    }
+    if (!m_held.empty()) {
+        m_dataSocket.Send(&m_held[0], m_held.size());
+        m_stats.datagrams++;
+        m_held.clear();
+    }
+}
+
+int TeaEmulator::dataThread() {
+    std::vector<uint8_t> stream;
+    uint64_t next = getus();
+    uint64_t stallAt = m_config.impairment.stallEvery ?
+                       getms() + m_config.impairment.stallEvery : 0;
+    while (m_running) {
+        if (!m_scanning) {
+            stream.clear();
+            m_held.clear();
+            delay(10);
+            next = getus();
+            continue;
+        }
+        if (stallAt && getms() >= stallAt) {
+            m_stats.stalls++;
+            uint32_t stallEnd = getms() + m_config.impairment.stallFor;
+            while (m_running && getms() < stallEnd) {
+                delay(10);
+            }
+            stallAt = getms() + m_config.impairment.stallEvery;
+            next = getus();
+        }
+
+        uint64_t now = getus();
+        if (now < next) {
+            uint64_t wait = (next - now) / 1000;
+            delay(wait > 100 ? 100 : (wait ? wait : 1));
+            continue;
+        }
+
+        //每大包192个点，按采样率发送
+        int rate = getValue("samplerate");
+        rate = rate < 1 ? 1 : rate;
+        next += (DATABLOCK_COUNT * DATA_COUNT) * 1000 / rate;
+        if (getus() > next + 1000000) {
+            next = getus();
+        }
+        buildFrame(stream);
+        size_t pos = 0;
+        while (stream.size() - pos >= DATA_ONESIZE) {
+            sendDatagram(&stream[pos], DATA_ONESIZE);
+            pos += DATA_ONESIZE;
+        }
+        stream.erase(stream.begin(), stream.begin() + pos);
+    }
+    m_active--;
+    return 0;
+}
+
+/*-------------------------------------------------------------
+                        广播端口（8001）
+-------------------------------------------------------------*/
+int TeaEmulator::beaconThread() {
+    uint32_t last = 0;
+    while (m_running) {
+        if (last && getms() - last < m_config.beaconPeriod) {
+            delay(50);
+            continue;
+        }
+        last = getms();
+        char beacon[256];
+        const char *ip = m_config.ip.empty() ? "127.0.0.1" : m_config.ip.c_str();
+        snprintf(beacon, sizeof(beacon),
+                 "{\"ip\":\"%s\",\"model\":\"TEA\",\"hardware\":\"emulator\",\"software\":\"%u\"}",
+                 ip, m_config.cmdPort);
+        m_beaconSocket.Send(reinterpret_cast<const uint8_t *>(beacon), strlen(beacon));
+    }
+    m_active--;
+    return 0;
+}
+
+}//emulator
+}//ydlidar
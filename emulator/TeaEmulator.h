@@ -0,0 +1,150 @@
+#pragma once
+#include <core/base/v8stdint.h>
+#include <core/base/thread.h>
+#include <core/base/locker.h>
+#include <core/network/ActiveSocket.h>
+#include <core/network/PassiveSocket.h>
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ydlidar {
+namespace emulator {
+
+using namespace core::base;
+using namespace core::network;
+
+/**
+ * @brief Network impairments applied to the data port datagrams.
+ * Probabilities are per datagram in the range [0, 1].
+ */
+struct Impairment {
+    double loss;            ///< drop the datagram
+    double duplicate;       ///< send the datagram twice
+    double reorder;         ///< hold the datagram back behind the next one
+    uint32_t stallEvery;    ///< stop streaming every stallEvery ms, 0 disables
+    uint32_t stallFor;      ///< length of a stall in ms
+
+    Impairment()
+        : loss(0), duplicate(0), reorder(0), stallEvery(0), stallFor(0) {}
+};
+
+/**
+ * @brief Emulator settings of one lidar.
+ */
+struct EmulatorConfig {
+    std::string ip;         ///< address the command port binds to, empty for any
+    uint16_t cmdPort;       ///< JSON command port
+    std::string host;       ///< host receiving the data and the beacons
+    uint16_t dataPort;      ///< data port on the host
+    uint16_t listPort;      ///< beacon port on the host, 0 disables the beacons
+    uint32_t beaconPeriod;  ///< ms between two beacons
+    int motorSpeed;         ///< scan frequency in Hz
+    int samplerate;         ///< thousands of points per second
+    bool autoStart;         ///< stream without waiting for scanType 0
+    Impairment impairment;
+
+    EmulatorConfig()
+        : cmdPort(8090), host("127.0.0.1"), dataPort(8000), listPort(8001),
+          beaconPeriod(1000), motorSpeed(10), samplerate(20), autoStart(false) {}
+};
+
+/**
+ * @brief Datagram counters of one emulated lidar.
+ */
+struct EmulatorStats {
+    std::atomic<uint64_t> frames;
+    std::atomic<uint64_t> datagrams;
+    std::atomic<uint64_t> lost;
+    std::atomic<uint64_t> duplicated;
+    std::atomic<uint64_t> reordered;
+    std::atomic<uint64_t> stalls;
+    std::atomic<uint64_t> commands;
+
+    EmulatorStats()
+        : frames(0), datagrams(0), lost(0), duplicated(0), reordered(0), stalls(0),
+          commands(0) {}
+};
+
+/**
+ * @brief Software TEA lidar.
+ * Answers the JSON command set on the command port, streams
+ * ::NetDataFrame s cut into DATA_ONESIZE datagrams while scanning and
+ * announces itself with discovery beacons.
+ */
+class TeaEmulator {
+public:
+    explicit TeaEmulator(const EmulatorConfig &config, uint32_t seed = 1);
+    ~TeaEmulator();
+
+    /**
+     * @brief Open the sockets and start the worker threads
+     * @return false if a socket cannot be bound.
+     */
+    bool start();
+
+    /**
+     * @brief Stop the worker threads and close the sockets.
+     */
+    void stop();
+
+    /**
+     * @brief Whether the data port is streaming.
+     */
+    bool isScanning() const {
+        return m_scanning.load();
+    }
+
+    const EmulatorConfig &config() const {
+        return m_config;
+    }
+
+    const EmulatorStats &stats() const {
+        return m_stats;
+    }
+
+private:
+    int commandThread();
+    int dataThread();
+    int beaconThread();
+
+    /// answer one JSON request, returns the JSON reply
+    std::string handleCommand(const char *request);
+
+    /// append one frame to the outgoing byte stream
+    void buildFrame(std::vector<uint8_t> &stream);
+
+    /// send one datagram through the impairments
+    void sendDatagram(const uint8_t *data, size_t len);
+
+    /// uniform random number in [0, 1)
+    double random();
+
+    int getValue(const std::string &name);
+
+private:
+    EmulatorConfig m_config;
+    EmulatorStats m_stats;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_scanning;
+    std::atomic<int> m_active;              ///< worker threads still running
+
+    CPassiveSocket m_cmdSocket;
+    CActiveSocket m_dataSocket;
+    CActiveSocket m_beaconSocket;
+    Thread m_cmdThread;
+    Thread m_dataThread;
+    Thread m_beaconThread;
+
+    Locker m_valueLock;
+    std::map<std::string, int> m_values;    ///< config values by JSON name
+
+    uint64_t m_rng;                         ///< xorshift state
+    uint32_t m_angle;                       ///< next point angle in 0.01 degree
+    uint8_t m_frameNum;                     ///< 4 bit frame counter
+    std::vector<uint8_t> m_held;            ///< datagram held back for reordering
+};
+
+}//emulator
+}//ydlidar
@@ -0,0 +1,159 @@
+#include "TeaEmulator.h"
+#include <core/base/timer.h>
+#include <arpa/inet.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+using namespace ydlidar::emulator;
+
+static volatile sig_atomic_t s_stop = 0;
+
+static void onSignal(int) {
+    s_stop = 1;
+}
+
+static void usage(const char *name) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --count N          emulated lidars (1)\n"
+            "  --ip A.B.C.D       command address of the first lidar, the next ones\n"
+            "                     increment the last byte (any address if omitted)\n"
+            "  --cmd-port P       command port of the first lidar (8090)\n"
+            "  --port-step S      command and data port increment per lidar (0 with --ip, else 1)\n"
+            "  --host A.B.C.D     host receiving data and beacons (127.0.0.1)\n"
+            "  --data-port P      data port on the host (8000)\n"
+            "  --list-port P      beacon port on the host, 0 disables beacons (8001)\n"
+            "  --beacon-ms MS     beacon period (1000)\n"
+            "  --speed HZ         scan frequency (10)\n"
+            "  --samplerate K     thousands of points per second (20)\n"
+            "  --auto-start       stream without waiting for the start command\n"
+            "  --loss P           datagram loss probability (0)\n"
+            "  --duplicate P      datagram duplication probability (0)\n"
+            "  --reorder P        datagram reordering probability (0)\n"
+            "  --stall-every MS   pause streaming periodically (0, off)\n"
+            "  --stall-ms MS      length of a pause (500)\n",
+            name);
+}
+
+//模拟TEA雷达：命令端口、数据端口和广播
+int main(int argc, char *argv[])
+{
+    EmulatorConfig config;
+    config.impairment.stallFor = 500;
+    int count = 1;
+    int portStep = -1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *opt = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!strcmp(opt, "--auto-start")) {
+            config.autoStart = true;
+            continue;
+        }
+        if (!strcmp(opt, "--help") || !strcmp(opt, "-h")) {
+            usage(argv[0]);
+            return 0;
+        }
+        if (!val) {
+            usage(argv[0]);
+            return 1;
+        }
+        i++;
+        if (!strcmp(opt, "--count")) {
+            count = atoi(val);
+        } else if (!strcmp(opt, "--ip")) {
+            config.ip = val;
+        } else if (!strcmp(opt, "--cmd-port")) {
+            config.cmdPort = atoi(val);
+        } else if (!strcmp(opt, "--port-step")) {
+            portStep = atoi(val);
+        } else if (!strcmp(opt, "--host")) {
+            config.host = val;
+        } else if (!strcmp(opt, "--data-port")) {
+            config.dataPort = atoi(val);
+        } else if (!strcmp(opt, "--list-port")) {
+            config.listPort = atoi(val);
+        } else if (!strcmp(opt, "--beacon-ms")) {
+            config.beaconPeriod = atoi(val);
+        } else if (!strcmp(opt, "--speed")) {
+            config.motorSpeed = atoi(val);
+        } else if (!strcmp(opt, "--samplerate")) {
+            config.samplerate = atoi(val);
+        } else if (!strcmp(opt, "--loss")) {
+            config.impairment.loss = atof(val);
+        } else if (!strcmp(opt, "--duplicate")) {
+            config.impairment.duplicate = atof(val);
+        } else if (!strcmp(opt, "--reorder")) {
+            config.impairment.reorder = atof(val);
+        } else if (!strcmp(opt, "--stall-every")) {
+            config.impairment.stallEvery = atoi(val);
+        } else if (!strcmp(opt, "--stall-ms")) {
+            config.impairment.stallFor = atoi(val);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (count < 1) {
+        count = 1;
+    }
+    if (portStep < 0) {
+        //不同IP可共用端口，同一IP则需错开端口
+        portStep = config.ip.empty() ? 1 : 0;
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    std::vector<TeaEmulator *> lidars;
+    for (int i = 0; i < count; i++) {
+        EmulatorConfig c = config;
+        if (!config.ip.empty()) {
+            in_addr_t addr = ntohl(inet_addr(config.ip.c_str())) + i;
+            struct in_addr in;
+            in.s_addr = htonl(addr);
+            c.ip = inet_ntoa(in);
+        }
+        c.cmdPort = config.cmdPort + i * portStep;
+        c.dataPort = config.dataPort + i * portStep;
+        TeaEmulator *lidar = new TeaEmulator(c, i + 1);
+        if (!lidar->start()) {
+            delete lidar;
+            break;
+        }
+        fprintf(stdout, "lidar %d: command %s:%u, data -> %s:%u\n", i,
+                c.ip.empty() ? "*" : c.ip.c_str(), c.cmdPort, c.host.c_str(), c.dataPort);
+        lidars.push_back(lidar);
+    }
+    fflush(stdout);
+    if (lidars.empty()) {
+        return 1;
+    }
+
+    uint32_t last = getms();
+    while (!s_stop) {
+        delay(100);
+        if (getms() - last < 5000) {
+            continue;
+        }
+        last = getms();
+        for (size_t i = 0; i < lidars.size(); i++) {
+            const EmulatorStats &s = lidars[i]->stats();
+            fprintf(stdout, "lidar %zu: %s, %llu frames, %llu datagrams, %llu lost, "
+                    "%llu duplicated, %llu reordered, %llu stalls, %llu commands\n", i,
+                    lidars[i]->isScanning() ? "scanning" : "idle",
+                    (unsigned long long)s.frames, (unsigned long long)s.datagrams,
+                    (unsigned long long)s.lost, (unsigned long long)s.duplicated,
+                    (unsigned long long)s.reordered, (unsigned long long)s.stalls,
+                    (unsigned long long)s.commands);
+        }
+        fflush(stdout);
+    }
+
+    for (size_t i = 0; i < lidars.size(); i++) {
+        lidars[i]->stop();
+        delete lidars[i];
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "CYdLidar.h"
+#include <core/base/timer.h>
+#include <atomic>
+#include <string>
+using namespace std;
+using namespace ydlidar;
+
+#if defined(_MSC_VER)
+#pragma comment(lib, "TEA_SDK.lib")
+#endif
+
+//回放pcap抓包文件（由enableRecorder或tcpdump录制），并统计解码速度
+//用法: tea_replay <file.pcap> [realtime(0|1)]
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <file.pcap> [realtime(0|1)]\n", argv[0]);
+        return 1;
+    }
+    bool realtime = argc > 2 && atoi(argv[2]) != 0;
+
+    ydlidar::os_init();
+
+    CYdLidar lidar;
+    std::atomic<bool> finished(false);
+    std::atomic<uint64_t> end(0);
+    lidar.setStateCallback([&finished, &end](LidarState state) {
+        //回放结束后驱动回到已连接状态
+        if (state == LidarStateConnected || state == LidarStateDisconnected) {
+            end = getus();
+            finished = true;
+        }
+    });
+    lidar.setReplayFile(argv[1], realtime);
+
+    if (!lidar.initialize()) {
+        fprintf(stderr, "Cannot open %s\n", argv[1]);
+        return 1;
+    }
+    finished = false;
+    uint64_t start = getus();
+    bool ret = lidar.turnOn();
+
+    LaserScan scan;
+    uint64_t scans = 0;
+    while (ret && !finished && ydlidar::os_isOk()) {
+        if (lidar.doProcessSimple(scan)) {
+            scans++;
+        }
+    }
+    double seconds = ((finished ? end.load() : getus()) - start) / 1e6;
+
+    LidarMetrics metrics;
+    lidar.getMetrics(metrics);
+    fprintf(stdout, "%llu datagrams, %llu frames, %llu scans published, %llu consumed in %.3f s\n",
+            (unsigned long long)metrics.datagrams, (unsigned long long)metrics.frames,
+            (unsigned long long)metrics.scansPublished, (unsigned long long)scans, seconds);
+    if (seconds > 0) {
+        fprintf(stdout, "%.1f frames/s, %.1f scans/s\n",
+                metrics.frames / seconds, metrics.scansPublished / seconds);
+    }
+    fprintf(stdout, "%llu resyncs, %llu frame drops\n",
+            (unsigned long long)metrics.resyncs, (unsigned long long)metrics.frameDrops);
+
+    const char *stages[] = {"Reassembly", "Decode", "Assembly"};
+    const int ids[] = {LatencyStageReassembly, LatencyStageDecode, LatencyStageAssembly};
+    for (int i = 0; i < 3; i++) {
+        LidarLatency stats;
+        if (lidar.getLatency(ids[i], stats) && stats.count) {
+            fprintf(stdout, "%-10s p50 %u us, p99 %u us, max %u us\n",
+                    stages[i], stats.p50, stats.p99, stats.max);
+        }
+    }
+    fflush(stdout);
+
+    lidar.turnOff();
+    lidar.disconnecting();
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "CYdLidar.h"
+#include <core/base/timer.h>
+#include <iostream>
+#include <string>
+using namespace std;
+using namespace ydlidar;
+
+#if defined(_MSC_VER)
+#pragma comment(lib, "TEA_SDK.lib")
+#endif
+
+//读取共享内存中的点云（由tea_test等进程调用enableShmPublisher发布）
+int main(int argc, char *argv[])
+{
+    std::string name = "/ydlidar_scan";
+    if (argc > 1) {
+        name = argv[1];
+    }
+
+    ydlidar::os_init();
+
+    ShmScanReader reader;
+    while (ydlidar::os_isOk() && !reader.attach(name.c_str())) {
+        fprintf(stderr, "Waiting for shared memory ring [%s]...\n", name.c_str());
+        delay(1000);
+    }
+
+    uint64_t lastSeq = reader.latestSeq();
+    while (ydlidar::os_isOk())
+    {
+        uint64_t seq = reader.latestSeq();
+        if (seq == lastSeq) {
+            delay(1);
+            continue;
+        }
+
+        //直接在共享内存中访问点云，不拷贝
+        uint32_t ticket = 0;
+        const ShmScanSlot *slot = reader.acquire(seq, ticket);
+        if (!slot) {
+            continue;
+        }
+        uint32_t count = slot->count;
+        uint16_t minDistance = 0xffff;
+        for (uint32_t i = 0; i < count; i++) {
+            uint16_t distance = slot->nodes[i].distance_q2;
+            if (distance && distance < minDistance) {
+                minDistance = distance;
+            }
+        }
+        if (!reader.validate(slot, ticket)) {
+            continue;
+        }
+
+        if (lastSeq && seq - lastSeq > 1) {
+            fprintf(stderr, "Missed %llu scans\n", (unsigned long long)(seq - lastSeq - 1));
+        }
+        fprintf(stdout, "Scan [%llu] %u points, closest %u mm\n",
+                (unsigned long long)seq, count, minDistance);
+        fflush(stdout);
+        lastSeq = seq;
+    }
+    return 0;
+}
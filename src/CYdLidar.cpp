@@ -26,13 +26,18 @@
 #include <algorithm>
 #include <math.h>
 #include <functional>
+#include <memory>
 #include "CYdLidar.h"
 #include "core/math/angles.h"
 #include "core/serial/common.h"
 #include "core/common/DriverInterface.h"
 #include "core/common/ydlidar_help.h"
 #include "core/common/ydlidar_def.h"
+#include "core/common/Trace.h"
 #include "TEALidarDriver.h"
+#include "PcapReplayDriver.h"
+#include "filters/NoiseFilter.h"
+#include "filters/StreamingNoiseFilter.h"
 #include <core/serial/serial.h>
 
 /*-------------------------------------------------------------
@@ -40,6 +45,9 @@
 -------------------------------------------------------------*/
 CYdLidar::CYdLidar() {
     m_lidarPtr = nullptr;
+    m_ShmPublisher = nullptr;
+    m_Recorder = nullptr;
+    m_ReplayRealtime = true;
     m_global_nodes = new node_info[DriverInterface::MAX_SCAN_NODES];
     m_field_of_view = 300;
     m_lidar_model = DriverInterface::YDLIDAR_TEA;
@@ -54,6 +62,23 @@ CYdLidar::CYdLidar() {
     m_MinRange = 0.01f;
     m_LidarType = TYPE_TIA;
     m_ScanFrequency = 10.f;
+    m_FixedResolution = false;
+    m_AngleResolution = 0.25f;
+    m_BinPolicy = BinPolicyNearest;
+    m_Reversion = false;
+    m_Inverted = false;
+    m_AngleOffset = 0.f;
+    m_SectorWidth = 0.f;
+    m_ScanQueueDepth = 1;
+    m_ScanQueuePolicy = ScanQueueLatestOnly;
+    m_CallbackThreads = 0;
+    m_FilterStrategy = -1;
+    m_NoiseFilter = nullptr;
+    m_SectorFilter = false;
+    m_StreamFilter = nullptr;
+    m_NextSubscription = 1;
+    m_SharedData = false;
+    m_DecodedSeq = 0;
 }
 
 /*-------------------------------------------------------------
@@ -61,11 +86,28 @@ CYdLidar::CYdLidar() {
 -------------------------------------------------------------*/
 CYdLidar::~CYdLidar(){
     disconnecting();
+    m_Dispatcher.stop();
     if (m_global_nodes)
     {
         delete[] m_global_nodes;
         m_global_nodes = NULL;
     }
+    if (m_ShmPublisher) {
+        delete m_ShmPublisher;
+        m_ShmPublisher = NULL;
+    }
+    if (m_Recorder) {
+        delete m_Recorder;
+        m_Recorder = NULL;
+    }
+    if (m_NoiseFilter) {
+        delete m_NoiseFilter;
+        m_NoiseFilter = NULL;
+    }
+    if (m_StreamFilter) {
+        delete m_StreamFilter;
+        m_StreamFilter = NULL;
+    }
 }
 
 /*-------------------------------------------------------------
@@ -122,6 +164,19 @@ bool CYdLidar::setlidaropt(int optname, const void *optval, int optlen) {
             m_SerialPort = (const char *)optval;
             break;
 
+        case LidarPropIgnoreArray: {
+            //"起始角,终止角,起始角,终止角..."，单位：度
+            string ignore = (const char *)optval;
+            vector<float> angles = split(ignore, ',');
+            if (angles.size() % 2) {
+                ret = false;
+                break;
+            }
+            m_IgnoreString = ignore;
+            m_IgnoreArray = angles;
+            break;
+        }
+
         case LidarPropSerialBaudrate:
             m_SerialBaudrate = *(int *)(optval);
             break;
@@ -130,6 +185,32 @@ bool CYdLidar::setlidaropt(int optname, const void *optval, int optlen) {
             m_AutoReconnect = *(bool *)(optval);
             break;
 
+        case LidarPropReversion:
+            m_Reversion = *(bool *)(optval);
+            break;
+
+        case LidarPropInverted:
+            m_Inverted = *(bool *)(optval);
+            break;
+
+        case LidarPropSectorFilter: {
+            ScopedLocker l(m_FilterLock);
+            m_SectorFilter = *(bool *)(optval);
+            break;
+        }
+
+        case LidarPropScanQueueDepth:
+            m_ScanQueueDepth = *(int *)(optval);
+            break;
+
+        case LidarPropScanQueuePolicy:
+            m_ScanQueuePolicy = *(int *)(optval);
+            break;
+
+        case LidarPropFilterStrategy:
+            ret = setFilterStrategy(*(int *)(optval));
+            break;
+
         case LidarPropMaxAngle:
             m_MaxAngle = *(float *)(optval);
             break;
@@ -150,6 +231,41 @@ bool CYdLidar::setlidaropt(int optname, const void *optval, int optlen) {
             m_ScanFrequency = *(float *)(optval);
             break;
 
+        case LidarPropFixedResolution:
+            m_FixedResolution = *(bool *)(optval);
+            break;
+
+        case LidarPropAngleResolution:
+            if (!(*(float *)(optval) > 0)) {
+                ret = false;
+                break;
+            }
+            m_AngleResolution = *(float *)(optval);
+            break;
+
+        case LidarPropAngleOffset:
+            m_AngleOffset = *(float *)(optval);
+            break;
+
+        case LidarPropSectorWidth: {
+            float width = *(float *)(optval);
+            if (!(width >= 0) || (width > 0 && !(lround(360.f / width) >= 1 &&
+                    lround(360.f / width) <= SectorIndex::MAX_SECTORS))) {
+                ret = false;
+                break;
+            }
+            m_SectorWidth = width;
+            break;
+        }
+
+        case LidarPropBinPolicy:
+            if (*(int *)(optval) != BinPolicyNearest && *(int *)(optval) != BinPolicyMin) {
+                ret = false;
+                break;
+            }
+            m_BinPolicy = *(int *)(optval);
+            break;
+
         default:
             ret = false;
             break;
@@ -211,6 +327,11 @@ bool CYdLidar::getlidaropt(int optname, void *optval, int optlen) {
             memcpy(optval, m_SerialPort.c_str(), optlen);
             break;
 
+        case LidarPropIgnoreArray:
+            memcpy(optval, m_IgnoreString.c_str(),
+                   std::min<size_t>(optlen, m_IgnoreString.size() + 1));
+            break;
+
         case LidarPropSerialBaudrate:
             memcpy(optval, &m_SerialBaudrate, optlen);
             break;
@@ -219,6 +340,30 @@ bool CYdLidar::getlidaropt(int optname, void *optval, int optlen) {
             memcpy(optval, &m_AutoReconnect, optlen);
             break;
 
+        case LidarPropReversion:
+            memcpy(optval, &m_Reversion, optlen);
+            break;
+
+        case LidarPropInverted:
+            memcpy(optval, &m_Inverted, optlen);
+            break;
+
+        case LidarPropSectorFilter:
+            memcpy(optval, &m_SectorFilter, optlen);
+            break;
+
+        case LidarPropScanQueueDepth:
+            memcpy(optval, &m_ScanQueueDepth, optlen);
+            break;
+
+        case LidarPropScanQueuePolicy:
+            memcpy(optval, &m_ScanQueuePolicy, optlen);
+            break;
+
+        case LidarPropFilterStrategy:
+            memcpy(optval, &m_FilterStrategy, optlen);
+            break;
+
         case LidarPropMaxAngle:
             memcpy(optval, &m_MaxAngle, optlen);
             break;
@@ -239,6 +384,26 @@ bool CYdLidar::getlidaropt(int optname, void *optval, int optlen) {
             memcpy(optval, &m_ScanFrequency, optlen);
             break;
 
+        case LidarPropFixedResolution:
+            memcpy(optval, &m_FixedResolution, optlen);
+            break;
+
+        case LidarPropAngleResolution:
+            memcpy(optval, &m_AngleResolution, optlen);
+            break;
+
+        case LidarPropAngleOffset:
+            memcpy(optval, &m_AngleOffset, optlen);
+            break;
+
+        case LidarPropSectorWidth:
+            memcpy(optval, &m_SectorWidth, optlen);
+            break;
+
+        case LidarPropBinPolicy:
+            memcpy(optval, &m_BinPolicy, optlen);
+            break;
+
         default:
             ret = false;
             break;
@@ -271,7 +436,9 @@ bool CYdLidar::initialize() {
 bool CYdLidar::checkCOMMs() 
 {
     if (!m_lidarPtr) {
-        if (isTEALidar(m_LidarType)) {
+        if (!m_ReplayFile.empty()) {
+            m_lidarPtr = new ydlidar::PcapReplayDriver(m_ReplayRealtime);
+        } else if (isTEALidar(m_LidarType)) {
             m_lidarPtr = new ydlidar::TEALidarDriver();
         } else {
             LOGW("An unsupported model:%d", m_LidarType);
@@ -283,6 +450,15 @@ bool CYdLidar::checkCOMMs()
         }
        
         LOGD("SDK Version: %s", m_lidarPtr->getSDKVersion().c_str());
+        m_lidarPtr->setShmPublisher(m_ShmPublisher);
+        m_lidarPtr->setRecorder(m_Recorder);
+        m_lidarPtr->setListener(this);
+        if (m_SharedData && !m_lidarPtr->setSharedData(true)) {
+            LOGE("[CYdLidar] The data port of this lidar cannot be shared");
+            delete m_lidarPtr;
+            m_lidarPtr = nullptr;
+            return false;
+        }
     } else {
         LOGD("YDLidar SDK has been initialized");
     }
@@ -291,7 +467,9 @@ bool CYdLidar::checkCOMMs()
         return true;
     }
     //make connection...
-    result_t op_result = m_lidarPtr->connect(m_SerialPort.c_str(), m_SerialBaudrate);
+    result_t op_result = m_ReplayFile.empty() ?
+                         m_lidarPtr->connect(m_SerialPort.c_str(), m_SerialBaudrate) :
+                         m_lidarPtr->connect(m_ReplayFile.c_str(), 0);
     if (!IS_OK(op_result)) {
         LOGE("[CYdLidar] Error, cannot bind to the specified IP Address[%s]", m_SerialPort.c_str());     
         return false;
@@ -319,6 +497,30 @@ bool CYdLidar::turnOn() {
         m_lidarPtr->setScanFrequency(_scan_frequency);
     }
 
+    m_lidarPtr->setScanQueue(m_ScanQueueDepth, m_ScanQueuePolicy);
+    {
+        //队列中还能取出的每一圈都要留着滤波结果，多留一格给正在解码的一圈
+        ScopedLocker l(m_FilteredLock);
+        size_t depth = m_ScanQueuePolicy == ScanQueueFifo ?
+                       std::min(std::max(m_ScanQueueDepth, 1), static_cast<int>(ScanQueue::MAX_DEPTH)) : 1;
+        m_FilteredScans.assign(depth + 1, LaserScan());
+        m_DecodedSeq = 0;
+    }
+    //安装方向在解码时换算，窗口和忽略区间都是安装方向下的角度
+    m_lidarPtr->setOrientation(m_Reversion, m_Inverted, m_AngleOffset);
+    //窗口外和超出距离范围的点在解码时丢弃
+    m_lidarPtr->setScanWindow(m_MinAngle, m_MaxAngle, m_MinRange, m_MaxRange);
+    m_lidarPtr->setIgnoreArray(m_IgnoreArray);
+    m_lidarPtr->setZones(m_Zones);
+    //扇区宽度取整为整圈的等分
+    m_lidarPtr->setSectorIndex(m_SectorWidth > 0 ? lround(360.f / m_SectorWidth) : 0);
+    {
+        //新的扇区流不接上次停止前留在窗口中的点
+        ScopedLocker l(m_FilterLock);
+        if (m_StreamFilter) {
+            m_StreamFilter->reset();
+        }
+    }
     result_t op_result = m_lidarPtr->startScan();
     if (!IS_OK(op_result)) {
         LOGE("[CYdLidar] Failed to start scan mode: %x", op_result);
@@ -361,7 +563,9 @@ bool CYdLidar::doProcessSimple(LaserScan &outscan) {
     uint64_t tim_scan_start = getTime();
     uint64_t startTs = tim_scan_start;
     //从缓存中获取已采集的一圈扫描数据
-    result_t op_result = m_lidarPtr->grabScanData(m_global_nodes, count);
+    scan_sequence sequence = {0, 0, 0};
+    result_t op_result = m_lidarPtr->grabScanData(m_global_nodes, count,
+                                                  DriverInterface::DEFAULT_TIMEOUT, &sequence);
     uint64_t tim_scan_end = getTime();
     uint64_t endTs = tim_scan_end;
     uint64_t sys_scan_time = tim_scan_end - tim_scan_start; //获取一圈数据所花费的时间
@@ -371,29 +575,127 @@ bool CYdLidar::doProcessSimple(LaserScan &outscan) {
     if (!IS_OK(op_result)) {
         return false;
     }
+    TRACE_SCOPE("Convert");
+    uint64_t convert_start = getus();
+    //滤波链在解码线程上每圈只运行一次，这里取同一份结果
+    if (!takeFiltered(sequence.seq, outscan)) {
+        buildScan(m_global_nodes, count, sequence, outscan, true);
+    }
+    m_lidarPtr->recordLatency(LatencyStageConvert, getus() - convert_start);
+    return true;
+}
+
+/*-------------------------------------------------------------
+                        getSectorIndex
+-------------------------------------------------------------*/
+bool CYdLidar::getSectorIndex(SectorIndex &index) const {
+    return m_lidarPtr && m_lidarPtr->getSectorIndex(index);
+}
+
+/*-------------------------------------------------------------
+                         doProcessRaw
+-------------------------------------------------------------*/
+bool CYdLidar::doProcessRaw(RawScan &outscan) {
+    size_t count = DriverInterface::MAX_SCAN_NODES;
+    scan_sequence sequence = {0, 0, 0};
+    result_t op_result = m_lidarPtr->grabScanData(m_global_nodes, count,
+                                                  DriverInterface::DEFAULT_TIMEOUT, &sequence);
+    outscan.points.clear();
+    if (!IS_OK(op_result)) {
+        return false;
+    }
+    TRACE_SCOPE("Convert");
+    uint64_t convert_start = getus();
+    outscan.stamp = (count && m_global_nodes[0].stamp > 0) ? m_global_nodes[0].stamp : 0;
+    outscan.seq = sequence.seq;
+    outscan.dropped = sequence.dropped;
+    //解码输出已是毫米和0.01度，直接拷贝
+    outscan.points.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        RawPoint &point = outscan.points[i];
+        point.angle = m_global_nodes[i].angle_q6_checkbit;
+        point.distance = m_global_nodes[i].distance_q2;
+        point.quality = static_cast<uint8_t>(m_global_nodes[i].sync_quality);
+        point.reserved = 0;
+    }
+    m_lidarPtr->recordLatency(LatencyStageConvert, getus() - convert_start);
+    return true;
+}
+
+/*-------------------------------------------------------------
+                      doProcessCartesian
+-------------------------------------------------------------*/
+bool CYdLidar::doProcessCartesian(CartesianScan &cloud) {
+    size_t count = DriverInterface::MAX_SCAN_NODES;
+    scan_sequence sequence = {0, 0, 0};
+    result_t op_result = m_lidarPtr->grabScanData(m_global_nodes, count,
+                                                  DriverInterface::DEFAULT_TIMEOUT, &sequence);
+    cloud.resize(0);
+    if (!IS_OK(op_result)) {
+        return false;
+    }
+    TRACE_SCOPE("Convert");
+    uint64_t convert_start = getus();
+    if (hasFilters() || m_FixedResolution) {
+        //滤波和固定分辨率的结果是LaserScan，角度可能已不在0.01度网格上
+        if (!takeFiltered(sequence.seq, m_CartesianSource)) {
+            buildScan(m_global_nodes, count, sequence, m_CartesianSource, true);
+        }
+        m_Cartesian.convert(m_CartesianSource, cloud);
+    } else {
+        //直接按整数角度查表，不经过LaserScan
+        m_Cartesian.convert(m_global_nodes, count, cloud);
+        cloud.seq = sequence.seq;
+        cloud.dropped = sequence.dropped;
+    }
+    m_lidarPtr->recordLatency(LatencyStageConvert, getus() - convert_start);
+    return true;
+}
 
+/*-------------------------------------------------------------
+                     setCartesianTransform
+-------------------------------------------------------------*/
+void CYdLidar::setCartesianTransform(float x, float y, float yaw) {
+    m_Cartesian.setTransform(x, y, yaw);
+}
+
+/*-------------------------------------------------------------
+                           buildScan
+-------------------------------------------------------------*/
+void CYdLidar::buildScan(const node_info *nodes, size_t count, const scan_sequence &sequence,
+                         LaserScan &outscan, bool fixed) {
+    outscan.points.clear();
     outscan.config.min_angle = math::from_degrees(m_MinAngle);
     outscan.config.max_angle = math::from_degrees(m_MaxAngle);
-    outscan.config.scan_time = static_cast<float>((m_global_nodes[count - 1].stamp - m_global_nodes[0].stamp)) / 1e7;//单位：s
-    outscan.config.angle_increment = math::from_degrees(m_field_of_view) / count;
-    outscan.config.time_increment = outscan.config.scan_time / count;
+    outscan.config.scan_time = count ?
+        static_cast<float>((nodes[count - 1].stamp - nodes[0].stamp)) / 1e7 : 0.f;//单位：s
+    outscan.config.angle_increment = count ? math::from_degrees(m_field_of_view) / count : 0.f;
+    outscan.config.time_increment = count ? outscan.config.scan_time / count : 0.f;
     outscan.config.min_range = m_MinRange;
     outscan.config.max_range = m_MaxRange;
 
     //模组编号
-    //outscan.moduleNum = m_global_nodes[0].index;
+    //outscan.moduleNum = nodes[0].index;
     //环境标记
-    //outscan.envFlag = m_global_nodes[0].is + (uint16_t(m_global_nodes[1].is) << 8);//环境标记（目前只针对GS2）
+    //outscan.envFlag = nodes[0].is + (uint16_t(nodes[1].is) << 8);//环境标记（目前只针对GS2）
     //将一圈中第一个点采集时间作为该圈数据采集时间
-    outscan.stamp = (m_global_nodes[0].stamp > 0) ? m_global_nodes[0].stamp : 0;
+    outscan.stamp = (count && nodes[0].stamp > 0) ? nodes[0].stamp : 0;
+    outscan.seq = sequence.seq;
+    outscan.dropped = sequence.dropped;
+
+    if (fixed && m_FixedResolution) {
+        binScan(nodes, count, outscan);
+        return;
+    }
 
     float range = 0.0;
     float intensity = 0.0;
     float angle = 0.0;
+    outscan.points.reserve(count);
     for(size_t i = 0; i < count; i++) {
-        range = static_cast<float>(m_global_nodes[i].distance_q2 / 1000.f);//单位：m
-        intensity = static_cast<float>(m_global_nodes[i].sync_quality);
-        angle = static_cast<float>(m_global_nodes[i].angle_q6_checkbit / 100.0f);//单位：度
+        range = static_cast<float>(nodes[i].distance_q2 / 1000.f);//单位：m
+        intensity = static_cast<float>(nodes[i].sync_quality);
+        angle = static_cast<float>(nodes[i].angle_q6_checkbit / 100.0f);//单位：度
         
         LaserPoint point;
         point.angle = angle;
@@ -401,7 +703,70 @@ bool CYdLidar::doProcessSimple(LaserScan &outscan) {
         point.intensity = intensity;
         outscan.points.push_back(point);
     }
-    return true;
+}
+
+/*-------------------------------------------------------------
+                            binScan
+-------------------------------------------------------------*/
+void CYdLidar::binScan(const node_info *nodes, size_t count, LaserScan &outscan) {
+    const float resolution = m_AngleResolution;
+    float fov = m_MaxAngle - m_MinAngle;
+    if (fov <= 0) {
+        fov += 360.f;
+    }
+    //整圈时首尾两格是同一个角度，只保留一个
+    const bool full = fov > 360.f - resolution / 2;
+    const size_t bins = full ? lround(360.f / resolution) : lround(fov / resolution) + 1;
+
+    outscan.config.max_angle = math::from_degrees(m_MinAngle + (bins - 1) * resolution);
+    outscan.config.angle_increment = math::from_degrees(resolution);
+    outscan.config.time_increment = outscan.config.scan_time / bins;
+
+    //以下角度单位都是0.01度，点的角度是整数，相对最小角度的偏移不需要浮点取模
+    const long first = lround(m_MinAngle * 100.0);
+    const float step = resolution * 100.f;
+
+    //分格时angle暂存点与格中心的角度差，空格为无穷大，最后统一改为格的角度；
+    //点数固定，同一个outscan重复使用时不再分配
+    LaserPoint empty;
+    empty.angle = INFINITY;
+    empty.range = 0.f;
+    empty.intensity = 0.f;
+    outscan.points.assign(bins, empty);
+
+    for (size_t i = 0; i < count; i++) {
+        long offset = (static_cast<long>(nodes[i].angle_q6_checkbit) - first) % 36000;
+        if (offset < 0) {
+            offset += 36000;
+        }
+        //最后半格属于第一格
+        if (offset > 36000 - step / 2) {
+            offset -= 36000;
+        }
+        long k = lround(offset / step);
+        float diff = fabs(offset - k * step);
+        if (full) {
+            k %= bins;
+        } else if (k >= static_cast<long>(bins)) {
+            continue;//不在最小和最大角度之间
+        }
+
+        LaserPoint &point = outscan.points[k];
+        float range = static_cast<float>(nodes[i].distance_q2 / 1000.f);//单位：m
+        bool take = diff < point.angle;
+        if (BinPolicyMin == m_BinPolicy) {
+            take = !(point.angle < INFINITY) || (range > 0 && (point.range <= 0 || range < point.range));
+        }
+        if (take) {
+            point.angle = diff;
+            point.range = range;
+            point.intensity = static_cast<float>(nodes[i].sync_quality);
+        }
+    }
+
+    for (size_t k = 0; k < bins; k++) {
+        outscan.points[k].angle = m_MinAngle + k * resolution;
+    }
 }
 
 /*-------------------------------------------------------------
@@ -450,6 +815,699 @@ map<string, string> CYdLidar::lidarPortList()
     return lstMap;
 }
 
+/*-------------------------------------------------------------
+                          getMetrics
+-------------------------------------------------------------*/
+bool CYdLidar::getMetrics(LidarMetrics &metrics) const
+{
+    memset(&metrics, 0, sizeof(LidarMetrics));
+    if (!m_lidarPtr) {
+        return false;
+    }
+    m_lidarPtr->getMetrics(metrics);
+    return true;
+}
+
+/*-------------------------------------------------------------
+                          getLatency
+-------------------------------------------------------------*/
+bool CYdLidar::getLatency(int stage, LidarLatency &stats) const
+{
+    memset(&stats, 0, sizeof(LidarLatency));
+    if (!m_lidarPtr) {
+        return false;
+    }
+    return m_lidarPtr->getLatency(stage, stats);
+}
+
+/*-------------------------------------------------------------
+                          resetLatency
+-------------------------------------------------------------*/
+void CYdLidar::resetLatency()
+{
+    if (m_lidarPtr) {
+        m_lidarPtr->resetLatency();
+    }
+}
+
+/*-------------------------------------------------------------
+                        enableShmPublisher
+-------------------------------------------------------------*/
+bool CYdLidar::enableShmPublisher(const char *name, int slots, bool takeOver)
+{
+    if (slots <= 0) {
+        return false;
+    }
+    if (m_lidarPtr && m_lidarPtr->getIsScanning()) {
+        LOGW("The shared memory ring must be enabled before turnOn");
+        return false;
+    }
+    if (!m_ShmPublisher) {
+        m_ShmPublisher = new ShmScanPublisher();
+    }
+    if (!m_ShmPublisher->open(name, slots, DriverInterface::MAX_SCAN_NODES, takeOver)) {
+        return false;
+    }
+    if (m_lidarPtr) {
+        m_lidarPtr->setShmPublisher(m_ShmPublisher);
+    }
+    return true;
+}
+
+/*-------------------------------------------------------------
+                        enableRecorder
+-------------------------------------------------------------*/
+bool CYdLidar::enableRecorder(const char *path)
+{
+    if (m_lidarPtr && m_lidarPtr->getIsScanning()) {
+        LOGW("The recorder must be enabled before turnOn");
+        return false;
+    }
+    if (!path) {
+        if (m_lidarPtr) {
+            m_lidarPtr->setRecorder(NULL);
+        }
+        if (m_Recorder) {
+            delete m_Recorder;
+            m_Recorder = NULL;
+        }
+        return true;
+    }
+    if (!m_Recorder) {
+        m_Recorder = new PcapWriter();
+    }
+    if (!m_Recorder->open(path)) {
+        LOGE("Cannot create capture file %s", path);
+        return false;
+    }
+    if (m_lidarPtr) {
+        m_lidarPtr->setRecorder(m_Recorder);
+    }
+    return true;
+}
+
+/*-------------------------------------------------------------
+                        setReplayFile
+-------------------------------------------------------------*/
+bool CYdLidar::setReplayFile(const char *path, bool realtime)
+{
+    if (m_lidarPtr) {
+        LOGW("The replay file must be set before initialize");
+        return false;
+    }
+    m_ReplayFile = path ? path : "";
+    m_ReplayRealtime = realtime;
+    return true;
+}
+
+/*-------------------------------------------------------------
+                        setScanCallback
+-------------------------------------------------------------*/
+void CYdLidar::setScanCallback(const ScanCallback &callback)
+{
+    ScopedLocker l(m_CallbackLock);
+    m_ScanCallback = callback;
+}
+
+/*-------------------------------------------------------------
+                            addZone
+-------------------------------------------------------------*/
+int CYdLidar::addZone(const vector<float> &polygon)
+{
+    //多边形在turnOn时编译进解码器
+    if (m_Zones.size() >= ZoneEvaluator::MAX_ZONES ||
+            polygon.size() < 6 || polygon.size() % 2) {
+        return -1;
+    }
+    m_Zones.push_back(polygon);
+    return static_cast<int>(m_Zones.size() - 1);
+}
+
+/*-------------------------------------------------------------
+                          clearZones
+-------------------------------------------------------------*/
+void CYdLidar::clearZones()
+{
+    m_Zones.clear();
+}
+
+/*-------------------------------------------------------------
+                        setZoneCallback
+-------------------------------------------------------------*/
+void CYdLidar::setZoneCallback(const ZoneCallback &callback)
+{
+    ScopedLocker l(m_CallbackLock);
+    m_ZoneCallback = callback;
+}
+
+/*-------------------------------------------------------------
+                        addSubscription
+-------------------------------------------------------------*/
+int CYdLidar::addSubscription(const ScanCallback &callback, const ScanDecimation &decimation)
+{
+    if (!callback) {
+        return -1;
+    }
+    switch (decimation.mode) {
+        case DecimationEveryNth:
+            if (decimation.step < 1) {
+                return -1;
+            }
+            break;
+
+        case DecimationMinBin:
+        case DecimationMeanBin:
+            if (!(decimation.resolution > 0 && decimation.resolution <= 360.f)) {
+                return -1;
+            }
+            break;
+
+        default:
+            return -1;
+    }
+
+    ScopedLocker l(m_CallbackLock);
+    Subscription subscription;
+    subscription.id = m_NextSubscription++;
+    subscription.callback = callback;
+    subscription.decimation = decimation;
+    //整体替换列表，解码线程持有的旧列表不受影响
+    std::shared_ptr<vector<Subscription> > subscriptions =
+        m_Subscriptions ? std::make_shared<vector<Subscription> >(*m_Subscriptions) :
+                          std::make_shared<vector<Subscription> >();
+    subscriptions->push_back(subscription);
+    m_Subscriptions = subscriptions;
+    return subscription.id;
+}
+
+/*-------------------------------------------------------------
+                       removeSubscription
+-------------------------------------------------------------*/
+bool CYdLidar::removeSubscription(int id)
+{
+    ScopedLocker l(m_CallbackLock);
+    if (!m_Subscriptions) {
+        return false;
+    }
+    for (size_t i = 0; i < m_Subscriptions->size(); i++) {
+        if ((*m_Subscriptions)[i].id == id) {
+            std::shared_ptr<vector<Subscription> > subscriptions =
+                std::make_shared<vector<Subscription> >(*m_Subscriptions);
+            subscriptions->erase(subscriptions->begin() + i);
+            if (subscriptions->empty()) {
+                subscriptions.reset();
+            }
+            m_Subscriptions = subscriptions;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*-------------------------------------------------------------
+                        setSectorCallback
+-------------------------------------------------------------*/
+void CYdLidar::setSectorCallback(const ScanCallback &callback)
+{
+    ScopedLocker l(m_CallbackLock);
+    m_SectorCallback = callback;
+}
+
+/*-------------------------------------------------------------
+                        setErrorCallback
+-------------------------------------------------------------*/
+void CYdLidar::setErrorCallback(const ErrorCallback &callback)
+{
+    ScopedLocker l(m_CallbackLock);
+    m_ErrorCallback = callback;
+}
+
+/*-------------------------------------------------------------
+                        setStateCallback
+-------------------------------------------------------------*/
+void CYdLidar::setStateCallback(const StateCallback &callback)
+{
+    ScopedLocker l(m_CallbackLock);
+    m_StateCallback = callback;
+}
+
+/*-------------------------------------------------------------
+                        setCallbackExecutor
+-------------------------------------------------------------*/
+bool CYdLidar::setCallbackExecutor(int threads)
+{
+    if (threads < 0 || threads > Dispatcher::MAX_THREADS) {
+        return false;
+    }
+    if (m_lidarPtr && m_lidarPtr->getIsScanning()) {
+        LOGW("The callback executor must be set before turnOn");
+        return false;
+    }
+    m_CallbackThreads = 0;
+    if (!threads) {
+        m_Dispatcher.stop();
+        return true;
+    }
+    if (!m_Dispatcher.start(threads)) {
+        LOGE("Failed to start %d callback threads", threads);
+        return false;
+    }
+    m_CallbackThreads = threads;
+    return true;
+}
+
+/*-------------------------------------------------------------
+                          addFilter
+-------------------------------------------------------------*/
+bool CYdLidar::addFilter(FilterInterface *filter)
+{
+    if (!filter) {
+        return false;
+    }
+    ScopedLocker l(m_FilterLock);
+    if (std::find(m_Filters.begin(), m_Filters.end(), filter) != m_Filters.end()) {
+        return false;
+    }
+    m_Filters.push_back(filter);
+    return true;
+}
+
+/*-------------------------------------------------------------
+                         removeFilter
+-------------------------------------------------------------*/
+bool CYdLidar::removeFilter(FilterInterface *filter)
+{
+    ScopedLocker l(m_FilterLock);
+    vector<FilterInterface *>::iterator it = std::find(m_Filters.begin(), m_Filters.end(), filter);
+    if (it == m_Filters.end()) {
+        return false;
+    }
+    m_Filters.erase(it);
+    return true;
+}
+
+/*-------------------------------------------------------------
+                       setFilterStrategy
+-------------------------------------------------------------*/
+bool CYdLidar::setFilterStrategy(int strategy)
+{
+    if (strategy < -1 || strategy > NoiseFilter::FS_TailStrong2) {
+        return false;
+    }
+    ScopedLocker l(m_FilterLock);
+    m_FilterStrategy = strategy;
+    if (strategy < 0) {
+        delete m_NoiseFilter;
+        m_NoiseFilter = NULL;
+        delete m_StreamFilter;
+        m_StreamFilter = NULL;
+        return true;
+    }
+    if (!m_NoiseFilter) {
+        m_NoiseFilter = new NoiseFilter();
+    }
+    m_NoiseFilter->setStrategy(strategy);
+    if (!m_StreamFilter) {
+        m_StreamFilter = new StreamingNoiseFilter();
+    }
+    m_StreamFilter->setStrategy(strategy);
+    return true;
+}
+
+/*-------------------------------------------------------------
+                          hasFilters
+-------------------------------------------------------------*/
+bool CYdLidar::hasFilters()
+{
+    ScopedLocker l(m_FilterLock);
+    return m_NoiseFilter || !m_Filters.empty();
+}
+
+/*-------------------------------------------------------------
+                         applyFilters
+-------------------------------------------------------------*/
+bool CYdLidar::applyFilters(LaserScan &scan)
+{
+    ScopedLocker l(m_FilterLock);
+    if (m_NoiseFilter) {
+        m_NoiseFilter->filter(scan, m_LidarType, 0, scan);
+    }
+    for (size_t i = 0; i < m_Filters.size(); i++) {
+        m_Filters[i]->filter(scan, m_LidarType, 0, scan);
+    }
+    return m_NoiseFilter || !m_Filters.empty();
+}
+
+/*-------------------------------------------------------------
+                         storeFiltered
+-------------------------------------------------------------*/
+void CYdLidar::storeFiltered(const LaserScan *scan, uint64_t seq)
+{
+    {
+        ScopedLocker l(m_FilteredLock);
+        if (seq <= m_DecodedSeq) {
+            //序号重新开始，旧的结果不能再按序号取出
+            for (size_t i = 0; i < m_FilteredScans.size(); i++) {
+                m_FilteredScans[i].seq = 0;
+            }
+        }
+        if (!m_FilteredScans.empty()) {
+            LaserScan &slot = m_FilteredScans[seq % m_FilteredScans.size()];
+            if (scan) {
+                slot = *scan;
+            } else {
+                slot.seq = 0;
+            }
+        }
+        m_DecodedSeq = seq;
+    }
+    m_FilteredEvent.set();
+}
+
+/*-------------------------------------------------------------
+                         takeFiltered
+-------------------------------------------------------------*/
+bool CYdLidar::takeFiltered(uint64_t seq, LaserScan &outscan)
+{
+    if (!hasFilters()) {
+        return false;
+    }
+    //队列先于onScan收到这一圈，等解码线程滤波完
+    uint32_t start = getms();
+    while (true) {
+        {
+            ScopedLocker l(m_FilteredLock);
+            if (m_DecodedSeq >= seq) {
+                if (m_FilteredScans.empty()) {
+                    return false;
+                }
+                LaserScan &slot = m_FilteredScans[seq % m_FilteredScans.size()];
+                if (slot.seq != seq) {
+                    return false;
+                }
+                std::swap(slot, outscan);
+                slot.seq = 0;
+                return true;
+            }
+        }
+        uint32_t elapsed = getms() - start;
+        if (elapsed >= DriverInterface::DEFAULT_TIMEOUT) {
+            return false;
+        }
+        m_FilteredEvent.wait(DriverInterface::DEFAULT_TIMEOUT - elapsed);
+    }
+}
+
+/*-------------------------------------------------------------
+                       applySectorFilter
+-------------------------------------------------------------*/
+bool CYdLidar::applySectorFilter(LaserScan &sector)
+{
+    ScopedLocker l(m_FilterLock);
+    if (!m_SectorFilter || !m_StreamFilter) {
+        return true;
+    }
+    return m_StreamFilter->push(sector, sector) > 0;
+}
+
+/*-------------------------------------------------------------
+                        dispatchScan
+-------------------------------------------------------------*/
+void CYdLidar::dispatchScan(const ScanCallback &callback, const LaserScan &scan)
+{
+    if (!m_CallbackThreads) {
+        callback(scan);
+        return;
+    }
+    std::shared_ptr<LaserScan> shared = std::make_shared<LaserScan>(scan);
+    m_Dispatcher.post([callback, shared]() {
+        callback(*shared);
+    });
+}
+
+/*-------------------------------------------------------------
+                       dispatchSector
+-------------------------------------------------------------*/
+void CYdLidar::dispatchSector(const ScanCallback &callback, const node_info *nodes, size_t count)
+{
+    //the nodes are only valid during the call, hand a converted copy to the pool
+    std::shared_ptr<LaserScan> shared;
+    LaserScan *scan = &m_InlineScan;
+    if (m_CallbackThreads) {
+        shared = std::make_shared<LaserScan>();
+        scan = shared.get();
+    }
+    //扇区只是一圈的一部分，只做流式滤波，滤波在解码线程上按顺序进行
+    scan_sequence sequence = {0, 0, 0};
+    buildScan(nodes, count, sequence, *scan, false);
+    if (!applySectorFilter(*scan)) {
+        return;
+    }
+    if (!m_CallbackThreads) {
+        callback(*scan);
+        return;
+    }
+    m_Dispatcher.post([callback, shared]() {
+        callback(*shared);
+    });
+}
+
+/*-------------------------------------------------------------
+                          decimateScan
+-------------------------------------------------------------*/
+void CYdLidar::decimateScan(const node_info *nodes, size_t count, const scan_sequence &sequence,
+                            const ScanDecimation &decimation, LaserScan &outscan)
+{
+    outscan.points.clear();
+    outscan.config.min_angle = math::from_degrees(m_MinAngle);
+    outscan.config.max_angle = math::from_degrees(m_MaxAngle);
+    outscan.config.scan_time = count ?
+        static_cast<float>((nodes[count - 1].stamp - nodes[0].stamp)) / 1e7 : 0.f;//单位：s
+    outscan.config.min_range = m_MinRange;
+    outscan.config.max_range = m_MaxRange;
+    outscan.stamp = (count && nodes[0].stamp > 0) ? nodes[0].stamp : 0;
+    outscan.seq = sequence.seq;
+    outscan.dropped = sequence.dropped;
+
+    LaserPoint point;
+    if (DecimationEveryNth == decimation.mode) {
+        const size_t step = decimation.step;
+        outscan.points.reserve(count / step + 1);
+        for (size_t i = 0; i < count; i += step) {
+            point.angle = static_cast<float>(nodes[i].angle_q6_checkbit / 100.0f);//单位：度
+            point.range = static_cast<float>(nodes[i].distance_q2 / 1000.f);//单位：m
+            point.intensity = static_cast<float>(nodes[i].sync_quality);
+            outscan.points.push_back(point);
+        }
+        outscan.config.angle_increment = count ?
+            math::from_degrees(m_field_of_view) / count * step : 0.f;
+    } else {
+        //一圈内的点按扫描顺序排列，相邻的点落在同一格或下一格，逐格累计，不需要整圈的格数组
+        const float width = decimation.resolution * 100.f;//单位：0.01度
+        const bool mean = DecimationMeanBin == decimation.mode;
+        struct Bin {
+            long index;
+            uint32_t points;
+            uint32_t valid;
+            uint32_t sum;//单位：毫米
+            uint16_t nearest;
+            uint32_t quality;
+        };
+        const Bin empty = {-1, 0, 0, 0, 0, 0};
+        Bin bin = empty;
+        //一圈从区间中间开始时首尾两段落在同一区间，第一段留到最后，与最后一段合并后输出
+        Bin head = empty;
+        auto toPoint = [&](const Bin &b) {
+            point.angle = (b.index + 0.5f) * decimation.resolution;
+            point.range = b.valid ? (mean ? b.sum / 1000.f / b.valid : b.nearest / 1000.f) : 0.f;
+            point.intensity = static_cast<float>(b.valid ? b.quality / (mean ? b.valid : 1) : 0);
+            return point;
+        };
+        outscan.points.reserve(static_cast<size_t>(36000.f / width) + 1);
+        for (size_t i = 0; i < count; i++) {
+            long k = static_cast<long>(nodes[i].angle_q6_checkbit / width);
+            if (k != bin.index) {
+                if (head.index < 0 && bin.points) {
+                    head = bin;
+                    outscan.points.push_back(point);
+                } else if (bin.points) {
+                    outscan.points.push_back(toPoint(bin));
+                }
+                bin = empty;
+                bin.index = k;
+            }
+            bin.points++;
+            uint16_t distance = nodes[i].distance_q2;
+            if (!distance) {
+                continue;
+            }
+            bin.valid++;
+            if (mean) {
+                bin.sum += distance;
+                bin.quality += nodes[i].sync_quality;
+            } else if (!bin.nearest || distance < bin.nearest) {
+                bin.nearest = distance;
+                bin.quality = nodes[i].sync_quality;
+            }
+        }
+        if (head.index < 0) {
+            if (bin.points) {
+                outscan.points.push_back(toPoint(bin));
+            }
+        } else {
+            if (bin.index == head.index) {
+                head.points += bin.points;
+                head.valid += bin.valid;
+                if (mean) {
+                    head.sum += bin.sum;
+                    head.quality += bin.quality;
+                } else if (bin.nearest && (!head.nearest || bin.nearest < head.nearest)) {
+                    head.nearest = bin.nearest;
+                    head.quality = bin.quality;
+                }
+            } else {
+                outscan.points.push_back(toPoint(bin));
+            }
+            outscan.points[0] = toPoint(head);
+        }
+        outscan.config.angle_increment = math::from_degrees(decimation.resolution);
+    }
+    outscan.config.time_increment = outscan.points.empty() ? 0.f :
+                                    outscan.config.scan_time / outscan.points.size();
+}
+
+/*-------------------------------------------------------------
+                     dispatchSubscriptions
+-------------------------------------------------------------*/
+void CYdLidar::dispatchSubscriptions(const node_info *nodes, size_t count,
+                                     const scan_sequence &sequence)
+{
+    Subscriptions subscriptions;
+    {
+        //只复制指针，列表在增删订阅时才重建
+        ScopedLocker l(m_CallbackLock);
+        subscriptions = m_Subscriptions;
+    }
+    if (!subscriptions) {
+        return;
+    }
+    for (size_t i = 0; i < subscriptions->size(); i++) {
+        const Subscription &subscription = (*subscriptions)[i];
+        if (!m_CallbackThreads) {
+            decimateScan(nodes, count, sequence, subscription.decimation, m_ReducedScan);
+            subscription.callback(m_ReducedScan);
+            continue;
+        }
+        std::shared_ptr<LaserScan> shared = std::make_shared<LaserScan>();
+        decimateScan(nodes, count, sequence, subscription.decimation, *shared);
+        ScanCallback callback = subscription.callback;
+        m_Dispatcher.post([callback, shared]() {
+            callback(*shared);
+        });
+    }
+}
+
+/*-------------------------------------------------------------
+                            onScan
+-------------------------------------------------------------*/
+void CYdLidar::onScan(const node_info *nodes, size_t count, const scan_sequence &sequence)
+{
+    ScanCallback callback;
+    {
+        ScopedLocker l(m_CallbackLock);
+        callback = m_ScanCallback;
+    }
+    //滤波链可能有状态，每圈只在解码线程上运行一次，各出口拿到同一份结果
+    bool filtered = false;
+    if (callback || m_GroupHook || hasFilters()) {
+        buildScan(nodes, count, sequence, m_DecodedScan, true);
+        filtered = applyFilters(m_DecodedScan);
+    }
+    storeFiltered(filtered ? &m_DecodedScan : NULL, sequence.seq);
+    if (callback) {
+        dispatchScan(callback, m_DecodedScan);
+    }
+    dispatchSubscriptions(nodes, count, sequence);
+    if (m_GroupHook) {
+        m_GroupHook(m_DecodedScan);
+    }
+}
+
+/*-------------------------------------------------------------
+                           onSector
+-------------------------------------------------------------*/
+void CYdLidar::onSector(const node_info *nodes, size_t count)
+{
+    ScanCallback callback;
+    {
+        ScopedLocker l(m_CallbackLock);
+        callback = m_SectorCallback;
+    }
+    if (callback) {
+        dispatchSector(callback, nodes, count);
+    }
+}
+
+/*-------------------------------------------------------------
+                            onError
+-------------------------------------------------------------*/
+void CYdLidar::onError(DriverError error)
+{
+    ErrorCallback callback;
+    {
+        ScopedLocker l(m_CallbackLock);
+        callback = m_ErrorCallback;
+    }
+    if (!callback) {
+        return;
+    }
+    if (m_CallbackThreads) {
+        m_Dispatcher.post(std::bind(callback, error));
+    } else {
+        callback(error);
+    }
+}
+
+/*-------------------------------------------------------------
+                        onStateChanged
+-------------------------------------------------------------*/
+void CYdLidar::onStateChanged(LidarState state)
+{
+    StateCallback callback;
+    {
+        ScopedLocker l(m_CallbackLock);
+        callback = m_StateCallback;
+    }
+    if (!callback) {
+        return;
+    }
+    if (m_CallbackThreads) {
+        m_Dispatcher.post(std::bind(callback, state));
+    } else {
+        callback(state);
+    }
+}
+
+/*-------------------------------------------------------------
+                        onZoneViolation
+-------------------------------------------------------------*/
+void CYdLidar::onZoneViolation(const ZoneEvent &event)
+{
+    ZoneCallback callback;
+    {
+        ScopedLocker l(m_CallbackLock);
+        callback = m_ZoneCallback;
+    }
+    if (!callback) {
+        return;
+    }
+    if (m_CallbackThreads) {
+        m_Dispatcher.post(std::bind(callback, event));
+    } else {
+        callback(event);
+    }
+}
+
 namespace ydlidar{
     
 void os_init() {
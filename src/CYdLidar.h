@@ -3,18 +3,35 @@
 #include <core/base/utils.h>
 #include <core/common/ydlidar_def.h>
 #include <core/common/DriverInterface.h>
+#include <core/common/Dispatcher.h>
+#include <core/common/CartesianScan.h>
 #include <string>
 #include <map>
+#include <vector>
+#include <functional>
+#include <memory>
 
 using namespace std;
 using namespace ydlidar;
 using namespace ydlidar::core;
 using namespace ydlidar::core::common;
 
-class YDLIDAR_API CYdLidar {
+class FilterInterface;
+class StreamingNoiseFilter;
+class CYdLidarGroup;
+
+class YDLIDAR_API CYdLidar : protected DriverListener {
+    public:
+        typedef std::function<void(const LaserScan &)> ScanCallback;   ///< scan or sector callback
+        typedef std::function<void(DriverError)> ErrorCallback;        ///< error callback
+        typedef std::function<void(LidarState)> StateCallback;         ///< state change callback
+        typedef std::function<void(const ZoneEvent &)> ZoneCallback;   ///< zone violation callback
+
     private:
         DriverInterface *m_lidarPtr;      ///< LiDAR Driver Interface pointer
         string m_SerialPort;              ///< LiDAR serial port or network ip
+        string m_IgnoreString;            ///< ignored sectors as set
+        vector<float> m_IgnoreArray;      ///< ignored sectors, start and end angle pairs
         int m_SerialBaudrate;             ///< LiDAR serial baudrate or network port
         int m_LidarType;                  ///< LiDAR type
         int m_lidar_model;                ///< LiDAR Model
@@ -25,7 +42,56 @@ class YDLIDAR_API CYdLidar {
         float m_MinRange;                 ///< LiDAR minimum range
         float m_field_of_view;            ///< LiDAR Field of View Angle.
         float m_ScanFrequency;            ///< LiDAR scanning frequency
+        bool m_FixedResolution;           ///< bin complete scans on a fixed angle grid
+        float m_AngleResolution;          ///< grid step in degrees
+        int m_BinPolicy;                  ///< point kept in a bin, see ::BinPolicy
+        bool m_Reversion;                 ///< mounted facing backwards
+        bool m_Inverted;                  ///< mounted upside down
+        float m_AngleOffset;              ///< zero angle offset in degrees
+        float m_SectorWidth;              ///< nearest return index sector width, 0 disables it
+        int m_ScanQueueDepth;             ///< number of scans kept for the consumer
+        int m_ScanQueuePolicy;            ///< scan queue policy
         node_info *m_global_nodes;  
+        ShmScanPublisher *m_ShmPublisher; ///< shared memory scan ring
+        PcapWriter *m_Recorder;           ///< raw traffic capture
+        string m_ReplayFile;              ///< capture replayed instead of the network
+        bool m_ReplayRealtime;            ///< replay at the recorded pace
+        ScanCallback m_ScanCallback;      ///< complete scan callback
+        struct Subscription {
+            int id;
+            ScanCallback callback;
+            ScanDecimation decimation;
+        };
+        typedef std::shared_ptr<const vector<Subscription> > Subscriptions;
+        Subscriptions m_Subscriptions;    ///< reduced scan callbacks, replaced on every change
+        int m_NextSubscription;           ///< id of the next subscription
+        ScanCallback m_SectorCallback;    ///< data frame callback
+        ErrorCallback m_ErrorCallback;    ///< driver error callback
+        ZoneCallback m_ZoneCallback;      ///< zone violation callback
+        vector<vector<float> > m_Zones;   ///< protective zone polygons
+        StateCallback m_StateCallback;    ///< driver state callback
+        Locker m_CallbackLock;            ///< guards the callbacks
+        int m_CallbackThreads;            ///< callback workers, 0 runs callbacks inline
+        Dispatcher m_Dispatcher;          ///< callback workers
+        LaserScan m_InlineScan;           ///< sector handed to inline sector callbacks
+        LaserScan m_ReducedScan;          ///< reduced scan handed to inline subscriptions
+        LaserScan m_CartesianSource;      ///< polar scan converted by ::doProcessCartesian
+        CartesianConverter m_Cartesian;   ///< polar to Cartesian conversion
+        int m_FilterStrategy;             ///< NoiseFilter strategy, -1 disables it
+        FilterInterface *m_NoiseFilter;   ///< built-in filter, first in the chain
+        vector<FilterInterface *> m_Filters; ///< filters added by the user
+        Locker m_FilterLock;              ///< guards the filter chain
+        bool m_SectorFilter;              ///< filter the sectors handed to the sector callback
+        StreamingNoiseFilter *m_StreamFilter; ///< NoiseFilter strategy run on the sector stream
+        bool m_SharedData;                ///< data port shared through a ::CYdLidarGroup
+        ScanCallback m_GroupHook;         ///< complete scans handed to the group
+        LaserScan m_DecodedScan;          ///< scan built and filtered once per revolution on the decode thread
+        vector<LaserScan> m_FilteredScans;///< filtered scans waiting for ::doProcessSimple, by seq modulo the size
+        uint64_t m_DecodedSeq;            ///< seq of the last scan through ::onScan
+        Locker m_FilteredLock;            ///< guards m_FilteredScans and m_DecodedSeq
+        Event m_FilteredEvent;            ///< a scan went through ::onScan
+
+        friend class CYdLidarGroup;
 
     public:
         /**
@@ -89,6 +155,45 @@ class YDLIDAR_API CYdLidar {
          */
         bool doProcessSimple(LaserScan &outscan);
 
+        /**
+         * @brief Get the nearest return of every sector of the last complete
+         * scan, indexed while the scan was assembled, see ::LidarPropSectorWidth.
+         * Copy it once per scan, its queries then run in constant time.
+         * @param[out] index               sector index, SectorIndex::seq matches
+         *  LaserScan::seq of the scan
+         * @return false if the index is disabled or no scan is complete yet.
+         */
+        bool getSectorIndex(SectorIndex &index) const;
+
+        /**
+         * @brief Get the next scan in integer units, without float conversion.
+         * Filters and ::LidarPropFixedResolution are not applied.
+         * @param[out] outscan             millimeters, 0.01 degree and quality
+         * @return true if successfully started, otherwise false.
+         */
+        bool doProcessRaw(RawScan &outscan);
+
+        /**
+         * @brief Get the next scan as Cartesian points, the same scan
+         * ::doProcessSimple would return, filters included, then converted
+         * with the transform set by ::setCartesianTransform.
+         * Without filters and fixed resolution the decoded nodes are
+         * converted directly, with no LaserScan in between.
+         * @param[out] cloud               x and y in meters, NaN for invalid points
+         * @return true if successfully started, otherwise false.
+         */
+        bool doProcessCartesian(CartesianScan &cloud);
+
+        /**
+         * @brief Set the pose of the lidar in the frame of ::doProcessCartesian
+         * @param x              meters
+         * @param y              meters
+         * @param yaw            degrees, counterclockwise
+         * @note Changing the yaw rebuilds a table, call it from the thread
+         * calling ::doProcessCartesian, or before turnOn.
+         */
+        void setCartesianTransform(float x, float y, float yaw);
+
         /**
          * @brief Uninitialize the SDK and Disconnect the LiDAR.
          */
@@ -112,6 +217,249 @@ class YDLIDAR_API CYdLidar {
          * @return online lidars
          */
         map<string, string> lidarPortList();
+
+        /**
+         * @brief Get a snapshot of the data path metrics
+         * @param[out] metrics   counters and gauges
+         * @return true if the lidar has been initialized, otherwise false.
+         * @note Lock-free, cheap enough to poll at 100 Hz.
+         */
+        bool getMetrics(LidarMetrics &metrics) const;
+
+        /**
+         * @brief Get the latency percentiles of one data path stage
+         * @param stage          ::LatencyStage
+         * @param[out] stats     sample count, p50/p99/p999 and max in microseconds
+         * @return true if the lidar has been initialized and the stage is valid.
+         */
+        bool getLatency(int stage, LidarLatency &stats) const;
+
+        /**
+         * @brief Clear the latency histograms of all stages
+         */
+        void resetLatency();
+
+        /**
+         * @brief Publish every scan into a POSIX shared memory ring,
+         * so that other local processes can map them with ::ShmScanReader.
+         * @param name           shared memory name, e.g. "/ydlidar_scan"
+         * @param slots          number of most recent scans kept
+         * @param takeOver       replace an existing ring of the same name,
+         *  e.g. left by a crashed process
+         * @return true if the ring is created, otherwise false, also when
+         *  the name is in use and takeOver is false.
+         * @note call before turnOn.
+         */
+        bool enableShmPublisher(const char *name, int slots = ShmScanPublisher::DEFAULT_SLOTS,
+                                bool takeOver = false);
+
+        /**
+         * @brief Record the raw data port datagrams, with their kernel receive
+         * time, and the command traffic into a pcap file.
+         * @param path           capture file, truncated; NULL stops recording
+         * @return true if the file is created, otherwise false.
+         * @note call before turnOn.
+         */
+        bool enableRecorder(const char *path);
+
+        /**
+         * @brief Decode a capture file instead of connecting to the lidar
+         * @param path           pcap file written by ::enableRecorder or tcpdump,
+         *  NULL or empty to use the network again
+         * @param realtime       keep the recorded pace, otherwise replay as
+         *  fast as the decoder runs
+         * @return false if the lidar is already initialized.
+         * @note call before initialize.
+         */
+        bool setReplayFile(const char *path, bool realtime = true);
+
+        /**
+         * @brief Set the callback called with every complete scan,
+         * scans are still queued for ::doProcessSimple.
+         * @param callback       scan callback, empty to disable
+         */
+        void setScanCallback(const ScanCallback &callback);
+
+        /**
+         * @brief Add a callback called with a reduced copy of every complete
+         * scan, built from the decoded points on the decode thread, for
+         * consumers that need far fewer points than the lidar produces.
+         * Reduced scans are not filtered nor binned on the fixed resolution
+         * grid, bins hold range 0 if none of their points is valid.
+         * Several subscriptions may be added, each with its own reduction.
+         * @param callback       reduced scan callback
+         * @param decimation     ::DecimationMode and its parameter
+         * @return subscription id, -1 if the callback is empty or the
+         * decimation is invalid.
+         */
+        int addSubscription(const ScanCallback &callback, const ScanDecimation &decimation);
+
+        /**
+         * @brief Remove a subscription added by ::addSubscription
+         * @param id             subscription id
+         * @return false if there is no such subscription.
+         */
+        bool removeSubscription(int id);
+
+        /**
+         * @brief Set the callback called with every decoded data frame,
+         * a partial scan of at most 192 points.
+         * With ::LidarPropSectorFilter and a ::LidarPropFilterStrategy the
+         * points are filtered as a stream and handed over a few points late,
+         * so a sector may hold points of the previous frame, or none at all
+         * and the callback is skipped.
+         * @param callback       sector callback, empty to disable
+         */
+        void setSectorCallback(const ScanCallback &callback);
+
+        /**
+         * @brief Set the callback called when the driver reports an error.
+         * @param callback       error callback, empty to disable
+         */
+        void setErrorCallback(const ErrorCallback &callback);
+
+        /**
+         * @brief Set the callback called when the driver state changes.
+         * @param callback       state callback, empty to disable
+         */
+        void setStateCallback(const StateCallback &callback);
+
+        /**
+         * @brief Add a protective zone. Every decoded point is tested against
+         * the zones, and each data frame with points inside a zone raises one
+         * event per zone, a data frame being about a tenth of a revolution.
+         * Only points kept by the angle window, range limits and ignored
+         * sectors are tested.
+         * @param polygon        x, y vertex pairs in meters, at least three
+         *  vertices, x = range * cos(angle), y = range * sin(angle) with the
+         *  angles of the scans
+         * @return zone index reported in ZoneEvent::zone, -1 if the polygon is
+         * invalid or ZoneEvaluator::MAX_ZONES zones are set.
+         * @note call before turnOn.
+         */
+        int addZone(const vector<float> &polygon);
+
+        /**
+         * @brief Remove every zone
+         * @note call before turnOn.
+         */
+        void clearZones();
+
+        /**
+         * @brief Set the callback called when points fall inside a zone
+         * @param callback       zone callback, empty to disable
+         */
+        void setZoneCallback(const ZoneCallback &callback);
+
+        /**
+         * @brief Select where the callbacks run.
+         * @param threads        0 runs the callbacks inline on the decode thread,
+         *  otherwise on a pool of threads workers. Use one worker to keep the
+         *  callbacks in order.
+         * @return true if the executor is set, otherwise false.
+         * @note Inline callbacks delay decoding and must return quickly.
+         * Call before turnOn, and never from a callback.
+         */
+        bool setCallbackExecutor(int threads);
+
+        /**
+         * @brief Append a filter to the chain run on every complete scan,
+         * after the NoiseFilter selected by ::LidarPropFilterStrategy.
+         * The chain runs once per revolution on the decode thread, the scan
+         * returned by ::doProcessSimple, the one handed to the scan callback
+         * and the one matched by a ::CYdLidarGroup are the same filtered
+         * scan, so stateful filters see every revolution exactly once.
+         * Angles are in degrees.
+         * @param filter         filter, the caller keeps the ownership
+         * @return false if filter is NULL or already in the chain.
+         */
+        bool addFilter(FilterInterface *filter);
+
+        /**
+         * @brief Remove a filter added by ::addFilter
+         * @param filter         filter to remove
+         * @return false if the filter is not in the chain.
+         */
+        bool removeFilter(FilterInterface *filter);
+
+    protected:
+        virtual void onScan(const node_info *nodes, size_t count, const scan_sequence &sequence);
+        virtual void onSector(const node_info *nodes, size_t count);
+        virtual void onError(DriverError error);
+        virtual void onStateChanged(LidarState state);
+        virtual void onZoneViolation(const ZoneEvent &event);
+
+        /**
+         * @brief Convert driver nodes to a LaserScan
+         * @param fixed          bin on the ::LidarPropFixedResolution grid if enabled,
+         *  false for sectors
+         */
+        void buildScan(const node_info *nodes, size_t count, const scan_sequence &sequence,
+                       LaserScan &outscan, bool fixed);
+
+        /**
+         * @brief Bin driver nodes on the fixed resolution grid, one point
+         * per bin from ::m_MinAngle to ::m_MaxAngle, range 0 if a bin is empty
+         */
+        void binScan(const node_info *nodes, size_t count, LaserScan &outscan);
+
+        /**
+         * @brief Reduce driver nodes to a LaserScan for a subscription
+         */
+        void decimateScan(const node_info *nodes, size_t count, const scan_sequence &sequence,
+                          const ScanDecimation &decimation, LaserScan &outscan);
+
+    private:
+        /**
+         * @brief Build and hand the reduced scans to the subscriptions
+         */
+        void dispatchSubscriptions(const node_info *nodes, size_t count,
+                                   const scan_sequence &sequence);
+
+        /**
+         * @brief Run the scan callback on the configured executor
+         */
+        void dispatchScan(const ScanCallback &callback, const LaserScan &scan);
+
+        /**
+         * @brief Filter a sector and run the sector callback on the
+         * configured executor
+         */
+        void dispatchSector(const ScanCallback &callback, const node_info *nodes, size_t count);
+
+        /**
+         * @brief Whether the filter chain of complete scans is empty
+         */
+        bool hasFilters();
+
+        /**
+         * @brief Run the filter chain in place on a complete scan
+         * @return false if the chain is empty.
+         */
+        bool applyFilters(LaserScan &scan);
+
+        /**
+         * @brief Keep the filtered scan of a revolution for ::doProcessSimple
+         * @param scan           NULL if the revolution was not filtered
+         */
+        void storeFiltered(const LaserScan *scan, uint64_t seq);
+
+        /**
+         * @brief Take the scan of a revolution filtered on the decode thread
+         * @return false if the chain is empty or the revolution was not filtered.
+         */
+        bool takeFiltered(uint64_t seq, LaserScan &outscan);
+
+        /**
+         * @brief Run the streaming NoiseFilter in place on a sector
+         * @return false if no point left the filter window.
+         */
+        bool applySectorFilter(LaserScan &sector);
+
+        /**
+         * @brief Select the NoiseFilter strategy, -1 removes the filter
+         */
+        bool setFilterStrategy(int strategy);
 };	// End of class
 #endif // CYDLIDAR_H
 
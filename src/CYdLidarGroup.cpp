@@ -0,0 +1,408 @@
+#include <algorithm>
+#include "CYdLidarGroup.h"
+#include "DataReactor.h"
+#include "core/serial/common.h"
+#include "core/common/ydlidar_help.h"
+#include "core/common/Trace.h"
+
+/*-------------------------------------------------------------
+                          CYdLidarGroup
+-------------------------------------------------------------*/
+CYdLidarGroup::CYdLidarGroup() {
+    m_Reactor = new ydlidar::DataReactor();
+    m_DataPort = 8000;
+    m_Tolerance = 0;
+    m_LastSetTaken = true;
+    m_Sets = 0;
+    m_Dropped = 0;
+}
+
+/*-------------------------------------------------------------
+                         ~CYdLidarGroup
+-------------------------------------------------------------*/
+CYdLidarGroup::~CYdLidarGroup() {
+    disconnecting();
+    for (size_t i = 0; i < m_Members.size(); i++) {
+        delete m_Members[i]->lidar;
+        delete m_Members[i];
+    }
+    m_Members.clear();
+    if (m_Reactor) {
+        delete m_Reactor;
+        m_Reactor = NULL;
+    }
+}
+
+/*-------------------------------------------------------------
+                            addLidar
+-------------------------------------------------------------*/
+CYdLidar *CYdLidarGroup::addLidar(const char *ip) {
+    if (!ip || inet_addr(ip) == INADDR_NONE) {
+        return NULL;
+    }
+    for (size_t i = 0; i < m_Members.size(); i++) {
+        if (m_Members[i]->lidar->m_lidarPtr || m_Members[i]->lidar->m_SerialPort == ip) {
+            return NULL;
+        }
+    }
+    Member *member = new Member();
+    member->owner = this;
+    member->index = m_Members.size();
+    member->lidar = new CYdLidar();
+    member->lidar->m_SerialPort = ip;
+    member->lidar->m_SharedData = true;
+    member->lastStamp = 0;
+    member->period = 0;
+    member->ok = false;
+    m_Members.push_back(member);
+    return member->lidar;
+}
+
+/*-------------------------------------------------------------
+                             lidar
+-------------------------------------------------------------*/
+CYdLidar *CYdLidarGroup::lidar(size_t member) const {
+    return member < m_Members.size() ? m_Members[member]->lidar : NULL;
+}
+
+/*-------------------------------------------------------------
+                          setDataPort
+-------------------------------------------------------------*/
+void CYdLidarGroup::setDataPort(int port) {
+    m_DataPort = port;
+}
+
+/*-------------------------------------------------------------
+                          setTolerance
+-------------------------------------------------------------*/
+void CYdLidarGroup::setTolerance(uint64_t tolerance) {
+    m_Tolerance = tolerance;
+}
+
+/*-------------------------------------------------------------
+                           initialize
+-------------------------------------------------------------*/
+_size_t THREAD_PROC CYdLidarGroup::initializeProc(void *param) {
+    Member *member = static_cast<Member *>(param);
+    member->ok = member->lidar->initialize();
+    member->finished.set();
+    return 0;
+}
+
+bool CYdLidarGroup::initialize() {
+    if (m_Members.empty()) {
+        return false;
+    }
+    uint32_t t = getms();
+    //各雷达的连接互不相关，TCP连接超时并行等待
+    for (size_t i = 0; i < m_Members.size(); i++) {
+        m_Members[i]->ok = false;
+        m_Members[i]->finished.set(false);
+        m_Members[i]->thread = Thread::createThread(initializeProc, m_Members[i]);
+    }
+    bool ret = true;
+    for (size_t i = 0; i < m_Members.size(); i++) {
+        if (m_Members[i]->thread.getHandle() == 0) {
+            initializeProc(m_Members[i]);
+        } else {
+            //Thread::join会取消线程，先等它自行结束
+            m_Members[i]->finished.wait();
+            m_Members[i]->thread.join();
+        }
+        if (!m_Members[i]->ok) {
+            LOGE("initializing lidar %s fail.", m_Members[i]->lidar->m_SerialPort.c_str());
+            ret = false;
+        }
+    }
+    LOGD("LiDAR group init %s, Elapsed time== %u ms", ret ? "success" : "fail", getms() - t);
+    return ret;
+}
+
+/*-------------------------------------------------------------
+                             turnOn
+-------------------------------------------------------------*/
+bool CYdLidarGroup::turnOn() {
+    if (m_Reactor->isRunning()) {
+        LOGD("The radar group is scanning.");
+        return true;
+    }
+    resetMatching();
+
+    m_Reactor->clear();
+    bool ret = !m_Members.empty();
+    for (size_t i = 0; ret && i < m_Members.size(); i++) {
+        CYdLidar *lidar = m_Members[i]->lidar;
+        lidar->m_GroupHook = std::bind(&CYdLidarGroup::onMemberScan, this, i,
+                                       std::placeholders::_1);
+        ret = lidar->turnOn() &&
+              m_Reactor->addDriver(lidar->m_SerialPort.c_str(), lidar->m_lidarPtr);
+    }
+    //所有雷达都已开始测量后再开始接收
+    if (ret && !m_Reactor->start(static_cast<uint16_t>(m_DataPort))) {
+        ret = false;
+    }
+    if (!ret) {
+        LOGE("[CYdLidarGroup] Failed to start scan mode");
+        turnOff();
+        return false;
+    }
+    LOGD("Successful radar group activation.");
+    return true;
+}
+
+/*-------------------------------------------------------------
+                          resetMatching
+-------------------------------------------------------------*/
+void CYdLidarGroup::resetMatching() {
+    m_Set.scans.assign(m_Members.size(), LaserScan());
+    m_Set.stamp_skew.assign(m_Members.size(), 0);
+    m_Set.arrival_skew.assign(m_Members.size(), 0);
+    m_Sets = 0;
+    {
+        ScopedLocker l(m_SetLock);
+        m_LastSetTaken = true;
+        m_Dropped = 0;
+    }
+    for (size_t i = 0; i < m_Members.size(); i++) {
+        Member *member = m_Members[i];
+        member->pending.clear();
+        member->lastStamp = 0;
+        member->period = 0;
+    }
+}
+
+/*-------------------------------------------------------------
+                             turnOff
+-------------------------------------------------------------*/
+bool CYdLidarGroup::turnOff() {
+    m_Reactor->stop();
+    bool ret = true;
+    for (size_t i = 0; i < m_Members.size(); i++) {
+        CYdLidar *lidar = m_Members[i]->lidar;
+        if (lidar->m_lidarPtr && !lidar->turnOff()) {
+            ret = false;
+        }
+        lidar->m_GroupHook = CYdLidar::ScanCallback();
+    }
+    m_SetEvent.set();
+    return ret;
+}
+
+/*-------------------------------------------------------------
+                          disconnecting
+-------------------------------------------------------------*/
+void CYdLidarGroup::disconnecting() {
+    turnOff();
+    for (size_t i = 0; i < m_Members.size(); i++) {
+        m_Members[i]->lidar->disconnecting();
+    }
+}
+
+/*-------------------------------------------------------------
+                         doProcessSimple
+-------------------------------------------------------------*/
+bool CYdLidarGroup::doProcessSimple(ScanSet &set, uint32_t timeout) {
+    uint32_t start = getms();
+    while (true) {
+        {
+            ScopedLocker l(m_SetLock);
+            if (!m_LastSetTaken) {
+                set = m_LastSet;
+                m_LastSetTaken = true;
+                return true;
+            }
+        }
+        uint32_t elapsed = getms() - start;
+        if (elapsed >= timeout || !m_Reactor->isRunning()) {
+            return false;
+        }
+        m_SetEvent.wait(timeout - elapsed);
+    }
+}
+
+/*-------------------------------------------------------------
+                         doProcessCloud
+-------------------------------------------------------------*/
+bool CYdLidarGroup::doProcessCloud(FusedCloud &cloud, uint32_t timeout) {
+    if (!doProcessSimple(m_CloudSet, timeout)) {
+        return false;
+    }
+    fuse(m_CloudSet, cloud);
+    return true;
+}
+
+/*-------------------------------------------------------------
+                              fuse
+-------------------------------------------------------------*/
+void CYdLidarGroup::fuse(const ScanSet &set, FusedCloud &cloud) {
+    TRACE_SCOPE("FuseCloud");
+    m_Fusion.fuse(set, cloud);
+}
+
+/*-------------------------------------------------------------
+                          setExtrinsics
+-------------------------------------------------------------*/
+bool CYdLidarGroup::setExtrinsics(size_t member, float x, float y, float yaw) {
+    if (member >= m_Members.size()) {
+        return false;
+    }
+    return m_Fusion.setExtrinsics(member, x, y, yaw);
+}
+
+/*-------------------------------------------------------------
+                        setDeduplication
+-------------------------------------------------------------*/
+bool CYdLidarGroup::setDeduplication(float angleStep, float rangeStep, float maxRange) {
+    return m_Fusion.setDeduplication(angleStep, rangeStep, maxRange);
+}
+
+/*-------------------------------------------------------------
+                         setSetCallback
+-------------------------------------------------------------*/
+void CYdLidarGroup::setSetCallback(const SetCallback &callback) {
+    ScopedLocker l(m_SetLock);
+    m_SetCallback = callback;
+}
+
+/*-------------------------------------------------------------
+                             getSkew
+-------------------------------------------------------------*/
+bool CYdLidarGroup::getSkew(size_t member, LidarLatency &stats) const {
+    memset(&stats, 0, sizeof(LidarLatency));
+    if (member >= m_Members.size()) {
+        return false;
+    }
+    m_Members[member]->skew.snapshot(stats);
+    return true;
+}
+
+/*-------------------------------------------------------------
+                            resetSkew
+-------------------------------------------------------------*/
+void CYdLidarGroup::resetSkew() {
+    for (size_t i = 0; i < m_Members.size(); i++) {
+        m_Members[i]->skew.reset();
+    }
+}
+
+/*-------------------------------------------------------------
+                          onMemberScan
+-------------------------------------------------------------*/
+void CYdLidarGroup::onMemberScan(size_t index, const LaserScan &scan) {
+    Member *member = m_Members[index];
+    if (!scan.stamp) {
+        return;//没有点的扫描无法匹配
+    }
+    //扫描周期按设备时间戳平滑估计，用于自动容差
+    if (member->lastStamp && scan.stamp > member->lastStamp) {
+        uint64_t period = scan.stamp - member->lastStamp;
+        member->period = member->period ? (member->period * 7 + period) / 8 : period;
+    }
+    member->lastStamp = scan.stamp;
+
+    if (member->pending.size() >= MATCH_DEPTH) {
+        member->pending.pop_front();
+    }
+    member->pending.push_back(Pending());
+    member->pending.back().scan = scan;
+    member->pending.back().arrival = getus();
+    if (matchSet(member)) {
+        publishSet();
+    }
+}
+
+/*-------------------------------------------------------------
+                            tolerance
+-------------------------------------------------------------*/
+uint64_t CYdLidarGroup::tolerance() const {
+    if (m_Tolerance) {
+        return m_Tolerance;
+    }
+    uint64_t period = 0;
+    for (size_t i = 0; i < m_Members.size(); i++) {
+        if (!m_Members[i]->period) {
+            return 0;
+        }
+        if (!period || m_Members[i]->period < period) {
+            period = m_Members[i]->period;
+        }
+    }
+    return period / 2;
+}
+
+/*-------------------------------------------------------------
+                            matchSet
+-------------------------------------------------------------*/
+bool CYdLidarGroup::matchSet(Member *anchor) {
+    const uint64_t limit = tolerance();
+    if (!limit) {
+        return false;
+    }
+    //新扫描只可能与其他雷达已到的扫描组成一组，各取时间戳最近的一圈
+    const uint64_t stamp = anchor->pending.back().scan.stamp;
+    vector<size_t> picks(m_Members.size(), 0);
+    for (size_t i = 0; i < m_Members.size(); i++) {
+        const std::deque<Pending> &pending = m_Members[i]->pending;
+        uint64_t best = UINT64_MAX;
+        for (size_t j = 0; j < pending.size(); j++) {
+            uint64_t s = pending[j].scan.stamp;
+            uint64_t diff = s > stamp ? s - stamp : stamp - s;
+            if (diff < best) {
+                best = diff;
+                picks[i] = j;
+            }
+        }
+        if (best > limit) {
+            return false;
+        }
+    }
+
+    uint64_t first = UINT64_MAX;
+    uint64_t earliest = UINT64_MAX;
+    for (size_t i = 0; i < m_Members.size(); i++) {
+        const Pending &p = m_Members[i]->pending[picks[i]];
+        first = std::min(first, p.scan.stamp);
+        earliest = std::min(earliest, p.arrival);
+    }
+    m_Set.stamp = first;
+    for (size_t i = 0; i < m_Members.size(); i++) {
+        Member *member = m_Members[i];
+        Pending &p = member->pending[picks[i]];
+        std::swap(m_Set.scans[i], p.scan);
+        m_Set.stamp_skew[i] = static_cast<int64_t>(m_Set.scans[i].stamp - first);
+        m_Set.arrival_skew[i] = static_cast<int64_t>(p.arrival - earliest);
+        member->skew.record(p.arrival - earliest);
+        //更早的扫描已无法再组成一组
+        member->pending.erase(member->pending.begin(), member->pending.begin() + picks[i] + 1);
+    }
+    return true;
+}
+
+/*-------------------------------------------------------------
+                           publishSet
+-------------------------------------------------------------*/
+void CYdLidarGroup::publishSet() {
+    TRACE_SCOPE("PublishSet");
+    SetCallback callback;
+    {
+        ScopedLocker l(m_SetLock);
+        if (!m_LastSetTaken) {
+            m_Dropped++;
+        }
+        m_Set.seq = ++m_Sets;
+        m_Set.dropped = m_Dropped;
+        std::swap(m_LastSet, m_Set);
+        m_LastSetTaken = false;
+        callback = m_SetCallback;
+    }
+    m_SetEvent.set();
+    //m_LastSet只在本线程修改，回调期间doProcessSimple可以同时复制
+    if (callback) {
+        callback(m_LastSet);
+    }
+    if (m_Set.scans.size() != m_Members.size()) {
+        m_Set.scans.assign(m_Members.size(), LaserScan());
+        m_Set.stamp_skew.assign(m_Members.size(), 0);
+        m_Set.arrival_skew.assign(m_Members.size(), 0);
+    }
+}
@@ -0,0 +1,232 @@
+#ifndef CYDLIDARGROUP_H
+#define CYDLIDARGROUP_H
+#include "CYdLidar.h"
+#include <core/common/LatencyHistogram.h>
+#include <core/common/CloudFusion.h>
+#include <deque>
+
+namespace ydlidar {
+class DataReactor;
+}
+
+/**
+ * @brief Several TEA lidars served by one data port socket and one thread.
+ * Every lidar is a ::CYdLidar configured as usual through ::lidar, but its
+ * datagrams are received and decoded by the shared reactor of the group
+ * instead of a thread of its own. Complete scans are matched across the
+ * lidars by device time stamp and published as a ::ScanSet.
+ * Auto reconnection and capture replay are not available in a group, a
+ * lidar that stops sending reports ::TimeoutError and the group waits for it.
+ */
+class YDLIDAR_API CYdLidarGroup {
+    public:
+        typedef std::function<void(const ScanSet &)> SetCallback;     ///< scan set callback
+
+        enum {
+            MATCH_DEPTH = 4,    /**< unmatched scans kept per lidar. */
+        };
+
+    private:
+        struct Pending {
+            LaserScan scan;
+            uint64_t arrival;           ///< getus() when the scan was assembled
+        };
+        struct Member {
+            CYdLidarGroup *owner;
+            size_t index;
+            CYdLidar *lidar;
+            string ip;
+            std::deque<Pending> pending;///< unmatched scans, oldest first
+            uint64_t lastStamp;         ///< stamp of the last scan
+            uint64_t period;            ///< smoothed stamp difference of consecutive scans, 0 until known
+            LatencyHistogram skew;      ///< arrival skew in scan sets
+            Thread thread;              ///< parallel initialize
+            Event finished;             ///< the initialize thread has left
+            bool ok;                    ///< result of the parallel initialize
+        };
+
+        vector<Member *> m_Members;
+        ydlidar::DataReactor *m_Reactor;  ///< shared data port and thread
+        int m_DataPort;                   ///< host port the lidars send to
+        uint64_t m_Tolerance;             ///< largest stamp difference in a set, 0 for half a scan period
+        ScanSet m_Set;                    ///< set being matched
+        ScanSet m_LastSet;                ///< last complete set, for ::doProcessSimple
+        bool m_LastSetTaken;              ///< m_LastSet has been returned
+        uint64_t m_Sets;                  ///< sets published
+        uint64_t m_Dropped;               ///< sets not returned by ::doProcessSimple
+        Event m_SetEvent;                 ///< a set is published
+        Locker m_SetLock;                 ///< guards m_LastSet and the callback
+        SetCallback m_SetCallback;        ///< set callback
+        CloudFusion m_Fusion;             ///< extrinsics and deduplication of ::doProcessCloud
+        ScanSet m_CloudSet;               ///< set fused by ::doProcessCloud
+
+    public:
+        /**
+         * @brief create object
+         */
+        CYdLidarGroup();
+
+        /**
+         * @brief destroy object, the lidars are disconnected and deleted
+         */
+        virtual ~CYdLidarGroup();
+
+        /**
+         * @brief Add a lidar to the group
+         * @param ip             lidar address, the sender address of its data
+         * @return the lidar, owned by the group, to set its properties and
+         *  callbacks; NULL if the address is invalid or already in the group,
+         *  or the group is initialized.
+         */
+        CYdLidar *addLidar(const char *ip);
+
+        /**
+         * @brief Number of lidars
+         */
+        size_t size() const {
+            return m_Members.size();
+        }
+
+        /**
+         * @brief Get a lidar of the group
+         * @param member         index, in the order the lidars were added
+         * @return NULL if out of range.
+         */
+        CYdLidar *lidar(size_t member) const;
+
+        /**
+         * @brief Set the host port all the lidars send their data to
+         * @param port           UDP port, 8000 by default
+         * @note call before turnOn.
+         */
+        void setDataPort(int port);
+
+        /**
+         * @brief Set the largest stamp difference between the scans of a set
+         * @param tolerance      in LaserScan::stamp units, 0 for half the
+         *  shortest scan period measured from the stamps
+         */
+        void setTolerance(uint64_t tolerance);
+
+        /**
+         * @brief Initialize and connect every lidar, in parallel
+         * @return true if all the lidars are connected, otherwise false.
+         */
+        bool initialize();
+
+        /**
+         * @brief Start every lidar and the shared data thread
+         * @return true if all the lidars are scanning, otherwise false and
+         *  none is scanning.
+         */
+        bool turnOn();
+
+        /**
+         * @brief Stop the shared data thread and every lidar
+         * @return true if all the lidars are stopped, otherwise false.
+         */
+        bool turnOff();
+
+        /**
+         * @brief Disconnect every lidar
+         */
+        void disconnecting();
+
+        /**
+         * @brief Get the next scan set
+         * @param[out] set       one scan per lidar and their skews
+         * @param timeout        milliseconds
+         * @return false if no new set was published within the timeout.
+         */
+        bool doProcessSimple(ScanSet &set, uint32_t timeout = DriverInterface::DEFAULT_TIMEOUT);
+
+        /**
+         * @brief Get the next scan set merged into one cloud in the vehicle frame
+         * @param[out] cloud     points of every lidar with their member index,
+         *  invalid and deduplicated points left out
+         * @param timeout        milliseconds
+         * @return false if no new set was published within the timeout.
+         */
+        bool doProcessCloud(FusedCloud &cloud, uint32_t timeout = DriverInterface::DEFAULT_TIMEOUT);
+
+        /**
+         * @brief Merge a set into one cloud, for sets received by the set callback
+         * @note uses the fusion state of ::doProcessCloud, call from one thread.
+         */
+        void fuse(const ScanSet &set, FusedCloud &cloud);
+
+        /**
+         * @brief Set the pose of one lidar in the vehicle frame
+         * @param member         index
+         * @param x              meters
+         * @param y              meters
+         * @param yaw            degrees, counterclockwise
+         * @return false if out of range.
+         * @note a new yaw rebuilds the lookup tables of the lidar, set it
+         *  before turnOn or from the thread calling ::doProcessCloud.
+         */
+        bool setExtrinsics(size_t member, float x, float y, float yaw);
+
+        /**
+         * @brief Drop the points of a lidar falling in a polar cell of the
+         * vehicle frame that a lower index lidar already filled
+         * @param angleStep      cell width in degrees, 0 disables
+         * @param rangeStep      cell depth in meters
+         * @param maxRange       meters, farther points are always kept
+         * @return false if the grid is too fine or invalid.
+         */
+        bool setDeduplication(float angleStep, float rangeStep = 0.05f, float maxRange = 20.f);
+
+        /**
+         * @brief Set the callback called with every scan set, on the shared
+         * data thread; it delays decoding and must return quickly.
+         * @param callback       set callback, empty to disable
+         */
+        void setSetCallback(const SetCallback &callback);
+
+        /**
+         * @brief Get the percentiles of the arrival skew of one lidar, the
+         * time its scans were assembled after the earliest scan of their set
+         * @param member         index
+         * @param[out] stats     microseconds
+         * @return false if out of range.
+         */
+        bool getSkew(size_t member, LidarLatency &stats) const;
+
+        /**
+         * @brief Clear the skew histograms
+         */
+        void resetSkew();
+
+    protected:
+        /**
+         * @brief Forget the unmatched scans, the scan periods and the set
+         * counters, before the lidars start
+         */
+        void resetMatching();
+
+        /**
+         * @brief Queue a complete scan of a lidar and publish the set it completes
+         * @param index          lidar index
+         * @param scan           scan of the lidar, ignored if it has no stamp
+         */
+        void onMemberScan(size_t index, const LaserScan &scan);
+
+    private:
+        static _size_t THREAD_PROC initializeProc(void *param);
+
+        /**
+         * @brief Find a scan of every lidar within the tolerance of the newest
+         * scan of one lidar, and publish them as a set
+         */
+        bool matchSet(Member *anchor);
+
+        /**
+         * @brief Stamp difference within which scans belong to one set
+         * @return 0 until the scan periods are known
+         */
+        uint64_t tolerance() const;
+
+        void publishSet();
+};	// End of class
+#endif // CYDLIDARGROUP_H
@@ -0,0 +1,128 @@
+#include "DataReactor.h"
+#include <core/serial/common.h>
+#include <core/common/ydlidar_help.h>
+#include <core/common/Trace.h>
+#include <core/common/ydlidar_protocol.h>
+
+namespace ydlidar {
+
+DataReactor::DataReactor()
+    : m_socket(NULL),
+      m_running(false),
+      m_active(false),
+      m_unrouted(0),
+      m_port(8000) {
+}
+
+DataReactor::~DataReactor() {
+    stop();
+}
+
+bool DataReactor::addDriver(const char *ip, DriverInterface *driver) {
+    if (m_running || !ip || !driver) {
+        return false;
+    }
+    uint32_t addr = inet_addr(ip);
+    if (addr == INADDR_NONE || m_routes.count(addr)) {
+        return false;
+    }
+    Route route = {driver, 0};
+    m_routes[addr] = route;
+    return true;
+}
+
+void DataReactor::clear() {
+    if (!m_running) {
+        m_routes.clear();
+    }
+}
+
+bool DataReactor::start(uint16_t port) {
+    if (m_running) {
+        return true;
+    }
+    m_port = port;
+    m_socket = new CPassiveSocket(CSimpleSocket::SocketTypeUdp);
+    m_socket->SetSocketType(CSimpleSocket::SocketTypeUdp);
+    if (!m_socket->Initialize() || !m_socket->Listen(NULL, port)) {
+        LOGE("Failed to bind the shared data port %u", port);
+        delete m_socket;
+        m_socket = NULL;
+        return false;
+    }
+    m_socket->SetReceiveTimeout(POLL_TIMEOUT / 1000, (POLL_TIMEOUT % 1000) * 1000);
+
+    uint32_t now = getms();
+    for (map<uint32_t, Route>::iterator it = m_routes.begin(); it != m_routes.end(); ++it) {
+        it->second.last = now;
+    }
+    m_unrouted = 0;
+    m_running = true;
+    m_active = true;
+    m_thread = CLASS_THREAD(DataReactor, run);
+    if (m_thread.getHandle() == 0) {
+        m_running = false;
+        m_active = false;
+        m_socket->Close();
+        delete m_socket;
+        m_socket = NULL;
+        return false;
+    }
+    return true;
+}
+
+void DataReactor::stop() {
+    if (!m_socket) {
+        return;
+    }
+    m_running = false;
+    //等待线程在接收超时后自行退出，Thread::join会取消线程
+    while (m_active) {
+        delay(1);
+    }
+    m_thread.join();
+    m_socket->Close();
+    delete m_socket;
+    m_socket = NULL;
+}
+
+int DataReactor::run() {
+    LOGD("Thread Start: [%s]", __func__);
+    Trace::setThreadName("DataReactor");
+    uint8_t data[DATA_ONESIZE];
+
+    while (m_running) {
+        int32_t l = 0;
+        {
+            TRACE_SCOPE("Receive");
+            l = m_socket->Receive(DATA_ONESIZE, data);
+        }
+        uint32_t now = getms();
+        if (l > 0) {
+            const sockaddr_in &peer = m_socket->GetClientSockaddr();
+            map<uint32_t, Route>::iterator it = m_routes.find(peer.sin_addr.s_addr);
+            if (it == m_routes.end()) {
+                m_unrouted++;
+            } else {
+                //接收耗时包括等待，计入发送方的驱动
+                DriverInterface *driver = it->second.driver;
+                it->second.last = now;
+                driver->recordLatency(LatencyStageReceive, m_socket->GetTotalTimeUsec());
+                driver->feedDatagram(data, l, peer.sin_addr.s_addr, ntohs(peer.sin_port),
+                                     m_socket->GetReceiveTimestamp());
+            }
+        }
+
+        //各雷达单独判断超时，一台停发不影响其他雷达
+        for (map<uint32_t, Route>::iterator it = m_routes.begin(); it != m_routes.end(); ++it) {
+            if (now - it->second.last > DriverInterface::DEFAULT_TIMEOUT) {
+                it->second.last = now;
+                it->second.driver->feedTimeout();
+            }
+        }
+    }
+    m_active = false;
+    return RESULT_OK;
+}
+
+} // namespace ydlidar
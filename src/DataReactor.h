@@ -0,0 +1,101 @@
+#ifndef DATA_REACTOR_H
+#define DATA_REACTOR_H
+#include <core/common/DriverInterface.h>
+#include <core/network/PassiveSocket.h>
+#include <map>
+#include <string>
+
+namespace ydlidar {
+
+using namespace std;
+using namespace core::base;
+using namespace core::common;
+using namespace core::network;
+
+/**
+ * @brief One data port socket and one thread serving several lidars.
+ * Every lidar sends its data frames to the same host port, each datagram
+ * is handed to the driver registered for its sender address through
+ * DriverInterface::feedDatagram, on the reactor thread. A driver that sends
+ * nothing for DriverInterface::DEFAULT_TIMEOUT gets
+ * DriverInterface::feedTimeout.
+ */
+class DataReactor {
+public:
+    enum {
+        POLL_TIMEOUT = 100, /**< receive timeout in milliseconds, bounds the stop and timeout latency. */
+    };
+
+    /**
+     * @par Constructor
+     *
+     */
+    DataReactor();
+
+    /**
+     * @par Destructor
+     *
+     */
+    ~DataReactor();
+
+    /**
+     * @brief Route the datagrams of one lidar to a driver \n
+     * @param[in] ip        lidar address
+     * @param[in] driver    driver in shared data mode, the caller keeps the ownership
+     * @return false if the address is invalid or already routed, or the reactor is running
+     */
+    bool addDriver(const char *ip, DriverInterface *driver);
+
+    /**
+     * @brief Forget every driver \n
+     * @note Stop the reactor first
+     */
+    void clear();
+
+    /**
+     * @brief Bind the data port and start the reactor thread \n
+     * @param[in] port      data port the lidars send to
+     * @return false if the port cannot be bound or the thread cannot start
+     */
+    bool start(uint16_t port = 8000);
+
+    /**
+     * @brief Stop the reactor thread and close the data port \n
+     */
+    void stop();
+
+    bool isRunning() const {
+        return m_running;
+    }
+
+    /**
+     * @brief Datagrams from senders without driver \n
+     */
+    uint64_t unrouted() const {
+        return m_unrouted;
+    }
+
+private:
+    /**
+     * @brief Receive and dispatch the datagrams \n
+     */
+    int run();
+
+private:
+    struct Route {
+        DriverInterface *driver;
+        uint32_t last;  ///< getms() of the last datagram or timeout
+    };
+
+    CPassiveSocket *m_socket;
+    map<uint32_t, Route> m_routes; ///< by sender address, network byte order
+    Thread m_thread;
+    volatile bool m_running;
+    volatile bool m_active;        ///< false once the thread has left
+    uint64_t m_unrouted;
+    uint16_t m_port;
+};
+
+} // namespace ydlidar
+
+#endif //DATA_REACTOR_H
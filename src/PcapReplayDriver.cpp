@@ -0,0 +1,154 @@
+#include "PcapReplayDriver.h"
+#include <core/common/ydlidar_help.h>
+#include <core/common/Trace.h>
+
+namespace ydlidar {
+
+PcapReplayDriver::PcapReplayDriver(bool realtime, bool loop)
+    : m_port(8000),
+      m_realtime(realtime),
+      m_loop(loop),
+      m_finished(false),
+      m_firstStamp(0),
+      m_firstClock(0) {
+}
+
+PcapReplayDriver::~PcapReplayDriver() {
+    disconnect();
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+                                                 从TEALidarDriver重载的函数
+---------------------------------------------------------------------------------------------------------------*/
+bool PcapReplayDriver::configPortTransfer(char *transBuf, int transLen, char *recvBuf, int recvMaxSize) {
+    LOGD("Replay driver ignores commands");
+    return false;
+}
+
+result_t PcapReplayDriver::checkAutoConnecting() {
+    //回放只会在文件结束时超时
+    if (m_finished) {
+        LOGD("Replay of %s finished", m_path.c_str());
+        notifyStateChanged(LidarStateConnected);
+        return RESULT_FAIL;
+    }
+    setDriverError(NoError);
+    return RESULT_OK;
+}
+
+int32_t PcapReplayDriver::receiveData(uint8_t *buf, uint32_t len) {
+    TRACE_SCOPE("Receive");
+    PcapPacket packet;
+    while (getIsScanning()) {
+        if (!m_reader.next(packet)) {
+            if (!m_loop || !m_reader.rewind()) {
+                m_finished = true;
+                return -1;
+            }
+            m_firstStamp = 0;
+            continue;
+        }
+        if (packet.protocol != PcapWriter::ProtocolUdp || packet.dstPort != m_port ||
+            packet.length == 0) {
+            continue;
+        }
+
+        if (m_realtime) {
+            if (!m_firstStamp) {
+                m_firstStamp = packet.stamp;
+                m_firstClock = getus();
+            }
+            //按录制时的间隔发送
+            uint64_t due = m_firstClock + (packet.stamp - m_firstStamp);
+            uint64_t now = getus();
+            while (now < due && getIsScanning()) {
+                uint64_t wait = (due - now) / 1000;
+                delay(wait > 100 ? 100 : (wait ? wait : 1));
+                now = getus();
+            }
+        }
+
+        uint32_t l = packet.length < len ? packet.length : len;
+        memcpy(buf, packet.payload, l);
+        m_Metrics.datagrams.add();
+        m_Metrics.bytes.add(l);
+        return l;
+    }
+    return -1;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+                                        从DriverInterface虚基类继承的纯虚函数
+---------------------------------------------------------------------------------------------------------------*/
+result_t PcapReplayDriver::connect(const char *path, uint32_t baudrate) {
+    if (!m_reader.open(path)) {
+        LOGE("Cannot open capture file %s", path ? path : "");
+        setDriverError(NotOpenError);
+        return RESULT_FAIL;
+    }
+    m_path = path;
+    m_port = baudrate ? baudrate : 8000;
+    m_finished = false;
+    setIsConnected(true);
+    notifyStateChanged(LidarStateConnected);
+    LOGD("Replaying %s", path);
+    return RESULT_OK;
+}
+
+void PcapReplayDriver::disconnect() {
+    stopScan();
+    bool connected = getIsConnected();
+    m_reader.close();
+    setIsConnected(false);
+    if (connected) {
+        notifyStateChanged(LidarStateDisconnected);
+    }
+}
+
+result_t PcapReplayDriver::startScan(uint32_t timeout) {
+    if (getIsScanning()) {
+        return RESULT_OK;
+    }
+    if (!getIsConnected() || !m_reader.rewind()) {
+        return RESULT_FAIL;
+    }
+    m_finished = false;
+    m_firstStamp = 0;
+    setIsScanning(true);
+    m_ScanQueue.clear();
+    resetDecodeState();
+    if (!IS_OK(createThread())) {
+        setIsScanning(false);
+        return RESULT_FAIL;
+    }
+    notifyStateChanged(LidarStateScanning);
+    return RESULT_OK;
+}
+
+result_t PcapReplayDriver::stopScan(uint32_t timeout) {
+    if (!getIsScanning()) {
+        return RESULT_OK;
+    }
+    setIsScanning(false);
+    {
+        ScopedLocker l(m_Lock);
+        m_ScanQueue.wakeup();
+        m_Thread.join();
+    }
+    notifyStateChanged(getIsConnected() ? LidarStateConnected : LidarStateDisconnected);
+    return RESULT_OK;
+}
+
+const char *PcapReplayDriver::DescribeError(bool isTCP) {
+    return m_reader.isOpen() ? "Replay" : "No capture file";
+}
+
+map<string, string> PcapReplayDriver::lidarPortList() {
+    map<string, string> ports;
+    if (!m_path.empty()) {
+        ports["replay"] = m_path;
+    }
+    return ports;
+}
+
+} // namespace ydlidar
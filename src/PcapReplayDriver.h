@@ -0,0 +1,94 @@
+#ifndef PCAPREPLAY_DRIVER_H
+#define PCAPREPLAY_DRIVER_H
+#include "TEALidarDriver.h"
+#include <core/common/PcapFile.h>
+
+namespace ydlidar {
+
+/**
+ * @brief Feed a capture of the TEA data port into the ::TEALidarDriver
+ * decode path instead of the network.
+ * UDP datagrams sent to the data port are replayed either at the recorded
+ * pace or as fast as possible, everything else in the file is ignored.
+ * Commands fail, the capture cannot answer them.
+ */
+class PcapReplayDriver : public TEALidarDriver {
+public:
+    /**
+     * @par Constructor
+     * @param realtime  keep the recorded inter-packet delays
+     * @param loop      restart at the end of the file instead of stopping
+     */
+    explicit PcapReplayDriver(bool realtime = true, bool loop = false);
+
+    /**
+     * @par Destructor
+     *
+     */
+    ~PcapReplayDriver();
+
+    /**
+     * @brief Whether the end of the capture has been reached \n
+     */
+    bool isFinished() const {
+        return m_finished;
+    }
+
+/*--------------------------------------------------------------------------------------------------------------
+                                                 从TEALidarDriver重载的函数
+---------------------------------------------------------------------------------------------------------------*/
+protected:
+    virtual bool configPortTransfer(char *transBuf, int transLen, char *recvBuf, int recvMaxSize);
+    virtual result_t checkAutoConnecting();
+    virtual int32_t receiveData(uint8_t *buf, uint32_t len);
+
+public:
+    /**
+     * @brief Open the capture file \n
+     * @param[in] path      pcap file
+     * @param[in] baudrate  data port of the capture, 0 for the default 8000
+     * @return open status
+     * @retval RESULT_OK     success
+     * @retval RESULT_FAILE  the file is missing or not a pcap capture
+     */
+    virtual result_t connect(const char *path, uint32_t baudrate);
+
+    /**
+     * @brief Close the capture file.
+     */
+    virtual void disconnect();
+
+    /**
+     * @brief Start replaying from the first packet \n
+     */
+    virtual result_t startScan(uint32_t timeout = DEFAULT_TIMEOUT);
+
+    /**
+     * @brief Stop replaying \n
+     */
+    virtual result_t stopScan(uint32_t timeout = DEFAULT_TIMEOUT);
+
+    virtual const char *DescribeError(bool isTCP = true);
+    virtual map<string, string> lidarPortList();
+
+    /**
+     * @brief The capture is the only data source, it cannot be shared \n
+     */
+    virtual bool setSharedData(bool shared) {
+        return !shared;
+    }
+
+private:
+    PcapReader m_reader;
+    string m_path;
+    uint16_t m_port;            ///< replayed destination port
+    bool m_realtime;
+    bool m_loop;
+    volatile bool m_finished;
+    uint64_t m_firstStamp;      ///< capture time of the first replayed packet
+    uint64_t m_firstClock;      ///< getus() when it was replayed
+};
+
+} // namespace ydlidar
+
+#endif //PCAPREPLAY_DRIVER_H
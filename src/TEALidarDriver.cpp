@@ -1,9 +1,11 @@
 #include "TEALidarDriver.h"
 #include <core/serial/common.h>
 #include <math.h>
+#include <algorithm>
 #include <core/tools/cJSON.h>
 #include <core/base/thread.h>
 #include <core/common/ydlidar_help.h>
+#include <core/common/Trace.h>
 
 
 namespace ydlidar {
@@ -14,15 +16,18 @@ TEALidarDriver::TEALidarDriver()
     m_cmd_port = 8090;
     m_data_port = 8000;
     m_list_port = 8001;
+    m_sharedData = false;
+    m_scanNodes.resize(MAX_SCAN_NODES);
     m_socket_cmd = new CActiveSocket(CSimpleSocket::SocketTypeTcp);
     m_socket_cmd->SetConnectTimeout(DEFAULT_CONNECTION_TIMEOUT_SEC, DEFAULT_CONNECTION_TIMEOUT_USEC);
     m_socket_data = new CPassiveSocket(CSimpleSocket::SocketTypeUdp);
     m_socket_data->SetSocketType(CSimpleSocket::SocketTypeUdp);
     m_socket_list = new CPassiveSocket(CSimpleSocket::SocketTypeUdp);
     m_socket_list->SetSocketType(CSimpleSocket::SocketTypeUdp);
+    resetDecodeState();
 
     //父类成员变量
-    m_ScanNodeBuf = new node_info[MAX_SCAN_NODES];
+    setScanQueue(1, ScanQueueLatestOnly);
 }
 
 TEALidarDriver::~TEALidarDriver() {
@@ -42,10 +47,6 @@ TEALidarDriver::~TEALidarDriver() {
         delete m_socket_list;
         m_socket_list = NULL;
     }
-    if (m_ScanNodeBuf) {
-        delete[]  m_ScanNodeBuf;
-        m_ScanNodeBuf = nullptr;
-    }
 }
 
 /*--------------------------------------------------------------------------------------------------------------
@@ -88,6 +89,7 @@ bool TEALidarDriver::configPortDisconnect() {
 
 
 bool TEALidarDriver::configPortTransfer(char *transBuf, int transLen, char *recvBuf, int recvMaxSize) {
+    TRACE_SCOPE("Command");
     ScopedLocker lock(m_CmdLock);
     int len = 0;
     if (!m_socket_cmd){
@@ -98,9 +100,19 @@ bool TEALidarDriver::configPortTransfer(char *transBuf, int transLen, char *recv
         len += m_socket_cmd->Send(reinterpret_cast<uint8_t *>(transBuf + len), transLen - len);
     }while(len < transLen);
     
+    const sockaddr_in &peer = m_socket_cmd->GetServerSockaddr();
+    if (m_Recorder) {
+        m_Recorder->writeTcp(0, 0, peer.sin_addr.s_addr, ntohs(peer.sin_port),
+                             reinterpret_cast<uint8_t *>(transBuf), len);
+    }
     LOGD("TCP SNED(%d):\n%s", len, transBuf);
     if (m_socket_cmd->Select(0, 800000)) {
-        if(m_socket_cmd->Receive(recvMaxSize, reinterpret_cast<uint8_t *>(recvBuf)) > 0) {
+        int32_t rl = m_socket_cmd->Receive(recvMaxSize, reinterpret_cast<uint8_t *>(recvBuf));
+        if (rl > 0) {
+            if (m_Recorder) {
+                m_Recorder->writeTcp(peer.sin_addr.s_addr, ntohs(peer.sin_port), 0, 0,
+                                     reinterpret_cast<uint8_t *>(recvBuf), rl);
+            }
             return true;
         }
     }
@@ -200,7 +212,7 @@ bool TEALidarDriver::dataPortDisconnect() {
 
 void TEALidarDriver::disableDataGrabbing() {
     ScopedLocker l(m_Lock);
-    m_DataEvent.set();
+    m_ScanQueue.wakeup();
     m_Thread.join();
 }
 
@@ -240,19 +252,28 @@ bool TEALidarDriver::listPortDisconnect() {
 
 
 result_t TEALidarDriver::checkAutoConnecting() {
+    TRACE_SCOPE("Reconnect");
     int retryConnect = 0;
     setIsAutoconnting(true);
     while(getIsAutoReconnect()) {
         disconnect();
+        if (!retryConnect) {
+            notifyStateChanged(LidarStateReconnecting);
+        }
         retryConnect = retryConnect > 25 ? 25 : retryConnect + 1;
         for(int i = 0; i < retryConnect; i++){
             delay(200);    
         }
         LOGD("Reconnecting...");
+        m_Metrics.reconnects.add();
+        Trace::instant("ReconnectAttempt");
         if(!IS_OK(connect(m_ip.c_str(), m_cmd_port))) {
             setDriverError(NotOpenError);
         }else {
             setDriverError(NoError);
+            if (getIsScanning()) {
+                notifyStateChanged(LidarStateScanning);
+            }
             break;
         }
     }
@@ -263,11 +284,22 @@ result_t TEALidarDriver::checkAutoConnecting() {
 int32_t TEALidarDriver::receiveData(uint8_t *buf, uint32_t len) 
 {
     /* wait data from socket. */
+    TRACE_SCOPE("Receive");
     ScopedLocker lock(m_DataLock);
     if (!m_socket_data) {
             return -1;
     }
     int32_t l = m_socket_data->Receive(len, buf);
+    if (l > 0) {
+        m_Metrics.datagrams.add();
+        m_Metrics.bytes.add(l);
+        m_Latency.record(LatencyStageReceive, m_socket_data->GetTotalTimeUsec());
+        if (m_Recorder) {
+            const sockaddr_in &peer = m_socket_data->GetClientSockaddr();
+            m_Recorder->writeUdp(peer.sin_addr.s_addr, ntohs(peer.sin_port), 0, m_data_port,
+                                 buf, l, m_socket_data->GetReceiveTimestamp());
+        }
+    }
     // LOGD("UDP RECV(%d): ", l);
     // for (int32_t i=0; i<l; ++i)
     //     printf("%02X", buf[i]);
@@ -284,31 +316,29 @@ result_t TEALidarDriver::waitScanData(
     result_t ret = RESULT_FAIL;
     NetDataFrame frame; //大包数据（包含12 * 小包数据16个点）
     uint8_t* p = reinterpret_cast<uint8_t*>(&frame);
-    node_info *n = NULL;
-    static uint16_t lastPointAngle = 0;
-    static uint8_t lastNum = 0xff;
     count = 0;
 
     // uint8_t buff[DATA_ONESIZE] = {0};
     // receiveData(buff, DATA_ONESIZE);
     // return RESULT_OK;
 
-    static uint8_t s_data[DATA_ONESIZE] = {0};
-    static int s_dataSize = 0;
     int nl = 0;
     int rl = 0; //实际接收数据长度
     int pos = 0;
+    bool skipped = false; //是否丢弃了包结束标识前的数据
+    uint64_t frameStart = 0; //找到包结束标识的时间
+    uint64_t frameDone = 0; //整大包数据接收完成的时间
     uint32_t st = getms(); //开始时间
     uint32_t rt = 0; //当前时间差
     while ((rt = getms() - st) < timeout)
     {
         //每次读取固定大小的数据
         uint8_t data[DATA_ONESIZE] = {0};
-        if (s_dataSize) // 将上次剩余的数据加进来
+        if (m_pendingSize) // 将上次剩余的数据加进来
         {
-            memcpy(data, s_data, s_dataSize);
-            rl = s_dataSize;
-            s_dataSize = 0;
+            memcpy(data, m_pending, m_pendingSize);
+            rl = m_pendingSize;
+            m_pendingSize = 0;
         }
         else //新读取数据
         {
@@ -329,6 +359,7 @@ result_t TEALidarDriver::waitScanData(
                 if (c != 0x65)
                 {
                     pos = 0;
+                    skipped = true;
                     continue;
                 }
                 break;
@@ -336,6 +367,7 @@ result_t TEALidarDriver::waitScanData(
                 if (c != 0x43)
                 {
                     pos = 0;
+                    skipped = true;
                     continue;
                 }
                 break;
@@ -343,6 +375,7 @@ result_t TEALidarDriver::waitScanData(
                 if (c != 0x21)
                 {
                     pos = 0;
+                    skipped = true;
                     continue;
                 }
                 break;
@@ -353,6 +386,7 @@ result_t TEALidarDriver::waitScanData(
             {
                 pos = 0;
                 i ++;
+                frameStart = getus();
                 //找到上一包结束标记以后获取整大包数据
                 // LOGD("Start pos %llu", i);
                 int rs = rl - i; // 数据实际大小
@@ -375,11 +409,18 @@ result_t TEALidarDriver::waitScanData(
                     //     LOGD("End pos %d %d", ss, DATA_ONESIZE * 2 - ss);
                     ss = DATA_ONESIZE - ss;
                 }
-                //将多余部分暂存在静态缓存中，等待下一次使用
+                //将多余部分暂存在成员缓存中，等待下一次使用
                 if (ss)
                 {
-                    memcpy(s_data, data + (DATA_ONESIZE - ss), ss);
-                    s_dataSize += ss;
+                    memcpy(m_pending, data + (DATA_ONESIZE - ss), ss);
+                    m_pendingSize += ss;
+                }
+                frameDone = getus();
+                m_Latency.record(LatencyStageReassembly, frameDone - frameStart);
+                Trace::complete("Reassembly", frameStart, frameDone - frameStart);
+                m_Metrics.frames.add();
+                if (skipped) {
+                    m_Metrics.resyncs.add();
                 }
                 ret = RESULT_OK;
                 break;
@@ -392,6 +433,23 @@ result_t TEALidarDriver::waitScanData(
         }
     }
 
+    if (!IS_OK(ret)) {
+        return RESULT_TIMEOUT;
+    }
+    return decodeFrame(frame, nodebuffer, count, frameDone);
+}
+
+//解析一整大包数据，frameDone为收齐的时间
+result_t TEALidarDriver::decodeFrame(
+    const NetDataFrame &frame,
+    node_info *nodebuffer,
+    size_t &count,
+    uint64_t frameDone)
+{
+    node_info *n = NULL;
+    size_t decoded = 0; //帧内解出的点数，包括被丢弃的点
+    count = 0;
+
     //判断每小包数据的头部是否有效
     // for (int i = 0; i < DATABLOCK_COUNT; i++) 
     // {
@@ -403,35 +461,56 @@ result_t TEALidarDriver::waitScanData(
 
     //uint8_t curNum = (BigLittleSwap32(frame.factory) & 0x000F0000) >> 16;
     uint8_t curNum = (BigLittleSwap32(frame.factory) & 0x0F000000) >> 24;
-    if ((curNum - lastNum != 1) && 
-        (curNum - lastNum != -15) && 
-        lastNum != 0xff) 
+    if ((curNum - m_lastFrameNum != 1) && 
+        (curNum - m_lastFrameNum != -15) && 
+        m_lastFrameNum != 0xff) 
     {
-        LOGE("data packet dropout, curNum = %d, lastNum = %d", curNum, lastNum);
-        lastNum = curNum;
+        LOGE("data packet dropout, curNum = %d, lastNum = %d", curNum, m_lastFrameNum);
+        Trace::instant("FrameDrop");
+        m_Metrics.frameDrops.add((curNum - m_lastFrameNum - 1) & 0x0F);
+        m_lastFrameNum = curNum;
         return RESULT_FAIL;
     }
-    lastNum = curNum;
-    
+    m_lastFrameNum = curNum;
+
+    const bool zones = m_ZoneEvaluator.isActive();
     for (int i = 0; i < DATABLOCK_COUNT; i++) 
     {
         if (BigLittleSwap16(frame.dataBlock[i].frameHead) != 0xFFEE)
             continue;
 
         uint16_t startAngle = BigLittleSwap16(frame.dataBlock[i].startAngle);
+        //整块都在窗口外时不解析，按满块计入帧内点数
+        if (!m_ScanGate.blockVisible(startAngle)) {
+            decoded += DATA_COUNT;
+            continue;
+        }
+
         uint16_t addAngle = 0;
         for (int j = 0; j < DATA_COUNT; j++) 
         {
             uint32_t data = BigLittleSwap32(frame.dataBlock[i].data[j]);
             if (data != 0) {
-                n = nodebuffer + count;
                 addAngle += ((data & 0x3f000000) >> 24);
-                n->angle_q6_checkbit = startAngle + addAngle;
-                n->sync_flag = (n->angle_q6_checkbit < lastPointAngle) ? Node_Sync : Node_NotSync; //当前点的角度小于上一个点的角度，则认为当前点为零位点
+                uint16_t angle = startAngle + addAngle;
+                uint16_t distance = (data & 0xffff) >> 0;
+                //窗口外或超出距离范围的点不输出，零位由窗口内的下一个点标记
+                if (!m_ScanGate.visible(angle, distance)) {
+                    decoded ++;
+                    continue;
+                }
+
+                n = nodebuffer + count;
+                n->angle_q6_checkbit = m_ScanGate.mapAngle(angle); //安装方向下的角度
+                n->sync_flag = (angle < m_lastPointAngle) ? Node_Sync : Node_NotSync; //当前点的解码角度小于上一个点的解码角度，则认为当前点为零位点
                 n->sync_quality = (data & 0xff0000) >> 16;
-                n->distance_q2 = (data & 0xffff) >> 0;
-                //n->stamp = timeStamp;
-                lastPointAngle = n->angle_q6_checkbit;
+                n->distance_q2 = distance;
+                n->stamp = decoded; //帧内位置，下面换算为时间戳
+                m_lastPointAngle = angle;
+                if (zones) {
+                    m_ZoneEvaluator.check(n->angle_q6_checkbit, distance);
+                }
+                decoded ++;
                 count ++;
             } else {
                 break;
@@ -440,39 +519,35 @@ result_t TEALidarDriver::waitScanData(
     }
 
     //处理时间戳
-    static uint64_t TimeStampCount = 0;
-    static uint64_t TimeStamp = 0;
-    static uint64_t lastTimeStamp = 0;
-    static uint32_t TimeStampTmp = 0;
-    static uint32_t lastTimeStampTmp = 0;
-
-    TimeStampTmp = BigLittleSwap32(frame.timeStamp);
-    TimeStampCount = TimeStampTmp > lastTimeStampTmp ? 
-        TimeStampCount : TimeStampCount + 1; //当前时间戳比上一轮时间戳小，说明时间戳溢出重新计数
-    TimeStamp = 0xffffffff * TimeStampCount + TimeStampTmp;
-    lastTimeStampTmp = TimeStampTmp;
+    uint32_t TimeStampTmp = BigLittleSwap32(frame.timeStamp);
+    m_stampWraps = TimeStampTmp > m_lastStampRaw ? 
+        m_stampWraps : m_stampWraps + 1; //当前时间戳比上一轮时间戳小，说明时间戳溢出重新计数
+    uint64_t TimeStamp = 0xffffffff * m_stampWraps + TimeStampTmp;
+    m_lastStampRaw = TimeStampTmp;
 
+    //按点在帧内的位置插值，丢弃的点也占时间
     for (int i = 0; i < count; i++) {
         n = nodebuffer + i;
-        n->stamp = TimeStamp - (TimeStamp - lastTimeStamp) * (count - i - 1) / count;
+        n->stamp = TimeStamp - (TimeStamp - m_lastStamp) * (decoded - n->stamp - 1) / decoded;
     }
-    lastTimeStamp = TimeStamp;
+    m_lastStamp = TimeStamp;
 
+    uint64_t decodeDone = getus();
+    m_Latency.record(LatencyStageDecode, decodeDone - frameDone);
+    Trace::complete("Decode", frameDone, decodeDone - frameDone);
     return RESULT_OK;
 }
 
 result_t TEALidarDriver::cacheScanData() 
 {
     LOGD("Thread Start: [%s]", __func__);
+    Trace::setThreadName("cacheScanData");
     node_info      local_buf[DATABLOCK_COUNT * DATA_COUNT];
-    node_info      local_scan[MAX_SCAN_NODES];
     size_t         timeout_count = 0;
-    size_t         scan_count = 0;
     size_t         count = 0;
     result_t       ans = RESULT_FAIL;
 
     memset(&local_buf, 0, sizeof(local_buf));
-    memset(&local_scan, 0, sizeof(local_scan));
 
     // while (!IS_OK(waitScanData(local_buf, count)));//丢弃一包
 
@@ -484,16 +559,18 @@ result_t TEALidarDriver::cacheScanData()
         if (IS_FAIL(ans)) {
             LOGE("bad data block!!!");
             // waitScanData(local_buf, count);//丢弃一包
-            local_scan[0].sync_flag = Node_Sync;    
+            m_scanNodes[0].sync_flag = Node_Sync;    
             continue;
         } else if (IS_TIMEOUT(ans)) {
             timeout_count++;
+            m_Metrics.timeouts.add();
+            m_scanStartUs = 0;
             LOGE("get data timeout(%d)!!!", timeout_count);
             if(timeout_count > DEFAULT_TIMEOUT_COUNT){
                 setDriverError(TimeoutError);
                 if (IS_OK(checkAutoConnecting())) {
                     // waitScanData(local_buf, count);//丢弃一包
-                    local_scan[0].sync_flag = Node_Sync;  
+                    m_scanNodes[0].sync_flag = Node_Sync;  
                     timeout_count = 0;
                 } else {
                     LOGE("exit scanning thread!!!");
@@ -504,26 +581,172 @@ result_t TEALidarDriver::cacheScanData()
         } else {
             timeout_count = 0;
         }
+        publishFrame(local_buf, count, getus());
+    }
+    return RESULT_OK;
+}
 
-        for (size_t pos = 0; pos < count; pos++) 
-        {
-            if (local_buf[pos].sync_flag & Node_Sync) {
-                if ((local_scan[0].sync_flag & Node_Sync)) {
-                    m_Lock.lock();//timeout lock, wait resource copy
-                    memcpy(m_ScanNodeBuf, local_scan, scan_count * sizeof(node_info));
-                    m_ScanNodeCount = scan_count;
-                    m_DataEvent.set();
-                    m_Lock.unlock();
+void TEALidarDriver::publishFrame(const node_info *local_buf, size_t count, uint64_t frame_us)
+{
+    node_info *local_scan = &m_scanNodes[0];
+
+    //区域在解码时已逐点判断，每帧上报一次
+    if (m_ZoneEvaluator.isActive()) {
+        ZoneEvent events[ZoneEvaluator::MAX_ZONES];
+        size_t violations = m_ZoneEvaluator.collect(events, count ? local_buf[count - 1].stamp : 0);
+        for (size_t i = 0; m_Listener && i < violations; i++) {
+            m_Listener->onZoneViolation(events[i]);
+        }
+    }
+
+    //整帧都在窗口外时没有扇区可交付
+    if (m_Listener && count) {
+        m_Listener->onSector(local_buf, count);
+    }
+
+    for (size_t pos = 0; pos < count; pos++) 
+    {
+        if (local_buf[pos].sync_flag & Node_Sync) {
+            if ((local_scan[0].sync_flag & Node_Sync)) {
+                TRACE_SCOPE("Publish");
+                uint64_t pushed = 0;
+                uint64_t seq = m_ScanQueue.push(local_scan, m_scanCount, &pushed);
+                if (m_ShmPublisher) {
+                    m_ShmPublisher->publish(local_scan, m_scanCount, seq);
+                }
+                if (m_SectorIndex.sectors()) {
+                    //扇区最小值在组包时已累计，这里只建区间查询表，再与已发布的交换
+                    m_SectorIndex.finish(seq, local_scan[0].stamp);
+                    ScopedLocker l(m_SectorLock);
+                    std::swap(m_SectorIndex, m_LastSectorIndex);
+                }
+                uint64_t dropped = m_ScanQueue.dropped();
+                m_Metrics.scansPublished.add();
+                m_Metrics.scansDropped.set(dropped);
+                m_Metrics.queuedScans.set(m_ScanQueue.size());
+                m_Metrics.scanPoints.set(m_scanCount);
+                if (m_scanStartUs) {
+                    m_Latency.record(LatencyStageAssembly, getus() - m_scanStartUs);
+                }
+                if (m_Listener) {
+                    scan_sequence sequence = {seq, dropped, pushed};
+                    m_Listener->onScan(local_scan, m_scanCount, sequence);
                 }
-                scan_count = 0;
             }
-            local_scan[scan_count++] = local_buf[pos];
-            if (scan_count == _countof(local_scan)) {
-                scan_count -= 1;
+            m_scanCount = 0;
+            m_scanStartUs = frame_us;
+            if (m_SectorIndex.sectors()) {
+                m_SectorIndex.reset();
             }
-        }       
+        }
+        if (m_SectorIndex.sectors()) {
+            m_SectorIndex.add(local_buf[pos]);
+        }
+        local_scan[m_scanCount++] = local_buf[pos];
+        if (m_scanCount == m_scanNodes.size()) {
+            m_scanCount -= 1;
+        }
+    }       
+}
+
+bool TEALidarDriver::setSharedData(bool shared)
+{
+    m_sharedData = shared;
+    return true;
+}
+
+//与waitScanData相同的拼包规则，数据由共享的接收线程逐包送入
+void TEALidarDriver::feedDatagram(const uint8_t *data, size_t len, uint32_t addr, uint16_t port, uint64_t stamp)
+{
+    static const uint8_t tail[TEA_TAILSIZE] = {0x65, 0x43, 0x21};
+    uint8_t *p = reinterpret_cast<uint8_t *>(&m_feedFrame);
+    node_info local_buf[DATABLOCK_COUNT * DATA_COUNT];
+
+    m_Metrics.datagrams.add();
+    m_Metrics.bytes.add(len);
+    if (m_Recorder) {
+        m_Recorder->writeUdp(addr, port, 0, m_data_port, data, len, stamp);
+    }
+
+    size_t i = 0;
+    while (i < len)
+    {
+        if (m_feedSize < 0)
+        {
+            //查找包结束标识0x214365
+            if (data[i++] != tail[m_feedTail]) {
+                m_feedTail = 0;
+                m_feedSkipped = true;
+                continue;
+            }
+            if (++m_feedTail == TEA_TAILSIZE) {
+                m_feedTail = 0;
+                m_feedSize = 0;
+                m_feedStart = getus();
+            }
+            continue;
+        }
+
+        size_t ss = std::min(len - i, static_cast<size_t>(NETDATAFRAMESIXE2 - m_feedSize));
+        memcpy(p + m_feedSize, data + i, ss);
+        m_feedSize += ss;
+        i += ss;
+        if (m_feedSize < NETDATAFRAMESIXE2) {
+            break;
+        }
+
+        uint64_t frameDone = getus();
+        m_Latency.record(LatencyStageReassembly, frameDone - m_feedStart);
+        Trace::complete("Reassembly", m_feedStart, frameDone - m_feedStart);
+        m_Metrics.frames.add();
+        if (m_feedSkipped) {
+            m_Metrics.resyncs.add();
+        }
+        m_feedSize = -1;
+        m_feedSkipped = false;
+        m_feedTimeouts = 0;
+
+        size_t count = 0;
+        memset(local_buf, 0, sizeof(local_buf));
+        if (IS_FAIL(decodeFrame(m_feedFrame, local_buf, count, frameDone))) {
+            LOGE("bad data block!!!");
+            m_scanNodes[0].sync_flag = Node_Sync;
+            continue;
+        }
+        publishFrame(local_buf, count, getus());
     }
-    return RESULT_OK;
+}
+
+void TEALidarDriver::feedTimeout()
+{
+    m_feedTimeouts++;
+    m_Metrics.timeouts.add();
+    m_scanStartUs = 0;
+    LOGE("get data timeout(%d)!!!", m_feedTimeouts);
+    //共享接收时不重连，由上层处理
+    if (m_feedTimeouts > DEFAULT_TIMEOUT_COUNT) {
+        setDriverError(TimeoutError);
+        m_scanNodes[0].sync_flag = Node_Sync;
+        m_feedTimeouts = 0;
+    }
+}
+
+void TEALidarDriver::resetDecodeState()
+{
+    memset(&m_scanNodes[0], 0, m_scanNodes.size() * sizeof(node_info));
+    m_scanCount = 0;
+    m_scanStartUs = 0;
+    m_feedTail = 0;
+    m_feedSize = -1;
+    m_feedSkipped = false;
+    m_feedStart = 0;
+    m_feedTimeouts = 0;
+    m_lastPointAngle = 0;
+    m_lastFrameNum = 0xff;
+    m_pendingSize = 0;
+    m_stampWraps = 0;
+    m_lastStamp = 0;
+    m_lastStampRaw = 0;
 }
 
 result_t TEALidarDriver::createThread() 
@@ -537,6 +760,7 @@ result_t TEALidarDriver::createThread()
 
 result_t TEALidarDriver::GetListInfo() {
     LOGD("Thread Start:  [%s]", __func__);
+    Trace::setThreadName("GetListInfo");
     char name[64] = {0};
     char buf[256] = {0};
     int i;
@@ -548,6 +772,7 @@ result_t TEALidarDriver::GetListInfo() {
         memset(buf, 0, sizeof(buf));
 
         if(m_socket_list->Receive(sizeof(buf), (uint8_t*)buf) > 0) {
+            TRACE_SCOPE("Beacon");
             NetLidarListInfo lst;
             cJSON *item = NULL;
             cJSON *root = cJSON_Parse(buf);
@@ -617,17 +842,19 @@ result_t TEALidarDriver::connect(const char *port_path, uint32_t baudrate) {
     }
     configPortDisconnect();
 
-    if (!dataPortConnect(NULL, m_data_port)) {
+    //共享接收时数据端口由接收线程统一监听
+    if (!m_sharedData && !dataPortConnect(NULL, m_data_port)) {
         setDriverError(NotOpenError);
         return RESULT_FAIL;
     }
 
-    if (!listPortConnect(NULL, m_list_port)) {
+    if (!m_sharedData && !listPortConnect(NULL, m_list_port)) {
         setDriverError(NotOpenError);
         return RESULT_FAIL;
     }
 
     setIsConnected(true);
+    notifyStateChanged(LidarStateConnected);
 
     LOGD("Network connect success!");
     return RESULT_OK;
@@ -635,39 +862,32 @@ result_t TEALidarDriver::connect(const char *port_path, uint32_t baudrate) {
 
 
 void TEALidarDriver::disconnect() {
+    bool connected = getIsConnected();
     configPortDisconnect();
     dataPortDisconnect();
     listPortDisconnect();
     setIsConnected(false);
+    if (connected) {
+        notifyStateChanged(LidarStateDisconnected);
+    }
     LOGD("Network disconnection!");
 }
 
 
-result_t TEALidarDriver::grabScanData(node_info *nodebuffer, size_t &count, uint32_t timeout) {
-    switch (m_DataEvent.wait(timeout)) {
-
-        case Event::EVENT_TIMEOUT: {
-            count = 0;
-            return RESULT_TIMEOUT;
-        }
-
-        case Event::EVENT_OK: {
-            if (m_ScanNodeCount == 0) {
-                return RESULT_FAIL;
-            }
-
-            ScopedLocker l(m_Lock);
-            size_t size_to_copy = std::min(count, m_ScanNodeCount);
-            memcpy(nodebuffer, m_ScanNodeBuf, size_to_copy * sizeof(node_info));
-            count = size_to_copy;
-            m_ScanNodeCount = 0;
-            return RESULT_OK;
-        }
-        
-        default:
-            count = 0;
-            return RESULT_FAIL;
+result_t TEALidarDriver::grabScanData(node_info *nodebuffer, size_t &count, uint32_t timeout,
+                                      scan_sequence *sequence) {
+    TRACE_SCOPE("GrabScanData");
+    scan_sequence local = {0, 0, 0};
+    if (!sequence) {
+        sequence = &local;
+    }
+    result_t ans = m_ScanQueue.pop(nodebuffer, count, sequence, timeout);
+    if (IS_OK(ans)) {
+        m_Latency.record(LatencyStageHandoff, getus() - sequence->pushed);
+        m_Metrics.scansConsumed.add();
+        m_Metrics.queuedScans.set(m_ScanQueue.size());
     }
+    return ans;
 }
 
 
@@ -681,11 +901,14 @@ result_t TEALidarDriver::startScan(uint32_t timeout) {
         return RESULT_FAIL;
     }
     setIsScanning(true);  
-    if (!IS_OK(createThread())){
+    m_ScanQueue.clear();
+    resetDecodeState();
+    if (!m_sharedData && !IS_OK(createThread())){
         setIsScanning(false);  
         stopMeasure();
         return RESULT_FAIL;
     }
+    notifyStateChanged(LidarStateScanning);
     LOGD("The radar starts scanning");
     return RESULT_OK;
 }
@@ -707,6 +930,7 @@ result_t TEALidarDriver::stopScan(uint32_t timeout) {
     }
     setIsScanning(false);  
     disableDataGrabbing();
+    notifyStateChanged(getIsConnected() ? LidarStateConnected : LidarStateDisconnected);
     LOGD("Radar stop scanning");
     return RESULT_OK;
 }
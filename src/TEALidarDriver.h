@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <core/common/DriverInterface.h>
 #include <core/network/PassiveSocket.h>
+#include <core/common/ydlidar_protocol.h>
 
 namespace ydlidar {
 
@@ -27,6 +28,29 @@ private:
     vector<NetLidarListInfo> m_lidarList;
     NetLidarConfig m_lidarConfig;
 
+    //waitScanData 在两帧之间保留的状态
+    uint16_t m_lastPointAngle;      ///< decoded angle of the last point, before the orientation
+    uint8_t m_lastFrameNum;         ///< frame counter of the last frame, 0xff before the first
+    uint8_t m_pending[DATA_ONESIZE];///< bytes received after the last frame tail
+    int m_pendingSize;
+    uint64_t m_stampWraps;          ///< time stamp overflow count
+    uint64_t m_lastStamp;           ///< extended time stamp of the last frame
+    uint32_t m_lastStampRaw;        ///< raw time stamp of the last frame
+
+    //cacheScanData 组包的状态，feedDatagram 也使用
+    vector<node_info> m_scanNodes;  ///< revolution being assembled
+    size_t m_scanCount;
+    uint64_t m_scanStartUs;         ///< time the revolution started, 0 after a gap
+
+    //feedDatagram 拼包的状态
+    NetDataFrame m_feedFrame;
+    uint8_t m_feedTail;             ///< bytes of the frame tail matched so far
+    int m_feedSize;                 ///< bytes of m_feedFrame filled, -1 while looking for the tail
+    bool m_feedSkipped;             ///< bytes were dropped before the tail
+    uint64_t m_feedStart;           ///< time the tail was found
+    size_t m_feedTimeouts;          ///< consecutive ::feedTimeout calls
+    bool m_sharedData;              ///< datagrams are fed by a shared reactor
+
 public:
     /**
      * @par Constructor
@@ -40,6 +64,68 @@ public:
      */
     ~TEALidarDriver();
 
+/*--------------------------------------------------------------------------------------------------------------
+                                              可被派生类（回放驱动）重载的函数
+---------------------------------------------------------------------------------------------------------------*/
+protected:
+
+    /**
+     * @brief Transfer command by tcp \n
+     * @param[in] transBuf      command buffer
+     * @param[in] transLen      command length
+     * @param[out] recvBuf      recv buffer
+     * @param[out] recvMaxSize  recv max size
+     * @retval true  success
+     * @retval fase  failed
+     */
+    virtual bool configPortTransfer(char *transBuf, int transLen, char *recvBuf, int recvMaxSize);
+
+    /**
+     * @brief Reconnect to the network \n
+     * @return result status
+     * @retval RESULT_OK       success
+     * @retval RESULT_FAILE    failed
+     */
+    virtual result_t checkAutoConnecting();
+
+    /**
+     * @brief Receiving the scan data \n
+     * @return datagram size, negative on timeout
+     */
+    virtual int32_t receiveData(uint8_t *buf, uint32_t len);
+
+    /**
+     * @brief explaining the scan data \n
+     * Reassembles and decodes one ::NetDataFrame from ::receiveData
+     */ 
+    result_t waitScanData(node_info *nodebuffer, size_t &count, uint32_t timeout = DEFAULT_TIMEOUT);  
+
+    /**
+     * @brief Decode one reassembled ::NetDataFrame \n
+     * @param[in] frame        frame following the tail marker
+     * @param[out] nodebuffer  DATABLOCK_COUNT * DATA_COUNT nodes
+     * @param[out] count       nodes written
+     * @param[in] frameDone    time the frame was complete, microseconds
+     * @retval RESULT_FAIL     a frame was lost before this one
+     */
+    result_t decodeFrame(const NetDataFrame &frame, node_info *nodebuffer, size_t &count, uint64_t frameDone);
+
+    /**
+     * @brief Hand a decoded frame to the listener and assemble it into the revolution \n
+     * @param[in] frame_us     time the frame was decoded, microseconds
+     */
+    void publishFrame(const node_info *local_buf, size_t count, uint64_t frame_us);
+
+    /**
+     * @brief Creating a Process to receiving scan data \n
+     */
+    result_t createThread();
+
+    /**
+     * @brief Forget the partial frame and counters kept between frames \n
+     */
+    void resetDecodeState();
+
 /*--------------------------------------------------------------------------------------------------------------
                                                      本类的私有函数
 ---------------------------------------------------------------------------------------------------------------*/
@@ -61,17 +147,6 @@ private:
      */
     bool configPortDisconnect();   
 
-    /**
-     * @brief Transfer command by tcp \n
-     * @param[in] transBuf      command buffer
-     * @param[in] transLen      command length
-     * @param[out] recvBuf      recv buffer
-     * @param[out] recvMaxSize  recv max size
-     * @retval true  success
-     * @retval fase  failed
-     */
-    bool configPortTransfer(char *transBuf, int transLen, char *recvBuf, int recvMaxSize);
-
     /**
      * @brief Transfer command by tcp \n
      * @param[in] transBuf      The command buffer
@@ -138,34 +213,11 @@ private:
      */
     bool listPortDisconnect();
 
-    /**
-     * @brief Reconnect to the network \n
-     * @return result status
-     * @retval RESULT_OK       success
-     * @retval RESULT_FAILE    failed
-     */
-    result_t checkAutoConnecting();
-
-    /**
-     * @brief Receiving the scan data \n
-     */ 
-    int32_t receiveData(uint8_t *buf, uint32_t len);
-
-    /**
-     * @brief explaining the scan data \n
-     */ 
-    result_t waitScanData(node_info *nodebuffer, size_t &count, uint32_t timeout = DEFAULT_TIMEOUT);  
-
     /**
      * @brief cache the scan data \n
      */ 
     int cacheScanData();
 
-    /**
-     * @brief Creating a Process to receiving scan data \n
-     */   
-    result_t createThread();  
-
     /**
      * @brief Receiving broadcast data \n
      */
@@ -205,12 +257,14 @@ public:
      * @param[in] nodebuffer Laser data
      * @param[in] count      one circle of laser points
      * @param[in] timeout    timeout
+     * @param[out] sequence  scan sequence and drop count, may be NULL
      * @return return status
      * @retval RESULT_OK       success
      * @retval RESULT_FAILE    failed
      * @note Before starting, you must start the start the scan successfully with the ::startScan function
      */
-    virtual result_t grabScanData(node_info *nodebuffer, size_t &count, uint32_t timeout = DEFAULT_TIMEOUT);
+    virtual result_t grabScanData(node_info *nodebuffer, size_t &count, uint32_t timeout = DEFAULT_TIMEOUT,
+                                  scan_sequence *sequence = NULL);
 
     /**
      * @brief Turn on scanning \n
@@ -324,6 +378,28 @@ public:
      * @return online lidars
      */
     virtual map<string, string> lidarPortList(); 
+
+    /**
+     * @brief Receive the data port datagrams from a shared reactor \n
+     * @param[in] shared    true to skip the data and list sockets and the decode thread
+     * @note Set it before ::connect
+     */
+    virtual bool setSharedData(bool shared);
+
+    /**
+     * @brief Reassemble, decode and publish one data port datagram \n
+     * @param[in] data      datagram payload
+     * @param[in] len       datagram size
+     * @param[in] addr      sender address, network byte order
+     * @param[in] port      sender port
+     * @param[in] stamp     kernel receive time, microseconds since the epoch, 0 if unknown
+     */
+    virtual void feedDatagram(const uint8_t *data, size_t len, uint32_t addr, uint16_t port, uint64_t stamp);
+
+    /**
+     * @brief No datagram arrived within the timeout \n
+     */
+    virtual void feedTimeout();
 };
 
 } // namespace ydlidar
@@ -0,0 +1,57 @@
+#ifndef FILTERGEOMETRY_H
+#define FILTERGEOMETRY_H
+#include <math.h>
+#include <vector>
+#include "math/angles.h"
+
+namespace filters {
+
+/// sin and cos of every 0.01 degree, the angle step of CYdLidar scans
+struct AngleTable {
+    enum {
+        STEPS = 36000,
+    };
+    std::vector<double> sinv;
+    std::vector<double> cosv;
+
+    AngleTable() : sinv(STEPS), cosv(STEPS) {
+        for (int k = 0; k < STEPS; k++) {
+            //与CYdLidar相同的float角度，查表结果与直接计算完全一致
+            double rad = ydlidar::core::math::from_degrees(static_cast<float>(k / 100.0f));
+            sinv[k] = sin(rad);
+            cosv[k] = cos(rad);
+        }
+    }
+
+    /// sin and cos of an angle in degrees
+    void sinCos(float angle, double &s, double &c) const {
+        long k = lround(angle * 100.0);
+        if (k >= 0 && k < STEPS && static_cast<float>(k / 100.0f) == angle) {
+            s = sinv[k];
+            c = cosv[k];
+        } else {
+            //不在0.01度网格上的角度（如外部滤波修改过的扫描）直接计算
+            double rad = ydlidar::core::math::from_degrees(angle);
+            s = sin(rad);
+            c = cos(rad);
+        }
+    }
+};
+
+inline const AngleTable &angleTable() {
+    static AngleTable table;
+    return table;
+}
+
+/// signed distance from the origin to the line through two points, the
+/// second point's coordinates rotated onto the line's normal
+inline double lineOffset(double x1, double y1, double x2, double y2) {
+    double dx = x2 - x1;
+    double dy = y2 - y1;
+    double d = sqrt(dx * dx + dy * dy);
+    return d > 0 ? (x2 * y1 - x1 * y2) / d : y2;
+}
+
+}
+
+#endif // FILTERGEOMETRY_H
@@ -8,6 +8,13 @@ class FilterInterface
 public:
     FilterInterface() {}
     virtual ~FilterInterface() {}
+    /**
+     * @brief Filter one scan
+     * @param in         scan as built by CYdLidar, angles in degrees
+     * @param lidarType  lidar type code
+     * @param version    firmware version, 0 if unknown
+     * @param out        filtered scan, may be the same object as in
+     */
     virtual void filter(const LaserScan &in,
                          int lidarType,
                          int version,
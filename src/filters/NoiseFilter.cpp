@@ -1,6 +1,12 @@
 #include <math.h>
 #include "NoiseFilter.h"
 #include "math/angles.h"
+#include "FilterGeometry.h"
+
+using filters::AngleTable;
+using filters::angleTable;
+using filters::lineOffset;
+
 
 NoiseFilter::NoiseFilter()
     : minIncline(0.11),
@@ -18,45 +24,29 @@ NoiseFilter::~NoiseFilter()
 {
 }
 
-//计算两点连线和原点的夹角（弧度）
-double NoiseFilter::calcInclineAngle(
-        double reading1,
-        double reading2,
-        double angleBetweenReadings) const
+void NoiseFilter::prepare(const LaserScan &in)
 {
-    return atan2(sin(angleBetweenReadings) * reading2,
-                 reading1 - (cos(angleBetweenReadings) * reading2));
-}
-
-//计算两点的倾斜角（弧度）
-double NoiseFilter::calcTargetAngle(
-        double reading1,
-        double angle1,
-        double reading2,
-        double angle2)
-{
-    double reading1_x = reading1 * cos(angle1);
-    double reading1_y = reading1 * sin(angle1);
-    double reading2_x = reading2 * cos(angle2);
-    double reading2_y = reading2 * sin(angle2);
-    double dx = reading2_x - reading1_x;
-    double dy = reading2_y - reading1_y;
-    return atan2(dy, dx);
-}
+    const AngleTable &table = angleTable();
+    const size_t size = in.points.size();
+    m_sin.resize(size);
+    m_cos.resize(size);
+    m_x.resize(size);
+    m_y.resize(size);
+
+    for (size_t i = 0; i < size; i++) {
+        table.sinCos(in.points[i].angle, m_sin[i], m_cos[i]);
+    }
 
-double NoiseFilter::calcTargetOffset(
-        double reading1,
-        double angle1,
-        double reading2,
-        double angle2)
-{
-    double target_angle = calcTargetAngle(reading1, angle1, reading2, angle2);
-    double cos_inv_angle = cos(-target_angle);
-    double sin_inv_angle = sin(-target_angle);
-    double reading2_x = reading2 * cos(angle2);
-    double reading2_y = reading2 * sin(angle2);
-    double offset = reading2_x * sin_inv_angle + reading2_y * cos_inv_angle;
-    return offset;
+    //无分支的逐点乘法，可被编译器向量化
+    const double *c = &m_cos[0];
+    const double *sn = &m_sin[0];
+    double *x = &m_x[0];
+    double *y = &m_y[0];
+    for (size_t i = 0; i < size; i++) {
+        double range = in.points[i].range;
+        x[i] = range * c[i];
+        y[i] = range * sn[i];
+    }
 }
 
 bool NoiseFilter::isRangeValid(const LaserConfig &config,
@@ -84,48 +74,41 @@ void NoiseFilter::filter_noise(
 {
     //range is empty
     if (in.points.empty()) {
-        out = in;
+        if (&out != &in) {
+            out = in;
+        }
         return;
     }
 
-    std::vector<bool> maskedPoints;
+    std::vector<bool> &maskedPoints = m_masked;
     double lastRange = in.points[0].range;
-    double lastAngle = in.points[0].angle;
-    double lastInclineRange = lastRange;
     const int nrPoints = in.points.size();
-    maskedPoints.resize(nrPoints, false);
-    double lastIncline = 0;
-    bool hasFirst = false;
+    maskedPoints.assign(nrPoints, false);
+    prepare(in);
+    const double *x = &m_x[0];
+    const double *y = &m_y[0];
 
-    //copy attributes to filtered scan
-    out = in;
+    //copy attributes to filtered scan, nothing to copy when filtering in place
+    if (&out != &in) {
+        out = in;
+    }
     int pointCount  = 0;
-    double lastOffset = 0;
     double lastDistance = lastRange;
-    double preAngle = lastAngle;
-    double lastDiff = 0;
-    bool isIncrease = false;
+    int last = 0; //上一个点的索引
+    int lastValid = 0; //上一个有效点的索引，对应lastDistance
     int minIndex = 0;
-    double minIndexDistance = 0;
     double maxDistance = 0;
     bool isNoise = false;
     float filter_offset = 0.05;
 
     for (int i = 0; i < nrPoints; i++) {
         double current_range = in.points[i].range;//current lidar distance
-        double current_angle = in.points[i].angle;//current lidar angle
 
         if (isRangeValid(in.config, current_range)) {
 
-            double offset;
-
-            if (isRangeValid(in.config, lastRange)) {
-                offset = calcTargetOffset(lastRange, lastAngle, current_range,
-                                          current_angle);//calculate offset distance
-            } else {
-                offset = calcTargetOffset(lastDistance, preAngle, current_range,
-                                          current_angle);//calculate offset distance
-            }
+            //calculate offset distance
+            int from = isRangeValid(in.config, lastRange) ? last : lastValid;
+            double offset = lineOffset(x[from], y[from], x[i], y[i]);
 
             double Diff = current_range - lastDistance;//distance difference
 
@@ -144,7 +127,6 @@ void NoiseFilter::filter_noise(
             if (isNoise) {
                 if (pointCount == 0) {
                     minIndex = i;
-                    minIndexDistance = current_range;
                 }
 
                 if (current_range > maxDistance) {
@@ -179,14 +161,11 @@ void NoiseFilter::filter_noise(
 
             } else {
                 if (pointCount >= 2) {
-                    bool isincre = (in.points[minIndex].range - lastDistance) < 0;
-
                     for (int j = minIndex - nonMaskedNeighbours; j <= i + nonMaskedNeighbours;
                          j++) {
                         if (j >= 0 && j < nrPoints) {
-                            double offset = calcTargetOffset(in.points[j].range, in.points[j].angle,
-                                                             lastDistance,
-                                                             preAngle);//calculate offset distance
+                            double offset = lineOffset(x[j], y[j], x[lastValid],
+                                                       y[lastValid]);//calculate offset distance
 
                             if (in.points[j].range > maxDistance) {
                                 maxDistance = in.points[j].range;
@@ -205,13 +184,11 @@ void NoiseFilter::filter_noise(
                 maxDistance = 0.0;
             }
 
-            lastOffset = offset;//last offset
-            lastDiff = Diff;//last distance difference
             lastDistance = current_range;//last distance
-            preAngle = current_angle;
+            lastValid = i;
         }
 
-        lastAngle = current_angle;//last angle
+        last = i;
         lastRange = current_range;//last range
     }
 
@@ -258,21 +235,27 @@ void NoiseFilter::filter_tail(
 
     //range is empty
     if (in.points.empty()) {
-        out = in;
+        if (&out != &in) {
+            out = in;
+        }
         return;
     }
 
-    std::vector<bool> maskedPoints;
-    double lastRange = in.points[0].range;
-    double lastAngle = in.points[0].angle;
-    double lastInclineRange = lastRange;
+    std::vector<bool> &maskedPoints = m_masked;
     const int size = in.points.size();
-    maskedPoints.resize(size, false);
+    maskedPoints.assign(size, false);
     double lastIncline = 0;
     bool hasFirst = false;
-
-    //copy attributes to filtered scan
-    out = in;
+    prepare(in);
+    const double *x = &m_x[0];
+    const double *y = &m_y[0];
+    const double *sn = &m_sin[0];
+    const double *c = &m_cos[0];
+
+    //copy attributes to filtered scan, nothing to copy when filtering in place
+    if (&out != &in) {
+        out = in;
+    }
     double lastDistance = 0;
     int max_skip_step = 5 * maskedNeighbours;
 
@@ -288,17 +271,18 @@ void NoiseFilter::filter_tail(
     for (int i = 0; i < size; i++)
     {
         double range = in.points[i].range;//current lidar distance
-        double angle = in.points[i].angle;//current lidar angle
+        int last = i ? i - 1 : 0; //上一个点，与有效性无关
 
         if (isRangeValid(in.config, range)
                 /*&& isRangeValid(in.config, lastDistance)*/)
         {
             if (maskedFilter && isRangeValid(in.config, lastDistance))
             {
-                const double incline = calcInclineAngle(
-                            in.points[i].range,
-                            lastDistance,
-                            angle - lastAngle);
+                //与上一个点的角度差的正余弦由两点的正余弦得到
+                double sinDiff = sn[i] * c[last] - c[i] * sn[last];
+                double cosDiff = c[i] * c[last] + sn[i] * sn[last];
+                const double incline = atan2(sinDiff * lastDistance,
+                                             range - cosDiff * lastDistance);
 
                 if (!hasFirst) {
                     hasFirst = true;
@@ -315,7 +299,7 @@ void NoiseFilter::filter_tail(
                     for (int j = -maskedNeighbours; j < maskedNeighbours; j++)
                     {
                         if ((int(i) + j < 0)
-                                || ((int(i) + j) > size)) {
+                                || ((int(i) + j) >= size)) {
                             continue;
                         }
                         if (i + j - 1 < 0) {
@@ -323,10 +307,8 @@ void NoiseFilter::filter_tail(
                         }
 
                         //如果当前点相邻N点中有偏移量较大的点则认为是噪点
-                        double offset = calcTargetOffset(in.points[i + j - 1].range,
-                                in.points[i + j - 1].angle,
-                                in.points[i + j].range,
-                                in.points[i + j].angle); //calculate offset distance
+                        double offset = lineOffset(x[i + j - 1], y[i + j - 1],
+                                                   x[i + j], y[i + j]); //calculate offset distance
                         if (offset < 0.2) {
                             maskedPoints[i + j] = true;
                             isValid = true;
@@ -355,7 +337,6 @@ void NoiseFilter::filter_tail(
                     maskedPoints[i] = true;
                 }
 
-                lastInclineRange = range;
                 lastIncline = incline;
             }
 
@@ -369,8 +350,6 @@ void NoiseFilter::filter_tail(
             }
         }
 
-        lastAngle = angle;//last angle
-        lastRange = range;//last range
     }
 
     /*for (int i = 0; i < m_block_vct.size(); i++) {
@@ -445,7 +424,9 @@ void NoiseFilter::filter_tail2(
     //              m_Name.toStdString().c_str(),
     //              in.points.size());
 
-    out = in;
+    if (&out != &in) {
+        out = in;
+    }
 
     if (in.points.empty()) {
         return;
@@ -456,41 +437,47 @@ void NoiseFilter::filter_tail2(
     //3、判断该点序列的强度信息是否满足约定条件（未找到规律，暂未使用）
     //4、去掉该点序列的首尾点（首尾点是正常的）
 
-    std::vector<bool> noises; //是否为噪点的标记
+    std::vector<bool> &noises = m_masked; //是否为噪点的标记
     size_t size = in.points.size(); //一圈点数
     size_t lastIndex = 0; //上一个有效点的索引位置
-    LaserPoint lastP; //上一个点信息
+    size_t lastP = 0; //上一个有效点在扫描中的下标
+    bool hasLast = false; //是否已有上一个有效点
     float lastIncline = .0; //上一个倾斜角
     float lastAngle = 90.0; //上一个夹角
     size_t pos = 0; //标记拖尾起始点下标位置
     //    bool hasNoise = false; //是否需要处理噪点的标志
     size_t sizeEx = size + (size * 2 / 100 + 1); //将遍历范围扩大到原数组的102%以便处理首尾部分的点
 
-    noises.resize(size, false);
+    noises.assign(size, false);
+    prepare(in);
+    const double *x = &m_x[0];
+    const double *y = &m_y[0];
+    const double *sn = &m_sin[0];
+    const double *c = &m_cos[0];
 
     //主循环函数
     for (size_t i = 0; i < sizeEx; ++i)
     {
-        const LaserPoint& p = in.points.at(i % size);
+        const size_t k = i % size;
+        const LaserPoint& p = in.points[k];
 
         if (!isRangeValid(in.config, p.range))
         {
             continue;
         }
 
-        if (i != 0)
+        if (hasLast)
         {
             //计算两点连线、两点中间点到原点连线的倾斜角（弧度值）
-            float incline2 = calcTargetAngle(
-                        lastP.range,
-                        lastP.angle,
-                        p.range,
-                        p.angle);
-            float incline3 = calcTargetAngle(
-                        (lastP.range + p.range) / 2.0f,
-                        (lastP.angle + p.angle) / 2.0f,
-                        0.0f,
-                        0.0f);
+            float incline2 = atan2(y[k] - y[lastP], x[k] - x[lastP]);
+            //中间角的方向即两点单位向量之和的方向，两点角度相差超过180度时方向相反
+            double midSin = sn[lastP] + sn[k];
+            double midCos = c[lastP] + c[k];
+            if (fabs(in.points[lastP].angle - p.angle) > 180.0f) {
+                midSin = -midSin;
+                midCos = -midCos;
+            }
+            float incline3 = atan2(-midSin, -midCos);
             //转角度值
             incline2 = ydlidar::core::math::to_degrees(incline2);
             incline3 = ydlidar::core::math::to_degrees(incline3);
@@ -533,7 +520,7 @@ void NoiseFilter::filter_tail2(
                         size_t validCount = 0;
                         for (size_t j=pos; j<=i; ++j)
                         {
-                            if (isRangeValid(in.config, in.points[i % size].range))
+                            if (isRangeValid(in.config, in.points[j % size].range))
                                 validCount += 1;
                         }
                         if (validCount >= MIN_NOISEPOINT_COUNT)
@@ -563,26 +550,27 @@ void NoiseFilter::filter_tail2(
         }
 
         lastIndex = i;
-        lastP = p;
+        lastP = k;
+        hasLast = true;
     }
 
     //处理被标记的点
-    size_t noiseCount = 0;
     for (size_t i = 0; i < size; ++i)
     {
         if (noises[i])
         {
             out.points[i].range = 0.0f;
-            noiseCount ++;
         }
     }
-    printf("Noise count %lu\n", noiseCount);
 }
 
 void NoiseFilter::setStrategy(int value)
 {
     FilterInterface::setStrategy(value);
 
+    //从默认值重新计算，重复设置策略时不会累积缩放
+    maxIncludeAngle = MAX_INCLUDE_ANGLE;
+    maxInclineAngle = MAX_INCLINE_ANGLE;
     if (m_strategy == FS_TailWeek)
     {
         maxIncludeAngle /= 3.0f;
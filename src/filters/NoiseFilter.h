@@ -1,5 +1,6 @@
 #ifndef NOISEFILTER_H
 #define NOISEFILTER_H
+#include <vector>
 #include "FilterInterface.h"
 
 #define MAX_INCLUDE_ANGLE 12.0f //最大夹角
@@ -13,6 +14,10 @@ struct FilterBlock
     int end_index;
 };
 
+/**
+ * @brief Mark noise and tail smear points invalid (range 0).
+ * Not thread safe, the masks are reused between scans.
+ */
 class NoiseFilter : public FilterInterface
 {
 public:
@@ -51,30 +56,6 @@ protected:
                       int version,
                       LaserScan &out);
 
-    double calcInclineAngle(double reading1, double reading2,
-                            double angleBetweenReadings) const;
-    /**
-   * @brief getTargtAngle
-   * @param reading1
-   * @param angle1
-   * @param reading2
-   * @param angle2
-   * @return
-   */
-    double calcTargetAngle(double reading1, double angle1,
-                           double reading2, double angle2);
-
-    /**
-   * @brief calculateTargetOffset
-   * @param reading1
-   * @param angle1
-   * @param reading2
-   * @param angle2
-   * @return
-   */
-    double calcTargetOffset(double reading1, double angle1,
-                            double reading2, double angle2);
-
     /**
    * @brief isRangeValid
    * @param reading
@@ -89,6 +70,13 @@ protected:
    */
     bool isIncreasing(double value) const;
 
+    /**
+   * @brief Compute the sine, cosine and Cartesian coordinates of every point
+   * once per scan, the angles come from a 0.01 degree table
+   * @param in
+   */
+    void prepare(const LaserScan &in);
+
     /**
    * Defines how many readings next to an invalid reading get marked as invalid
    * */
@@ -102,6 +90,12 @@ protected:
 
     float maxIncludeAngle = MAX_INCLUDE_ANGLE;
     float maxInclineAngle = MAX_INCLINE_ANGLE;
+
+    std::vector<bool> m_masked; //噪点标记，复用以免每圈分配
+    std::vector<double> m_sin; //每点角度的正弦
+    std::vector<double> m_cos; //每点角度的余弦
+    std::vector<double> m_x; //每点的直角坐标，单位米
+    std::vector<double> m_y;
 };
 
 #endif // NOISEFILTER_H
@@ -0,0 +1,395 @@
+#include <math.h>
+#include "StreamingNoiseFilter.h"
+#include "NoiseFilter.h"
+#include "FilterGeometry.h"
+
+using filters::angleTable;
+using filters::lineOffset;
+
+
+StreamingNoiseFilter::StreamingNoiseFilter()
+    : m_strategy(NoiseFilter::FS_Normal),
+      m_delay(16),
+      m_base(0),
+      m_next(0),
+      minIncline(0.11),
+      maxIncline(3.0),
+      nonMaskedNeighbours(4),
+      maskedNeighbours(2),
+      maxIncludeAngle(MAX_INCLUDE_ANGLE),
+      maxInclineAngle(MAX_INCLINE_ANGLE)
+{
+    m_config.min_range = 0;
+    m_config.max_range = 0;
+    m_config.time_increment = 0;
+    setStrategy(NoiseFilter::FS_Normal);
+}
+
+void StreamingNoiseFilter::setStrategy(int value)
+{
+    m_strategy = value;
+
+    //与NoiseFilter::setStrategy相同的阈值
+    maxIncludeAngle = MAX_INCLUDE_ANGLE;
+    maxInclineAngle = MAX_INCLINE_ANGLE;
+    if (m_strategy == NoiseFilter::FS_TailWeek)
+    {
+        maxIncludeAngle /= 3.0f;
+        maxInclineAngle /= 3.0f;
+    }
+    else if (m_strategy == NoiseFilter::FS_TailStrong2)
+    {
+        maxIncludeAngle *= 1.5f;
+        maxInclineAngle *= 1.5f;
+    }
+    resetState();
+}
+
+void StreamingNoiseFilter::setDelay(size_t points)
+{
+    m_delay = points;
+}
+
+size_t StreamingNoiseFilter::delay() const
+{
+    size_t least = minDelay();
+    return m_delay > least ? m_delay : least;
+}
+
+size_t StreamingNoiseFilter::minDelay() const
+{
+    //处理点需要的后续点数，加上标记能回溯到的前面点数
+    if (NoiseFilter::FS_Normal == m_strategy) {
+        return lookahead() + nonMaskedNeighbours + MIN_NOISEPOINT_COUNT;
+    }
+    if (NoiseFilter::FS_Tail == m_strategy) {
+        //最前面的邻点还要和它的前一个点计算偏移
+        return lookahead() + maskedNeighbours + 1;
+    }
+    return lookahead() + MIN_NOISEPOINT_COUNT + 1;
+}
+
+size_t StreamingNoiseFilter::lookahead() const
+{
+    if (NoiseFilter::FS_Normal == m_strategy) {
+        return nonMaskedNeighbours;
+    }
+    if (NoiseFilter::FS_Tail == m_strategy) {
+        return maskedNeighbours > 0 ? maskedNeighbours - 1 : 0;
+    }
+    return 0;
+}
+
+void StreamingNoiseFilter::reset()
+{
+    m_window.clear();
+    m_base = 0;
+    m_next = 0;
+    resetState();
+}
+
+void StreamingNoiseFilter::resetState()
+{
+    m_started = false;
+    m_lastRange = 0;
+    m_lastX = m_lastY = 0;
+    m_lastDistance = 0;
+    m_validX = m_validY = 0;
+    m_isNoise = false;
+    m_filterOffset = 0.05;
+    m_pointCount = 0;
+    m_minIndex = 0;
+    m_maxDistance = 0;
+
+    m_tailDistance = 0;
+    m_tailIncline = 0;
+    m_hasFirst = false;
+
+    m_hasLast = false;
+    m_lastIndex = 0;
+    m_lastIncline = .0;
+    m_lastAngle = 90.0;
+    m_pos = -1;
+}
+
+bool StreamingNoiseFilter::isRangeValid(double reading) const
+{
+    return reading >= m_config.min_range && reading <= m_config.max_range;
+}
+
+size_t StreamingNoiseFilter::push(const LaserScan &in, LaserScan &out)
+{
+    const filters::AngleTable &table = angleTable();
+    m_config = in.config;
+    for (size_t i = 0; i < in.points.size(); i++) {
+        StreamPoint p;
+        p.point = in.points[i];
+        p.stamp = in.stamp + static_cast<uint64_t>(i * in.config.time_increment * 1e9);
+        table.sinCos(p.point.angle, p.s, p.c);
+        p.x = p.point.range * p.c;
+        p.y = p.point.range * p.s;
+        p.masked = false;
+        m_window.push_back(p);
+    }
+
+    //先读完输入再写输出，out可以就是in
+    process(false);
+    return emit(out, false);
+}
+
+size_t StreamingNoiseFilter::flush(LaserScan &out)
+{
+    process(true);
+    return emit(out, true);
+}
+
+void StreamingNoiseFilter::process(bool final)
+{
+    const uint64_t count = end();
+    const size_t ahead = lookahead();
+    while (m_next < count && (final || m_next + ahead < count)) {
+        if (NoiseFilter::FS_Normal == m_strategy) {
+            step_noise(m_next);
+        } else if (NoiseFilter::FS_Tail == m_strategy) {
+            step_tail(m_next);
+        } else {
+            step_tail2(m_next);
+        }
+        m_next++;
+    }
+}
+
+size_t StreamingNoiseFilter::emit(LaserScan &out, bool final)
+{
+    const size_t held = delay();
+    out.config = m_config;
+    out.points.clear();
+    out.stamp = 0;
+    while (!m_window.empty() && m_base < m_next && (final || m_base + held < end())) {
+        const StreamPoint &p = m_window.front();
+        if (out.points.empty()) {
+            out.stamp = p.stamp;
+        }
+        out.points.push_back(p.point);
+        if (p.masked) {
+            out.points.back().range = 0.0f;
+        }
+        m_window.pop_front();
+        m_base++;
+    }
+    out.config.scan_time = out.config.time_increment * out.points.size();
+    return out.points.size();
+}
+
+//逐点的NoiseFilter::filter_noise，点序号为流内序号
+void StreamingNoiseFilter::step_noise(uint64_t i)
+{
+    StreamPoint &p = at(i);
+    double current_range = p.point.range;
+
+    if (!m_started) {
+        m_started = true;
+        m_lastRange = current_range;
+        m_lastX = m_validX = p.x;
+        m_lastY = m_validY = p.y;
+        m_lastDistance = current_range;
+    }
+
+    if (isRangeValid(current_range)) {
+        bool lastValid = isRangeValid(m_lastRange);
+        double offset = lineOffset(lastValid ? m_lastX : m_validX,
+                                   lastValid ? m_lastY : m_validY, p.x, p.y);
+        double Diff = current_range - m_lastDistance;
+
+        if (fabs(Diff) > m_lastDistance * 0.2 && fabs(offset) < 0.2 &&
+                isRangeValid(m_lastDistance)) {
+            m_isNoise = true;
+            m_filterOffset = fabs(offset) + 0.05;
+            m_maxDistance = current_range;
+            p.masked = true;
+        }
+
+        if (m_isNoise && fabs(offset) > m_filterOffset) {
+            m_isNoise = false;
+        }
+
+        if (m_isNoise) {
+            if (m_pointCount == 0) {
+                m_minIndex = i;
+            }
+
+            if (current_range > m_maxDistance) {
+                m_maxDistance = current_range;
+            }
+
+            m_pointCount++;
+        } else {
+            if (m_pointCount >= 2) {
+                //超出窗口的前面点已发出，只标记窗口内的点
+                int64_t first = m_minIndex - nonMaskedNeighbours;
+                int64_t last = i + nonMaskedNeighbours;
+                if (first < static_cast<int64_t>(m_base)) {
+                    first = m_base;
+                }
+                if (last >= static_cast<int64_t>(end())) {
+                    last = end() - 1;
+                }
+                for (int64_t j = first; j <= last; j++) {
+                    StreamPoint &q = at(j);
+                    double offset = lineOffset(q.x, q.y, m_validX, m_validY);
+
+                    if (q.point.range > m_maxDistance) {
+                        m_maxDistance = q.point.range;
+                    }
+
+                    if (offset < m_filterOffset && m_maxDistance > m_filterOffset &&
+                            m_maxDistance > 0.2) {
+                        q.masked = true;
+                    }
+                }
+            }
+
+            m_pointCount = 0;
+            m_minIndex = 0;
+            m_maxDistance = 0.0;
+        }
+
+        m_lastDistance = current_range;
+        m_validX = p.x;
+        m_validY = p.y;
+    }
+
+    m_lastX = p.x;
+    m_lastY = p.y;
+    m_lastRange = current_range;
+}
+
+//逐点的NoiseFilter::filter_tail
+void StreamingNoiseFilter::step_tail(uint64_t i)
+{
+    StreamPoint &p = at(i);
+    double range = p.point.range;
+
+    if (!isRangeValid(range)) {
+        return;
+    }
+
+    if (isRangeValid(m_tailDistance)) {
+        const StreamPoint &last = i > m_base ? at(i - 1) : p;
+        double sinDiff = p.s * last.c - p.c * last.s;
+        double cosDiff = p.c * last.c + p.s * last.s;
+        const double incline = atan2(sinDiff * m_tailDistance,
+                                     range - cosDiff * m_tailDistance);
+
+        if (!m_hasFirst) {
+            m_hasFirst = true;
+            m_tailIncline = incline;
+        }
+
+        if (incline < minIncline || incline > maxIncline) {
+            for (int j = -maskedNeighbours; j < maskedNeighbours; j++) {
+                int64_t k = static_cast<int64_t>(i) + j;
+                if (k - 1 < static_cast<int64_t>(m_base) || k >= static_cast<int64_t>(end())) {
+                    continue;
+                }
+                const StreamPoint &a = at(k - 1);
+                StreamPoint &b = at(k);
+                if (lineOffset(a.x, a.y, b.x, b.y) < 0.2) {
+                    b.masked = true;
+                }
+            }
+        }
+
+        if (fabs(m_tailIncline - incline) > maxIncline - minIncline) {
+            p.masked = true;
+        }
+
+        m_tailIncline = incline;
+    }
+
+    m_tailDistance = range;
+}
+
+//逐点的NoiseFilter::filter_tail2，连续的流不需要首尾回绕
+void StreamingNoiseFilter::step_tail2(uint64_t i)
+{
+    const StreamPoint &p = at(i);
+
+    if (!isRangeValid(p.point.range)) {
+        return;
+    }
+
+    if (m_hasLast) {
+        float incline2 = atan2(p.y - m_last.y, p.x - m_last.x);
+        double midSin = m_last.s + p.s;
+        double midCos = m_last.c + p.c;
+        if (fabs(m_last.point.angle - p.point.angle) > 180.0f) {
+            midSin = -midSin;
+            midCos = -midCos;
+        }
+        float incline3 = atan2(-midSin, -midCos);
+        incline2 = ydlidar::core::math::to_degrees(incline2);
+        incline3 = ydlidar::core::math::to_degrees(incline3);
+
+        float incline = incline2;
+
+        float angle = fabs(incline2 - incline3);
+        if (angle > 180.0f)
+            angle = 360.0f - angle;
+        if (angle > 90.0f)
+            angle = 180.0f - angle;
+
+        if (fabs(incline - m_lastIncline) < maxInclineAngle)
+        {
+            if (fabs(m_lastAngle) >= maxIncludeAngle)
+            {
+                m_pos = -1;
+            }
+        }
+        else
+        {
+            if (fabs(m_lastAngle) < maxIncludeAngle)
+            {
+                if (m_pos >= 0 && static_cast<int64_t>(i) - m_pos >= MIN_NOISEPOINT_COUNT)
+                {
+                    //拖尾起点可能已发出，只统计和标记窗口内的点
+                    uint64_t first = static_cast<uint64_t>(m_pos) > m_base ? m_pos : m_base;
+                    size_t validCount = 0;
+                    for (uint64_t j = first; j <= i; ++j)
+                    {
+                        if (isRangeValid(at(j).point.range))
+                            validCount += 1;
+                    }
+                    if (validCount >= MIN_NOISEPOINT_COUNT)
+                    {
+                        for (uint64_t j = first; j <= i; ++j)
+                        {
+                            at(j).masked = true;
+                        }
+                    }
+                }
+                m_pos = -1;
+            }
+            if (m_pos < 0 && fabs(angle) < maxIncludeAngle)
+            {
+                m_pos = m_lastIndex;
+            }
+            else
+            {
+                m_pos = -1;
+            }
+        }
+
+        m_lastIncline = incline;
+        m_lastAngle = angle;
+    }
+
+    m_lastIndex = i;
+    m_last = p;
+    m_hasLast = true;
+}
+
+std::string StreamingNoiseFilter::version() const
+{
+    return "1.0.0";
+}
@@ -0,0 +1,151 @@
+#ifndef STREAMINGNOISEFILTER_H
+#define STREAMINGNOISEFILTER_H
+#include <deque>
+#include <string>
+#include "core/common/ydlidar_datatype.h"
+
+/**
+ * @brief NoiseFilter run on a stream of sectors instead of complete scans.
+ * Every point is held back until ::delay newer points have arrived, then
+ * emitted with range 0 if it was masked, so the output trails the input by
+ * a constant number of points instead of a revolution. The decisions match
+ * NoiseFilter as long as a noise or tail run fits in the delay, a longer run
+ * is only masked back to the oldest point still held. The stream goes on
+ * across revolutions, the last points of a scan are judged with the first
+ * points of the next one.
+ * Not thread safe.
+ * @par usage
+ * @code
+ * StreamingNoiseFilter filter;
+ * filter.setStrategy(NoiseFilter::FS_TailStrong);
+ * LaserScan out;
+ * laser.setSectorCallback([&](const LaserScan &sector) {
+ *     filter.push(sector, out);
+ *     //out.points: filtered points, filter.delay() points behind sector
+ * });
+ * @endcode
+ */
+class StreamingNoiseFilter
+{
+public:
+    StreamingNoiseFilter();
+
+    /**
+     * @brief Select the strategy, one of NoiseFilter::FilterStrategy.
+     * The held points are kept, the run state starts over.
+     */
+    void setStrategy(int value);
+    int strategy() const {
+        return m_strategy;
+    }
+
+    /**
+     * @brief Set the number of points held back, raised to ::minDelay
+     * @param points         delay in points, the default is one 16 point block
+     */
+    void setDelay(size_t points);
+
+    /**
+     * @brief Points held back before a point is emitted
+     */
+    size_t delay() const;
+
+    /**
+     * @brief Shortest delay that sees every neighbour the strategy masks
+     */
+    size_t minDelay() const;
+
+    /**
+     * @brief Filter one sector
+     * @param in         sector as built by CYdLidar, angles in degrees
+     * @param out        points that left the window, may be the same object
+     *  as in. out.stamp is the stamp of the first of them.
+     * @return number of points in out
+     */
+    size_t push(const LaserScan &in, LaserScan &out);
+
+    /**
+     * @brief Emit every held point, the newest ones judged without their
+     * following neighbours. Call at the end of a stream.
+     * @param out        emitted points
+     * @return number of points in out
+     */
+    size_t flush(LaserScan &out);
+
+    /**
+     * @brief Drop the held points and the run state
+     */
+    void reset();
+
+    std::string version() const;
+
+protected:
+    struct StreamPoint {
+        LaserPoint point;
+        uint64_t stamp; //点的时间戳，由扇区时间戳和点间隔得到
+        double s; //角度的正弦
+        double c; //角度的余弦
+        double x; //直角坐标，单位米
+        double y;
+        bool masked; //噪点标记
+    };
+
+    bool isRangeValid(double reading) const;
+    uint64_t end() const {
+        return m_base + m_window.size();
+    }
+    StreamPoint &at(uint64_t index) {
+        return m_window[index - m_base];
+    }
+    //处理点需要的后续点数
+    size_t lookahead() const;
+    //处理所有后续点已到达的点，final为true时处理剩余全部点
+    void process(bool final);
+    size_t emit(LaserScan &out, bool final);
+    void resetState();
+
+    void step_noise(uint64_t i);
+    void step_tail(uint64_t i);
+    void step_tail2(uint64_t i);
+
+protected:
+    int m_strategy;
+    size_t m_delay;
+    LaserConfig m_config; //最近一个扇区的配置，用于判断距离有效性
+    std::deque<StreamPoint> m_window; //未发出的点
+    uint64_t m_base; //m_window第一个点的流内序号
+    uint64_t m_next; //下一个待处理点的流内序号
+
+    double minIncline, maxIncline;
+    int nonMaskedNeighbours;
+    int maskedNeighbours;
+    float maxIncludeAngle;
+    float maxInclineAngle;
+
+    //FS_Normal
+    bool m_started;
+    double m_lastRange;
+    double m_lastX, m_lastY; //上一个点
+    double m_lastDistance;
+    double m_validX, m_validY; //上一个有效点
+    bool m_isNoise;
+    float m_filterOffset;
+    int m_pointCount;
+    int64_t m_minIndex;
+    double m_maxDistance;
+
+    //FS_Tail
+    double m_tailDistance;
+    double m_tailIncline;
+    bool m_hasFirst;
+
+    //FS_TailStrong, FS_TailWeek, FS_TailStrong2
+    bool m_hasLast;
+    StreamPoint m_last; //上一个有效点
+    uint64_t m_lastIndex;
+    float m_lastIncline;
+    float m_lastAngle;
+    int64_t m_pos; //拖尾起始点序号，-1表示没有
+};
+
+#endif // STREAMINGNOISEFILTER_H
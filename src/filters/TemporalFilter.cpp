@@ -0,0 +1,180 @@
+#include <math.h>
+#include <algorithm>
+#include "TemporalFilter.h"
+
+
+TemporalFilter::TemporalFilter()
+    : m_revolutions(5),
+      m_confirmations(3),
+      m_resolution(0.25f),
+      m_bins(0),
+      m_tolerance(0.05f),
+      m_ratio(0.03f),
+      m_head(0),
+      m_filled(0)
+{
+    m_name = "TemporalFilter";
+    m_strategy = FS_Confirm;
+    setBins(m_resolution);
+}
+
+TemporalFilter::~TemporalFilter()
+{
+}
+
+bool TemporalFilter::setHistory(int revolutions, int confirmations)
+{
+    if (revolutions < 1 || revolutions > MAX_TEMPORAL_HISTORY ||
+            confirmations < 1 || confirmations > revolutions) {
+        return false;
+    }
+    m_revolutions = revolutions;
+    m_confirmations = confirmations;
+    m_near.assign(m_revolutions * m_bins, 0.0f);
+    m_far.assign(m_revolutions * m_bins, 0.0f);
+    reset();
+    return true;
+}
+
+bool TemporalFilter::setBins(float resolution)
+{
+    if (!(resolution > 0)) {
+        return false;
+    }
+    m_resolution = resolution;
+    m_bins = static_cast<int>(ceil(360.0f / resolution));
+    m_near.assign(m_revolutions * m_bins, 0.0f);
+    m_far.assign(m_revolutions * m_bins, 0.0f);
+    reset();
+    return true;
+}
+
+void TemporalFilter::setTolerance(float meters, float ratio)
+{
+    m_tolerance = meters;
+    m_ratio = ratio;
+}
+
+void TemporalFilter::reset()
+{
+    m_head = 0;
+    m_filled = 0;
+}
+
+int TemporalFilter::binOf(float angle) const
+{
+    float a = fmod(angle, 360.0f);
+    if (a < 0) {
+        a += 360.0f;
+    }
+    return static_cast<int>(a / m_resolution) % m_bins;
+}
+
+bool TemporalFilter::confirmed(int slot, int bin, float range) const
+{
+    //相邻两格也算，容忍每圈角度的抖动；格内距离变化大（斜面、边缘）时落在最近和最远之间即可
+    const float *nearRow = &m_near[slot * m_bins];
+    const float *farRow = &m_far[slot * m_bins];
+    float tolerance = std::max(m_tolerance, m_ratio * range);
+    for (int d = -1; d <= 1; d++) {
+        int b = (bin + d + m_bins) % m_bins;
+        if (nearRow[b] > 0 && range >= nearRow[b] - tolerance && range <= farRow[b] + tolerance) {
+            return true;
+        }
+    }
+    return false;
+}
+
+float TemporalFilter::median(int bin, float range) const
+{
+    float values[MAX_TEMPORAL_HISTORY];
+    int count = 0;
+    for (int k = 0; k < m_filled; k++) {
+        int slot = (m_head - k + m_revolutions) % m_revolutions;
+        float nearest = m_near[slot * m_bins + bin];
+        float farthest = m_far[slot * m_bins + bin];
+        if (nearest > 0) {
+            values[count++] = fabs(nearest - range) <= fabs(farthest - range) ? nearest : farthest;
+        }
+    }
+    if (!count) {
+        return 0;
+    }
+    //偶数个时取较小的中间值，结果总是一次实际测量
+    float *mid = values + (count - 1) / 2;
+    std::nth_element(values, mid, values + count);
+    return *mid;
+}
+
+void TemporalFilter::filter(
+        const LaserScan &in,
+        int /*lidarType*/,
+        int /*version*/,
+        LaserScan &out)
+{
+    //copy attributes to filtered scan, nothing to copy when filtering in place
+    if (&out != &in) {
+        out = in;
+    }
+
+    if (in.points.empty() || m_near.empty()) {
+        return;
+    }
+
+    //当前圈写入环形缓冲，记录的是滤波前的距离
+    const size_t size = in.points.size();
+    float *nearRow = &m_near[m_head * m_bins];
+    float *farRow = &m_far[m_head * m_bins];
+    std::fill(nearRow, nearRow + m_bins, 0.0f);
+    std::fill(farRow, farRow + m_bins, 0.0f);
+    for (size_t i = 0; i < size; i++) {
+        const LaserPoint &p = in.points[i];
+        if (p.range > 0 && p.range >= in.config.min_range && p.range <= in.config.max_range) {
+            int bin = binOf(p.angle);
+            if (nearRow[bin] == 0 || p.range < nearRow[bin]) {
+                nearRow[bin] = p.range;
+            }
+            if (p.range > farRow[bin]) {
+                farRow[bin] = p.range;
+            }
+        }
+    }
+    if (m_filled < m_revolutions) {
+        m_filled++;
+    }
+
+    if (FS_Median == m_strategy) {
+        for (size_t i = 0; i < size; i++) {
+            float range = in.points[i].range;
+            if (range > 0 && range >= in.config.min_range && range <= in.config.max_range) {
+                out.points[i].range = median(binOf(in.points[i].angle), range);
+            }
+        }
+    } else if (m_filled >= m_confirmations) {
+        //前几圈还不够确认次数时原样输出
+        for (size_t i = 0; i < size; i++) {
+            float range = in.points[i].range;
+            if (!(range > 0 && range >= in.config.min_range && range <= in.config.max_range)) {
+                continue;
+            }
+            int bin = binOf(in.points[i].angle);
+            int count = 1;
+            for (int k = 1; k < m_filled && count < m_confirmations; k++) {
+                int slot = (m_head - k + m_revolutions) % m_revolutions;
+                if (confirmed(slot, bin, range)) {
+                    count++;
+                }
+            }
+            if (count < m_confirmations) {
+                out.points[i].range = 0.0f;
+            }
+        }
+    }
+
+    m_head = (m_head + 1) % m_revolutions;
+}
+
+std::string TemporalFilter::version() const
+{
+    return "1.0.0";
+}
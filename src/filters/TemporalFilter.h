@@ -0,0 +1,93 @@
+#ifndef TEMPORALFILTER_H
+#define TEMPORALFILTER_H
+#include <vector>
+#include "FilterInterface.h"
+
+#define MAX_TEMPORAL_HISTORY 16 //最多保留的圈数
+
+/**
+ * @brief Filter points against the last revolutions, kept in a ring of
+ * angle bins. FS_Confirm marks invalid (range 0) the points not seen at a
+ * similar range in enough of the last revolutions, removing rain, dust and
+ * one scan speckle. FS_Median replaces every range with its median over
+ * the revolutions, taking from each the bin's nearest or farthest range,
+ * whichever is closer. Memory is sized by ::setHistory and ::setBins,
+ * filtering a scan allocates nothing and runs in O(points * history).
+ * Not thread safe.
+ * @par usage
+ * @code
+ * TemporalFilter temporal;
+ * temporal.setHistory(5, 3);
+ * laser.addFilter(&temporal);
+ * @endcode
+ */
+class TemporalFilter : public FilterInterface
+{
+public:
+    enum FilterStrategy
+    {
+        FS_Confirm, //M/K圈确认
+        FS_Median, //每个角度格取中值
+    };
+public:
+    TemporalFilter();
+    ~TemporalFilter() override;
+    void filter(const LaserScan &in,
+                int lidarType,
+                int version,
+                LaserScan &out) override;
+
+    std::string version() const override;
+
+    /**
+     * @brief Set the number of revolutions kept and, for FS_Confirm, in how
+     * many of them a point must be seen, the scan itself included
+     * @param revolutions    revolutions kept, 1 to MAX_TEMPORAL_HISTORY
+     * @param confirmations  1 to revolutions
+     * @return false if out of range. The history is cleared.
+     */
+    bool setHistory(int revolutions, int confirmations);
+
+    /**
+     * @brief Set the angle bin width
+     * @param resolution     bin width in degrees, the default is 0.25
+     * @return false if not positive. The history is cleared.
+     */
+    bool setBins(float resolution);
+
+    /**
+     * @brief Set how close two ranges must be to confirm each other,
+     * the larger of an absolute and a relative tolerance
+     * @param meters         absolute tolerance
+     * @param ratio          tolerance relative to the range
+     */
+    void setTolerance(float meters, float ratio);
+
+    /**
+     * @brief Forget the revolutions seen so far
+     */
+    void reset();
+
+protected:
+    //点所在的角度格
+    int binOf(float angle) const;
+    //第slot圈中bin格及相邻格是否有相近的距离
+    bool confirmed(int slot, int bin, float range) const;
+    //bin格在各圈中与range相近的距离的中值，没有记录时返回0
+    float median(int bin, float range) const;
+
+protected:
+    int m_revolutions; //保留的圈数K
+    int m_confirmations; //确认需要的圈数M
+    float m_resolution; //角度格宽度，单位度
+    int m_bins; //每圈的角度格数
+    float m_tolerance; //绝对容差，单位米
+    float m_ratio; //相对容差
+    //m_revolutions圈的环形缓冲，每圈m_bins格，记录格内最近和最远的距离，0表示没有点
+    std::vector<float> m_near;
+    std::vector<float> m_far;
+    int m_head; //当前圈在环形缓冲中的位置
+    int m_filled; //已记录的圈数
+};
+
+#endif // TEMPORALFILTER_H
@@ -25,6 +25,9 @@
 #include <sstream>
 #include "ydlidar_sdk.h"
 #include "CYdLidar.h"
+#include "CYdLidarGroup.h"
+#include <core/common/Logger.h>
+#include <core/common/Trace.h>
 #include "ydlidar_config.h"
 
 YDLidar *lidarCreate() {
@@ -128,6 +131,8 @@ bool doProcessSimple(YDLidar *lidar, LaserFan *outscan) {
         bool ret = drv->doProcessSimple(scan);
         outscan->config = scan.config;
         outscan->stamp = scan.stamp;
+        outscan->seq = scan.seq;
+        outscan->dropped = scan.dropped;
         outscan->npoints = scan.points.size();
         outscan->points = (LaserPoint *)malloc(sizeof(LaserPoint) * outscan->npoints);
         std::copy(scan.points.begin(), scan.points.end(), outscan->points);
@@ -191,6 +196,34 @@ void os_shutdown() {
     ydlidar::os_shutdown();
 }
 
+void setLogLevel(int level) {
+    ydlidar::core::common::Logger::setLevel(level);
+}
+
+int getLogLevel() {
+    return ydlidar::core::common::Logger::level();
+}
+
+void enableTrace(int events) {
+    ydlidar::core::common::Trace::enable(events > 0 ? events :
+                                         ydlidar::core::common::Trace::DEFAULT_EVENTS);
+}
+
+void disableTrace() {
+    ydlidar::core::common::Trace::disable();
+}
+
+bool dumpTrace(const char *path) {
+    if (path == NULL) {
+        return false;
+    }
+    return ydlidar::core::common::Trace::dump(path);
+}
+
+bool dumpTraceOnSignal(int signo, const char *path) {
+    return ydlidar::core::common::Trace::dumpOnSignal(signo, path);
+}
+
 int lidarPortList(YDLidar *lidar, LidarPort *ports) {
     if (lidar == NULL || ports == NULL) {
         return 0;
@@ -215,3 +248,291 @@ int lidarPortList(YDLidar *lidar, LidarPort *ports) {
     }
     return i;
 }
+
+bool enableShmPublisher(YDLidar *lidar, const char *name, int slots, bool take_over) {
+    if (lidar == NULL || lidar->lidar == NULL || name == NULL) {
+        return false;
+    }
+
+    CYdLidar *drv = static_cast<CYdLidar *>(lidar->lidar);
+
+    if (drv) {
+        return drv->enableShmPublisher(name, slots, take_over);
+    }
+
+    return false;
+}
+
+bool enableRecorder(YDLidar *lidar, const char *path) {
+    if (lidar == NULL || lidar->lidar == NULL) {
+        return false;
+    }
+
+    CYdLidar *drv = static_cast<CYdLidar *>(lidar->lidar);
+    return drv->enableRecorder(path);
+}
+
+bool setReplayFile(YDLidar *lidar, const char *path, bool realtime) {
+    if (lidar == NULL || lidar->lidar == NULL) {
+        return false;
+    }
+
+    CYdLidar *drv = static_cast<CYdLidar *>(lidar->lidar);
+    return drv->setReplayFile(path, realtime);
+}
+
+bool getMetrics(YDLidar *lidar, LidarMetrics *metrics) {
+    if (lidar == NULL || lidar->lidar == NULL || metrics == NULL) {
+        return false;
+    }
+
+    CYdLidar *drv = static_cast<CYdLidar *>(lidar->lidar);
+    return drv->getMetrics(*metrics);
+}
+
+bool getLatency(YDLidar *lidar, int stage, LidarLatency *stats) {
+    if (lidar == NULL || lidar->lidar == NULL || stats == NULL) {
+        return false;
+    }
+
+    CYdLidar *drv = static_cast<CYdLidar *>(lidar->lidar);
+    return drv->getLatency(stage, *stats);
+}
+
+void resetLatency(YDLidar *lidar) {
+    if (lidar == NULL || lidar->lidar == NULL) {
+        return;
+    }
+
+    CYdLidar *drv = static_cast<CYdLidar *>(lidar->lidar);
+    drv->resetLatency();
+}
+
+/// view a LaserScan as a LaserFan without copying the points
+static void scanToFan(const LaserScan &scan, LaserFan &fan) {
+    fan.config = scan.config;
+    fan.stamp = scan.stamp;
+    fan.seq = scan.seq;
+    fan.dropped = scan.dropped;
+    fan.npoints = scan.points.size();
+    fan.points = const_cast<LaserPoint *>(scan.points.data());
+}
+
+void setScanCallback(YDLidar *lidar, LidarScanCallback callback, void *user) {
+    if (lidar == NULL || lidar->lidar == NULL) {
+        return;
+    }
+
+    CYdLidar *drv = static_cast<CYdLidar *>(lidar->lidar);
+
+    if (!callback) {
+        drv->setScanCallback(CYdLidar::ScanCallback());
+        return;
+    }
+    drv->setScanCallback([callback, user](const LaserScan &scan) {
+        LaserFan fan;
+        scanToFan(scan, fan);
+        callback(&fan, user);
+    });
+}
+
+void setSectorCallback(YDLidar *lidar, LidarScanCallback callback, void *user) {
+    if (lidar == NULL || lidar->lidar == NULL) {
+        return;
+    }
+
+    CYdLidar *drv = static_cast<CYdLidar *>(lidar->lidar);
+
+    if (!callback) {
+        drv->setSectorCallback(CYdLidar::ScanCallback());
+        return;
+    }
+    drv->setSectorCallback([callback, user](const LaserScan &scan) {
+        LaserFan fan;
+        scanToFan(scan, fan);
+        callback(&fan, user);
+    });
+}
+
+void setErrorCallback(YDLidar *lidar, LidarErrorCallback callback, void *user) {
+    if (lidar == NULL || lidar->lidar == NULL) {
+        return;
+    }
+
+    CYdLidar *drv = static_cast<CYdLidar *>(lidar->lidar);
+
+    if (!callback) {
+        drv->setErrorCallback(CYdLidar::ErrorCallback());
+        return;
+    }
+    drv->setErrorCallback([callback, user](DriverError error) {
+        callback(error, user);
+    });
+}
+
+void setStateCallback(YDLidar *lidar, LidarStateCallback callback, void *user) {
+    if (lidar == NULL || lidar->lidar == NULL) {
+        return;
+    }
+
+    CYdLidar *drv = static_cast<CYdLidar *>(lidar->lidar);
+
+    if (!callback) {
+        drv->setStateCallback(CYdLidar::StateCallback());
+        return;
+    }
+    drv->setStateCallback([callback, user](LidarState state) {
+        callback(state, user);
+    });
+}
+
+bool setCallbackExecutor(YDLidar *lidar, int threads) {
+    if (lidar == NULL || lidar->lidar == NULL) {
+        return false;
+    }
+
+    CYdLidar *drv = static_cast<CYdLidar *>(lidar->lidar);
+    return drv->setCallbackExecutor(threads);
+}
+
+/// group and the YDLidar handles of its lidars
+struct GroupHandle {
+    CYdLidarGroup group;
+    std::vector<YDLidar *> lidars;
+};
+
+YDLidarGroup *lidarGroupCreate() {
+    YDLidarGroup *instance = new YDLidarGroup;
+    instance->group = (void *)new GroupHandle();
+    return instance;
+}
+
+void lidarGroupDestroy(YDLidarGroup **group) {
+    if (group == NULL || *group == NULL) {
+        return;
+    }
+
+    GroupHandle *handle = static_cast<GroupHandle *>((*group)->group);
+
+    if (handle) {
+        for (size_t i = 0; i < handle->lidars.size(); i++) {
+            delete handle->lidars[i];
+        }
+        delete handle;
+        handle = NULL;
+    }
+
+    (*group)->group = NULL;
+    delete *group;
+    *group = NULL;
+}
+
+YDLidar *lidarGroupAdd(YDLidarGroup *group, const char *ip) {
+    if (group == NULL || group->group == NULL) {
+        return NULL;
+    }
+
+    GroupHandle *handle = static_cast<GroupHandle *>(group->group);
+    CYdLidar *drv = handle->group.addLidar(ip);
+    if (!drv) {
+        return NULL;
+    }
+    YDLidar *instance = new YDLidar;
+    instance->lidar = (void *)drv;
+    handle->lidars.push_back(instance);
+    return instance;
+}
+
+int lidarGroupSize(YDLidarGroup *group) {
+    if (group == NULL || group->group == NULL) {
+        return 0;
+    }
+
+    GroupHandle *handle = static_cast<GroupHandle *>(group->group);
+    return static_cast<int>(handle->group.size());
+}
+
+void lidarGroupSetTolerance(YDLidarGroup *group, uint64_t tolerance) {
+    if (group == NULL || group->group == NULL) {
+        return;
+    }
+
+    GroupHandle *handle = static_cast<GroupHandle *>(group->group);
+    handle->group.setTolerance(tolerance);
+}
+
+bool lidarGroupInitialize(YDLidarGroup *group) {
+    if (group == NULL || group->group == NULL) {
+        return false;
+    }
+
+    GroupHandle *handle = static_cast<GroupHandle *>(group->group);
+    return handle->group.initialize();
+}
+
+bool lidarGroupTurnOn(YDLidarGroup *group) {
+    if (group == NULL || group->group == NULL) {
+        return false;
+    }
+
+    GroupHandle *handle = static_cast<GroupHandle *>(group->group);
+    return handle->group.turnOn();
+}
+
+bool lidarGroupDoProcess(YDLidarGroup *group, LaserFan *scans, int64_t *arrival_skew) {
+    if (group == NULL || group->group == NULL || scans == NULL) {
+        return false;
+    }
+
+    GroupHandle *handle = static_cast<GroupHandle *>(group->group);
+    for (size_t i = 0; i < handle->group.size(); i++) {
+        LaserFanDestroy(&scans[i]);
+        scans[i].npoints = 0;
+    }
+
+    ScanSet set;
+    if (!handle->group.doProcessSimple(set)) {
+        return false;
+    }
+    for (size_t i = 0; i < set.scans.size(); i++) {
+        const LaserScan &scan = set.scans[i];
+        scans[i].config = scan.config;
+        scans[i].stamp = scan.stamp;
+        scans[i].seq = scan.seq;
+        scans[i].dropped = scan.dropped;
+        scans[i].npoints = scan.points.size();
+        scans[i].points = (LaserPoint *)malloc(sizeof(LaserPoint) * scans[i].npoints);
+        std::copy(scan.points.begin(), scan.points.end(), scans[i].points);
+        if (arrival_skew) {
+            arrival_skew[i] = set.arrival_skew[i];
+        }
+    }
+    return true;
+}
+
+bool lidarGroupGetSkew(YDLidarGroup *group, int member, LidarLatency *stats) {
+    if (group == NULL || group->group == NULL || stats == NULL || member < 0) {
+        return false;
+    }
+
+    GroupHandle *handle = static_cast<GroupHandle *>(group->group);
+    return handle->group.getSkew(member, *stats);
+}
+
+bool lidarGroupTurnOff(YDLidarGroup *group) {
+    if (group == NULL || group->group == NULL) {
+        return false;
+    }
+
+    GroupHandle *handle = static_cast<GroupHandle *>(group->group);
+    return handle->group.turnOff();
+}
+
+void lidarGroupDisconnect(YDLidarGroup *group) {
+    if (group == NULL || group->group == NULL) {
+        return;
+    }
+
+    GroupHandle *handle = static_cast<GroupHandle *>(group->group);
+    handle->group.disconnecting();
+}
@@ -51,6 +51,22 @@ extern "C" {
  *
  */
 
+/**
+ * @brief Scan or sector callback.
+ * @note scan and its points are only valid during the call.
+ */
+typedef void (*LidarScanCallback)(const LaserFan *scan, void *user);
+
+/**
+ * @brief Driver error callback.
+ */
+typedef void (*LidarErrorCallback)(DriverError error, void *user);
+
+/**
+ * @brief Driver state callback.
+ */
+typedef void (*LidarStateCallback)(LidarState state, void *user);
+
 /**
  * @brief create a Lidar instance
  * @note call ::lidarDestroy destroy
@@ -82,6 +98,10 @@ YDLIDAR_API void lidarDestroy(YDLidar **lidar);
  * - @ref LidarPropLidarType
  * - @ref LidarPropDeviceType
  * - @ref LidarPropSampleRate
+ * - @ref LidarPropScanQueueDepth
+ * - @ref LidarPropScanQueuePolicy
+ * - @ref LidarPropFilterStrategy
+ * - @ref LidarPropBinPolicy
  * @note set int property example
  * @code
  * CYdLidar laser;
@@ -95,6 +115,7 @@ YDLIDAR_API void lidarDestroy(YDLidar **lidar);
  * - @ref LidarPropAutoReconnect
  * - @ref LidarPropSingleChannel
  * - @ref LidarPropIntenstiy
+ * - @ref LidarPropSectorFilter
  * @note set bool property example
  * @code
  * CYdLidar laser;
@@ -107,6 +128,9 @@ YDLIDAR_API void lidarDestroy(YDLidar **lidar);
  * - @ref LidarPropMaxAngle
  * - @ref LidarPropMinAngle
  * - @ref LidarPropScanFrequency
+ * - @ref LidarPropAngleResolution
+ * - @ref LidarPropAngleOffset
+ * - @ref LidarPropSectorWidth
  * @note set float property example
  * @code
  * CYdLidar laser;
@@ -144,6 +168,10 @@ YDLIDAR_API bool setlidaropt(YDLidar *lidar, int optname, const void *optval,
  * - @ref LidarPropLidarType
  * - @ref LidarPropDeviceType
  * - @ref LidarPropSampleRate
+ * - @ref LidarPropScanQueueDepth
+ * - @ref LidarPropScanQueuePolicy
+ * - @ref LidarPropFilterStrategy
+ * - @ref LidarPropBinPolicy
  * @note get int property example
  * @code
  * CYdLidar laser;
@@ -157,6 +185,7 @@ YDLIDAR_API bool setlidaropt(YDLidar *lidar, int optname, const void *optval,
  * - @ref LidarPropAutoReconnect
  * - @ref LidarPropSingleChannel
  * - @ref LidarPropIntenstiy
+ * - @ref LidarPropSectorFilter
  * @note get bool property example
  * @code
  * CYdLidar laser;
@@ -169,6 +198,9 @@ YDLIDAR_API bool setlidaropt(YDLidar *lidar, int optname, const void *optval,
  * - @ref LidarPropMaxAngle
  * - @ref LidarPropMinAngle
  * - @ref LidarPropScanFrequency
+ * - @ref LidarPropAngleResolution
+ * - @ref LidarPropAngleOffset
+ * - @ref LidarPropSectorWidth
  * @note set float property example
  * @code
  * CYdLidar laser;
@@ -244,6 +276,45 @@ YDLIDAR_API bool os_isOk();
  */
 YDLIDAR_API void os_shutdown();
 
+/**
+ * @brief Set the SDK log level
+ * @param level  ::LogLevel, messages below it are discarded
+ * @note messages below the YDLIDAR_LOG_LEVEL build option are compiled out
+ */
+YDLIDAR_API void setLogLevel(int level);
+
+/**
+ * @brief Get the SDK log level
+ * @return ::LogLevel
+ */
+YDLIDAR_API int getLogLevel();
+
+/**
+ * @brief Start recording driver activity into the in-memory trace ring
+ * @param events          ring size, allocated by the first call only
+ */
+YDLIDAR_API void enableTrace(int events);
+
+/**
+ * @brief Stop recording, recorded events are kept
+ */
+YDLIDAR_API void disableTrace();
+
+/**
+ * @brief Write the trace ring as Chrome trace-event JSON
+ * @param path            output file, open with chrome://tracing or Perfetto
+ * @return true if the file is written, otherwise false.
+ */
+YDLIDAR_API bool dumpTrace(const char *path);
+
+/**
+ * @brief Dump the trace ring to path whenever the signal is received
+ * @param signo           signal number, e.g. SIGUSR1
+ * @param path            output file
+ * @return false if signals are not supported on this platform.
+ */
+YDLIDAR_API bool dumpTraceOnSignal(int signo, const char *path);
+
 /**
  * @brief get lidar serial port
  * @param ports serial port lists
@@ -251,6 +322,178 @@ YDLIDAR_API void os_shutdown();
  */
 YDLIDAR_API int lidarPortList(YDLidar *lidar, LidarPort *ports);
 
+/**
+ * @brief Publish every scan into a POSIX shared memory ring,
+ * other local processes can attach it read-only with ShmScanReader.
+ * @param lidar           a lidar instance
+ * @param name            shared memory name, e.g. "/ydlidar_scan"
+ * @param slots           number of most recent scans kept
+ * @param take_over       replace an existing ring of the same name
+ * @return true if the ring is created, otherwise false, also when the
+ *  name is in use and take_over is false.
+ * @note call before ::turnOn
+ */
+YDLIDAR_API bool enableShmPublisher(YDLidar *lidar, const char *name, int slots, bool take_over);
+
+/**
+ * @brief Record the raw data and command traffic into a pcap file
+ * @param lidar           a lidar instance
+ * @param path            capture file, NULL stops recording
+ * @return true if the file is created, otherwise false.
+ * @note call before ::turnOn
+ */
+YDLIDAR_API bool enableRecorder(YDLidar *lidar, const char *path);
+
+/**
+ * @brief Decode a pcap capture instead of connecting to the lidar
+ * @param lidar           a lidar instance
+ * @param path            capture file, NULL to use the network
+ * @param realtime        keep the recorded pace, otherwise replay as fast as possible
+ * @return false if the lidar is already initialized.
+ * @note call before ::initialize
+ */
+YDLIDAR_API bool setReplayFile(YDLidar *lidar, const char *path, bool realtime);
+
+/**
+ * @brief Get a snapshot of the data path metrics
+ * @param lidar           a lidar instance
+ * @param[out] metrics    counters and gauges
+ * @return true if the lidar has been initialized, otherwise false.
+ * @note lock-free, cheap enough to poll at 100 Hz
+ */
+YDLIDAR_API bool getMetrics(YDLidar *lidar, LidarMetrics *metrics);
+
+/**
+ * @brief Get the latency percentiles of one data path stage
+ * @param lidar           a lidar instance
+ * @param stage           ::LatencyStage
+ * @param[out] stats      sample count, p50/p99/p999 and max in microseconds
+ * @return true if the lidar has been initialized and the stage is valid.
+ */
+YDLIDAR_API bool getLatency(YDLidar *lidar, int stage, LidarLatency *stats);
+
+/**
+ * @brief Clear the latency histograms of all stages
+ * @param lidar           a lidar instance
+ */
+YDLIDAR_API void resetLatency(YDLidar *lidar);
+
+/**
+ * @brief Set the callback called with every complete scan
+ * @param lidar           a lidar instance
+ * @param callback        scan callback, NULL to disable
+ * @param user            passed back to the callback
+ */
+YDLIDAR_API void setScanCallback(YDLidar *lidar, LidarScanCallback callback, void *user);
+
+/**
+ * @brief Set the callback called with every decoded data frame
+ * @param lidar           a lidar instance
+ * @param callback        sector callback, NULL to disable
+ * @param user            passed back to the callback
+ */
+YDLIDAR_API void setSectorCallback(YDLidar *lidar, LidarScanCallback callback, void *user);
+
+/**
+ * @brief Set the callback called when the driver reports an error
+ * @param lidar           a lidar instance
+ * @param callback        error callback, NULL to disable
+ * @param user            passed back to the callback
+ */
+YDLIDAR_API void setErrorCallback(YDLidar *lidar, LidarErrorCallback callback, void *user);
+
+/**
+ * @brief Set the callback called when the driver state changes
+ * @param lidar           a lidar instance
+ * @param callback        state callback, NULL to disable
+ * @param user            passed back to the callback
+ */
+YDLIDAR_API void setStateCallback(YDLidar *lidar, LidarStateCallback callback, void *user);
+
+/**
+ * @brief Select where the callbacks run
+ * @param lidar           a lidar instance
+ * @param threads         0 runs the callbacks inline on the decode thread,
+ * otherwise on a pool of threads workers
+ * @return true if the executor is set, otherwise false.
+ * @note call before ::turnOn
+ */
+YDLIDAR_API bool setCallbackExecutor(YDLidar *lidar, int threads);
+
+/**
+ * @brief create a group of lidars served by one data port and one thread
+ * @note call ::lidarGroupDestroy destroy
+ * @return created instance
+ */
+YDLIDAR_API YDLidarGroup *lidarGroupCreate(void);
+
+/**
+ * @brief Destroy a group created by ::lidarGroupCreate, and its lidars
+ * @param group     group instance
+ */
+YDLIDAR_API void lidarGroupDestroy(YDLidarGroup **group);
+
+/**
+ * @brief Add a lidar to a group
+ * @param group           group instance
+ * @param ip              lidar address
+ * @return lidar instance owned by the group, to set its properties, NULL if
+ * the address is invalid or already in the group, or the group is initialized.
+ * @note never call ::lidarDestroy on it
+ */
+YDLIDAR_API YDLidar *lidarGroupAdd(YDLidarGroup *group, const char *ip);
+
+/**
+ * @brief Number of lidars in a group
+ */
+YDLIDAR_API int lidarGroupSize(YDLidarGroup *group);
+
+/**
+ * @brief Largest device stamp difference between the scans of a set
+ * @param group           group instance
+ * @param tolerance       in LaserFan::stamp units, 0 for half a scan period
+ */
+YDLIDAR_API void lidarGroupSetTolerance(YDLidarGroup *group, uint64_t tolerance);
+
+/**
+ * @brief Initialize and connect every lidar of a group, in parallel
+ */
+YDLIDAR_API bool lidarGroupInitialize(YDLidarGroup *group);
+
+/**
+ * @brief Start every lidar of a group and the shared data thread
+ */
+YDLIDAR_API bool lidarGroupTurnOn(YDLidarGroup *group);
+
+/**
+ * @brief Get the next set of scans matched by device stamp
+ * @param group           group instance
+ * @param scans           ::lidarGroupSize scans, in the order the lidars were added,
+ *  release them with ::LaserFanDestroy
+ * @param arrival_skew    ::lidarGroupSize entries, microseconds each scan was
+ *  assembled after the earliest of the set, may be NULL
+ * @return false if no set was published within the timeout.
+ */
+YDLIDAR_API bool lidarGroupDoProcess(YDLidarGroup *group, LaserFan *scans, int64_t *arrival_skew);
+
+/**
+ * @brief Get the arrival skew percentiles of one lidar of a group
+ * @param group           group instance
+ * @param member          index, in the order the lidars were added
+ * @param stats           microseconds
+ */
+YDLIDAR_API bool lidarGroupGetSkew(YDLidarGroup *group, int member, LidarLatency *stats);
+
+/**
+ * @brief Stop every lidar of a group
+ */
+YDLIDAR_API bool lidarGroupTurnOff(YDLidarGroup *group);
+
+/**
+ * @brief Disconnect every lidar of a group
+ */
+YDLIDAR_API void lidarGroupDisconnect(YDLidarGroup *group);
+
 #ifdef __cplusplus
 }
 #endif
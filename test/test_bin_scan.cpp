@@ -0,0 +1,226 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "CYdLidar.h"
+
+//固定分辨率分格：最近角度和最小距离两种取点方式与按定义计算的结果比较，
+//包括空格、回绕前的最后一格和最后半格归入第一格
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond, what) do { \
+        if (!(cond)) { \
+            if (g_failures < 20) { \
+                printf("%s:%d: %s: %s\n", __FILE__, __LINE__, what, #cond); \
+            } \
+            g_failures++; \
+        } \
+    } while (0)
+
+uint32_t g_seed = 20261019;
+
+uint32_t nextRandom() {
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return g_seed >> 8;
+}
+
+/**
+ * @brief Exposes the scan conversions of CYdLidar
+ */
+class ScanProbe : public CYdLidar {
+public:
+    using CYdLidar::buildScan;
+};
+
+struct Grid {
+    float minAngle;
+    float maxAngle;
+    float resolution;
+};
+
+void configure(ScanProbe &lidar, const Grid &grid, int policy) {
+    bool fixed = true;
+    lidar.setlidaropt(LidarPropFixedResolution, &fixed, sizeof(bool));
+    lidar.setlidaropt(LidarPropMinAngle, &grid.minAngle, sizeof(float));
+    lidar.setlidaropt(LidarPropMaxAngle, &grid.maxAngle, sizeof(float));
+    lidar.setlidaropt(LidarPropAngleResolution, &grid.resolution, sizeof(float));
+    lidar.setlidaropt(LidarPropBinPolicy, &policy, sizeof(int));
+}
+
+node_info makeNode(uint16_t angle, uint16_t distance, uint16_t quality) {
+    node_info node;
+    memset(&node, 0, sizeof(node));
+    node.angle_q6_checkbit = angle;
+    node.distance_q2 = distance;
+    node.sync_quality = quality;
+    return node;
+}
+
+LaserScan bin(ScanProbe &lidar, const std::vector<node_info> &nodes) {
+    scan_sequence sequence = {1, 0, 0};
+    LaserScan scan;
+    lidar.buildScan(nodes.empty() ? NULL : &nodes[0], nodes.size(), sequence, scan, true);
+    return scan;
+}
+
+struct Cell {
+    long diff;   ///< angle to the bin center, 0.01 degree, -1 if empty
+    uint16_t distance;
+    uint16_t quality;
+};
+
+//按定义逐点分格，格宽是0.01度的整数倍，四舍五入取离得最近的格
+std::vector<Cell> reference(const Grid &grid, int policy, const std::vector<node_info> &nodes) {
+    const long first = lround(grid.minAngle * 100.0);
+    const long step = lround(grid.resolution * 100.0);
+    float fov = grid.maxAngle - grid.minAngle;
+    if (fov <= 0) {
+        fov += 360.f;
+    }
+    const bool full = fov > 360.f - grid.resolution / 2;
+    const long bins = full ? lround(360.f / grid.resolution) : lround(fov / grid.resolution) + 1;
+    Cell empty = {-1, 0, 0};
+    std::vector<Cell> cells(bins, empty);
+    for (size_t i = 0; i < nodes.size(); i++) {
+        long offset = ((nodes[i].angle_q6_checkbit - first) % 36000 + 36000) % 36000;
+        if (2 * offset > 72000 - step) {
+            offset -= 36000;
+        }
+        long k = offset < 0 ? 0 : (2 * offset + step) / (2 * step);
+        long diff = labs(offset - k * step);
+        if (full) {
+            k %= bins;
+        } else if (k >= bins) {
+            continue;
+        }
+        Cell &cell = cells[k];
+        uint16_t distance = nodes[i].distance_q2;
+        bool take = cell.diff < 0 || diff < cell.diff;
+        if (BinPolicyMin == policy) {
+            take = cell.diff < 0 || (distance && (!cell.distance || distance < cell.distance));
+        }
+        if (take) {
+            cell.diff = diff;
+            cell.distance = distance;
+            cell.quality = nodes[i].sync_quality;
+        }
+    }
+    return cells;
+}
+
+void compare(ScanProbe &lidar, const Grid &grid, int policy, const std::vector<node_info> &nodes,
+             const char *what) {
+    configure(lidar, grid, policy);
+    LaserScan scan = bin(lidar, nodes);
+    const std::vector<Cell> cells = reference(grid, policy, nodes);
+    CHECK(scan.points.size() == cells.size(), what);
+    for (size_t k = 0; k < cells.size() && k < scan.points.size(); k++) {
+        const LaserPoint &point = scan.points[k];
+        CHECK(point.angle == grid.minAngle + k * grid.resolution, what);
+        CHECK(point.range == static_cast<float>(cells[k].distance / 1000.f), what);
+        CHECK(point.intensity == static_cast<float>(cells[k].quality), what);
+    }
+}
+
+void testCases() {
+    ScanProbe lidar;
+    const Grid grid = {-180.f, 180.f, 1.f};
+    std::vector<node_info> nodes;
+    //10度格：9.8度、10.1度和10.3度三个点
+    nodes.push_back(makeNode(980, 1000, 1));
+    nodes.push_back(makeNode(1010, 0, 2));
+    nodes.push_back(makeNode(1030, 3000, 3));
+    //11度格只有无效点
+    nodes.push_back(makeNode(1100, 0, 4));
+    //179.4度在最后一格，179.6度在最后半格，归入-180度
+    nodes.push_back(makeNode(17940, 2500, 5));
+    nodes.push_back(makeNode(17960, 2000, 6));
+    nodes.push_back(makeNode(0, 1500, 7));
+
+    configure(lidar, grid, BinPolicyNearest);
+    LaserScan scan = bin(lidar, nodes);
+    CHECK(scan.points.size() == 360, "nearest");
+    CHECK(scan.points[190].range == 0.f && scan.points[190].intensity == 2, "nearest");
+    CHECK(scan.points[191].range == 0.f && scan.points[191].intensity == 4, "nearest");
+    CHECK(scan.points[359].angle == 179.f && scan.points[359].range == 2.5f, "last bin");
+    CHECK(scan.points[0].angle == -180.f && scan.points[0].range == 2.f, "wrapped half bin");
+    CHECK(scan.points[180].range == 1.5f && scan.points[180].angle == 0.f, "nearest");
+    //空格距离和强度为0，角度照常
+    CHECK(scan.points[100].range == 0.f && scan.points[100].intensity == 0.f, "empty bin");
+    CHECK(scan.points[100].angle == -80.f, "empty bin");
+    CHECK(scan.config.angle_increment == static_cast<float>(M_PI / 180), "increment");
+
+    configure(lidar, grid, BinPolicyMin);
+    scan = bin(lidar, nodes);
+    CHECK(scan.points[190].range == 1.f && scan.points[190].intensity == 1, "min");
+    CHECK(scan.points[191].range == 0.f && scan.points[191].intensity == 4, "min");
+    CHECK(scan.points[100].range == 0.f, "empty bin");
+
+    //0到90度：最后一格是90度，90.6度不在范围内，359.7度归入0度
+    const Grid part = {0.f, 90.f, 1.f};
+    nodes.clear();
+    nodes.push_back(makeNode(9040, 1000, 1));
+    nodes.push_back(makeNode(9060, 500, 2));
+    nodes.push_back(makeNode(35970, 700, 3));
+    configure(lidar, part, BinPolicyMin);
+    scan = bin(lidar, nodes);
+    CHECK(scan.points.size() == 91, "partial");
+    CHECK(scan.points[90].angle == 90.f && scan.points[90].range == 1.f, "partial last bin");
+    CHECK(scan.points[0].range == 0.7f && scan.points[0].intensity == 3, "partial wrap");
+    CHECK(scan.config.max_angle == static_cast<float>(M_PI / 2), "partial");
+
+    //没有点时整圈都是空格
+    nodes.clear();
+    scan = bin(lidar, nodes);
+    CHECK(scan.points.size() == 91 && scan.points[45].range == 0.f, "no points");
+}
+
+void testRandom() {
+    ScanProbe lidar;
+    const Grid grids[] = {
+        {-180.f, 180.f, 1.f},
+        {0.f, 360.f, 0.5f},
+        {0.f, 359.5f, 0.5f},
+        {0.f, 90.f, 1.f},
+        {300.f, 60.f, 0.25f},
+        {-90.f, 90.f, 2.f},
+        {12.34f, 12.34f, 0.1f},
+        {-45.f, 45.f, 7.f},
+    };
+    for (size_t g = 0; g < sizeof(grids) / sizeof(grids[0]); g++) {
+        for (int policy = BinPolicyNearest; policy <= BinPolicyMin; policy++) {
+            for (int n = 0; n < 30; n++) {
+                //随机起点和步长的一圈，中间有一段没有点
+                std::vector<node_info> nodes;
+                const uint32_t step = 1 + nextRandom() % 40;
+                const uint32_t start = nextRandom() % 36000;
+                const uint32_t gapStart = nextRandom() % 36000;
+                const uint32_t gapSize = nextRandom() % 5000;
+                for (uint32_t a = 0; a < 36000; a += step) {
+                    uint32_t angle = (start + a) % 36000;
+                    if ((angle - gapStart + 36000) % 36000 < gapSize) {
+                        continue;
+                    }
+                    uint16_t distance = nextRandom() % 5 ? static_cast<uint16_t>(1 + nextRandom() % 5000) : 0;
+                    nodes.push_back(makeNode(static_cast<uint16_t>(angle), distance,
+                                             static_cast<uint16_t>(nextRandom() % 256)));
+                }
+                compare(lidar, grids[g], policy, nodes, policy == BinPolicyMin ? "random min" : "random nearest");
+            }
+        }
+    }
+}
+
+}
+
+int main()
+{
+    testCases();
+    testRandom();
+    printf("%d failures\n", g_failures);
+    return g_failures ? 1 : 0;
+}
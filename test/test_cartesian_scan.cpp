@@ -0,0 +1,110 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "core/common/CartesianScan.h"
+#include "math/angles.h"
+
+using namespace ydlidar::core::common;
+
+//节点直接查表的结果应与经LaserScan转换的结果逐位相同，离开网格的角度与直接计算一致
+
+namespace {
+
+uint32_t g_seed = 20261019;
+
+uint32_t nextRandom() {
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return g_seed >> 8;
+}
+
+int g_failures = 0;
+
+void check(bool ok, const char *what, size_t i) {
+    if (!ok) {
+        if (g_failures < 10) {
+            printf("%s: point %zu\n", what, i);
+        }
+        g_failures++;
+    }
+}
+
+//NaN只要求两边都是NaN
+bool same(float a, float b) {
+    return (a != a && b != b) || memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+/**
+ * @brief Nodes with random integer angles, including 36000 and above,
+ * and every fifth distance 0
+ */
+void makeNodes(std::vector<node_info> &nodes) {
+    nodes.resize(1 + nextRandom() % 3000);
+    for (size_t i = 0; i < nodes.size(); i++) {
+        node_info &n = nodes[i];
+        memset(&n, 0, sizeof(n));
+        n.angle_q6_checkbit = static_cast<uint16_t>(nextRandom() % 36100);
+        n.distance_q2 = i % 5 ? static_cast<uint16_t>(nextRandom() % 65536) : 0;
+        n.sync_quality = static_cast<uint16_t>(nextRandom() % 256);
+        n.stamp = 1000 + i;
+    }
+}
+
+//与CYdLidar::buildScan相同的单位换算
+void toLaserScan(const std::vector<node_info> &nodes, LaserScan &scan) {
+    scan.points.resize(nodes.size());
+    scan.stamp = nodes[0].stamp;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        scan.points[i].angle = static_cast<float>(nodes[i].angle_q6_checkbit / 100.0f);
+        scan.points[i].range = static_cast<float>(nodes[i].distance_q2 / 1000.f);
+        scan.points[i].intensity = static_cast<float>(nodes[i].sync_quality);
+    }
+}
+
+}
+
+int main()
+{
+    const float poses[][3] = {{0.f, 0.f, 0.f}, {0.5f, -1.25f, 90.f}, {-2.f, 3.f, -33.3f}};
+    size_t points = 0;
+    for (size_t p = 0; p < sizeof(poses) / sizeof(poses[0]); p++) {
+        CartesianConverter converter;
+        converter.setTransform(poses[p][0], poses[p][1], poses[p][2]);
+        for (int n = 0; n < 40; n++) {
+            std::vector<node_info> nodes;
+            makeNodes(nodes);
+            LaserScan scan;
+            toLaserScan(nodes, scan);
+            CartesianScan fromNodes;
+            CartesianScan fromScan;
+            converter.convert(&nodes[0], nodes.size(), fromNodes);
+            converter.convert(scan, fromScan);
+            check(fromNodes.size() == nodes.size() && fromNodes.stamp == scan.stamp, "size or stamp", 0);
+            for (size_t i = 0; i < nodes.size(); i++) {
+                check(same(fromNodes.x()[i], fromScan.x()[i]), "x differs", i);
+                check(same(fromNodes.y()[i], fromScan.y()[i]), "y differs", i);
+                check(same(fromNodes.intensity()[i], fromScan.intensity()[i]), "intensity differs", i);
+                check((nodes[i].distance_q2 == 0) == (fromNodes.x()[i] != fromNodes.x()[i]), "invalid point", i);
+            }
+            points += nodes.size();
+
+            //离开0.01度网格的角度不查表
+            for (size_t i = 0; i < scan.points.size(); i++) {
+                scan.points[i].angle += 0.0037f;
+            }
+            converter.convert(scan, fromScan);
+            for (size_t i = 0; i < scan.points.size(); i++) {
+                const LaserPoint &point = scan.points[i];
+                if (!(point.range > 0)) {
+                    continue;
+                }
+                double rad = ydlidar::core::math::from_degrees(static_cast<double>(point.angle) + poses[p][2]);
+                float x = point.range * static_cast<float>(cos(rad)) + poses[p][0];
+                float y = point.range * static_cast<float>(sin(rad)) + poses[p][1];
+                check(fabs(fromScan.x()[i] - x) < 1e-4 && fabs(fromScan.y()[i] - y) < 1e-4, "off grid", i);
+            }
+        }
+    }
+    printf("%zu points compared, %d mismatches\n", points, g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,150 @@
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+#include "core/common/CloudFusion.h"
+
+using namespace ydlidar::core::common;
+
+//两个视场重叠的雷达融合：重叠处只保留编号小的雷达的点，点的来源编号正确，
+//代数回绕清空网格后上一轮的占用不会再出现
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            if (g_failures < 20) { \
+                printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            } \
+            g_failures++; \
+        } \
+    } while (0)
+
+const double DEG = M_PI / 180;
+
+void addPoint(LaserScan &scan, double angle, double range, float intensity) {
+    LaserPoint point;
+    point.angle = static_cast<float>(angle);
+    point.range = static_cast<float>(range);
+    point.intensity = intensity;
+    scan.points.push_back(point);
+}
+
+//车体坐标下的点在位于(x, 0)、朝向0度的雷达中的角度和距离
+void addWorldPoint(LaserScan &scan, double x, double wx, double wy, float intensity) {
+    addPoint(scan, atan2(wy, wx - x) / DEG, hypot(wx - x, wy), intensity);
+}
+
+bool near(float a, double b) {
+    return fabs(a - b) < 1e-4;
+}
+
+/**
+ * @brief Lidar 0 at the origin sees the arc from 0 to 90 degrees at 2 m,
+ * lidar 1 one meter ahead sees the same world points and an arc behind.
+ * The world points sit in the middle of 1 degree by 5 cm cells.
+ */
+void makeSet(ScanSet &set) {
+    set.scans.assign(2, LaserScan());
+    set.stamp = 1234;
+    set.seq = 5;
+    set.dropped = 2;
+    for (int k = 0; k < 90; k++) {
+        double wx = 2.025 * cos((k + 0.5) * DEG);
+        double wy = 2.025 * sin((k + 0.5) * DEG);
+        addPoint(set.scans[0], k + 0.5, 2.025, 10.f);
+        addWorldPoint(set.scans[1], 1.0, wx, wy, 20.f);
+    }
+    //两个雷达都有的无效点和最大距离以外的点
+    addPoint(set.scans[0], 45.5, 0.0, 10.f);
+    addPoint(set.scans[0], 30.5, 25.0, 10.f);
+    addWorldPoint(set.scans[1], 1.0, 25.0 * cos(30.5 * DEG), 25.0 * sin(30.5 * DEG), 20.f);
+    //只有雷达1看到的点，同一格里两个点都保留
+    addWorldPoint(set.scans[1], 1.0, -2.025, 0.0173, 20.f);
+    addWorldPoint(set.scans[1], 1.0, -2.030, 0.0174, 20.f);
+}
+
+void testOverlap() {
+    CloudFusion fusion;
+    CHECK(fusion.setExtrinsics(1, 1.f, 0.f, 0.f));
+    CHECK(fusion.setDeduplication(1.f, 0.05f, 20.f));
+    ScanSet set;
+    makeSet(set);
+    FusedCloud cloud;
+    fusion.fuse(set, cloud);
+
+    //雷达0的91个有效点，雷达1的最远点和背后的两个点
+    CHECK(cloud.size() == 94);
+    CHECK(cloud.stamp == 1234 && cloud.seq == 5 && cloud.dropped == 2);
+    for (size_t i = 0; i < cloud.size() && i < 94; i++) {
+        CHECK(cloud.source()[i] == (i < 91 ? 0 : 1));
+        CHECK(cloud.intensity()[i] == (i < 91 ? 10.f : 20.f));
+    }
+    if (cloud.size() == 94) {
+        CHECK(near(cloud.x()[0], 2.025 * cos(0.5 * DEG)) && near(cloud.y()[0], 2.025 * sin(0.5 * DEG)));
+        CHECK(near(cloud.x()[91], 25.0 * cos(30.5 * DEG)) && near(cloud.y()[91], 25.0 * sin(30.5 * DEG)));
+        CHECK(near(cloud.x()[92], -2.025) && near(cloud.y()[92], 0.0173));
+        CHECK(near(cloud.x()[93], -2.030) && near(cloud.y()[93], 0.0174));
+    }
+
+    //下一组只有雷达1，上一组雷达0占用的格不再生效
+    ScanSet second;
+    makeSet(second);
+    second.scans[0].points.clear();
+    fusion.fuse(second, cloud);
+    CHECK(cloud.size() == 93);
+    for (size_t i = 0; i < cloud.size(); i++) {
+        CHECK(cloud.source()[i] == 1);
+    }
+
+    //关闭去重后所有有效点都保留
+    CHECK(fusion.setDeduplication(0.f, 0.f, 0.f));
+    fusion.fuse(set, cloud);
+    CHECK(cloud.size() == 91 + 93);
+
+    CHECK(!fusion.setDeduplication(-1.f, 0.05f, 20.f));
+    CHECK(!fusion.setDeduplication(0.01f, 0.001f, 100.f));
+    CHECK(!fusion.setExtrinsics(CloudFusion::MAX_SOURCES, 0.f, 0.f, 0.f));
+}
+
+void testGenerationWrap() {
+    CloudFusion fusion;
+    fusion.setExtrinsics(1, 1.f, 0.f, 0.f);
+    fusion.setDeduplication(1.f, 0.05f, 20.f);
+
+    //第1代：雷达1占用重叠的格
+    ScanSet set;
+    makeSet(set);
+    ScanSet claim = set;
+    claim.scans[0].points.clear();
+    FusedCloud cloud;
+    fusion.fuse(claim, cloud);
+    CHECK(cloud.size() == 93);
+
+    //空的组推进代数到回绕前的最后一代
+    ScanSet empty;
+    empty.scans.resize(2);
+    for (uint32_t generation = 2; generation < (1u << 24); generation++) {
+        fusion.fuse(empty, cloud);
+    }
+    CHECK(cloud.size() == 0);
+
+    //回绕后代数又从1开始，第1代留下的占用已清空，雷达0的点不能被挡掉
+    ScanSet mine = set;
+    mine.scans[1].points.clear();
+    fusion.fuse(mine, cloud);
+    CHECK(cloud.size() == 91);
+    fusion.fuse(set, cloud);
+    CHECK(cloud.size() == 94);
+}
+
+}
+
+int main()
+{
+    testOverlap();
+    testGenerationWrap();
+    printf("%d failures\n", g_failures);
+    return g_failures ? 1 : 0;
+}
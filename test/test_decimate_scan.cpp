@@ -0,0 +1,185 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "CYdLidar.h"
+
+//订阅的降采样：每N点取一点、每格取最近点和平均值，与逐格的参考结果比较，
+//一圈从格的中间开始和经过360度回绕的情况都要首尾合并成一格
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond, what) do { \
+        if (!(cond)) { \
+            if (g_failures < 20) { \
+                printf("%s:%d: %s: %s\n", __FILE__, __LINE__, what, #cond); \
+            } \
+            g_failures++; \
+        } \
+    } while (0)
+
+uint32_t g_seed = 20261019;
+
+uint32_t nextRandom() {
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return g_seed >> 8;
+}
+
+/**
+ * @brief Exposes the scan conversions of CYdLidar
+ */
+class ScanProbe : public CYdLidar {
+public:
+    using CYdLidar::decimateScan;
+};
+
+/**
+ * @brief One revolution from start, angles wrap at 360.00, every
+ * seventh point invalid
+ */
+void makeScan(std::vector<node_info> &nodes, uint32_t start, uint32_t step, size_t count) {
+    nodes.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        node_info &n = nodes[i];
+        memset(&n, 0, sizeof(n));
+        n.angle_q6_checkbit = static_cast<uint16_t>((start + i * step) % 36000);
+        n.distance_q2 = i % 7 ? static_cast<uint16_t>(100 + nextRandom() % 8000) : 0;
+        n.sync_quality = static_cast<uint16_t>(nextRandom() % 256);
+        n.stamp = 1000 + i * 10;
+    }
+}
+
+struct Bin {
+    long index;
+    uint32_t valid;
+    uint32_t sum;
+    uint16_t nearest;
+    uint32_t quality;
+};
+
+//按格的定义逐点计算，格按第一个点出现的顺序输出，最近点距离相同时取先扫到的
+std::vector<Bin> reference(const std::vector<node_info> &nodes, float resolution, bool mean) {
+    std::vector<Bin> bins;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        long index = static_cast<long>(nodes[i].angle_q6_checkbit / (resolution * 100.f));
+        size_t b = 0;
+        while (b < bins.size() && bins[b].index != index) {
+            b++;
+        }
+        if (b == bins.size()) {
+            Bin bin = {index, 0, 0, 0, 0};
+            bins.push_back(bin);
+        }
+        Bin &bin = bins[b];
+        uint16_t distance = nodes[i].distance_q2;
+        if (!distance) {
+            continue;
+        }
+        bin.valid++;
+        if (mean) {
+            bin.sum += distance;
+            bin.quality += nodes[i].sync_quality;
+        } else if (!bin.nearest || distance < bin.nearest) {
+            bin.nearest = distance;
+            bin.quality = nodes[i].sync_quality;
+        }
+    }
+    return bins;
+}
+
+void compareBins(ScanProbe &lidar, const std::vector<node_info> &nodes, int mode,
+                 float resolution, const char *what) {
+    const bool mean = DecimationMeanBin == mode;
+    ScanDecimation decimation = {mode, 0, resolution};
+    scan_sequence sequence = {7, 2, 0};
+    LaserScan scan;
+    lidar.decimateScan(&nodes[0], nodes.size(), sequence, decimation, scan);
+    const std::vector<Bin> bins = reference(nodes, resolution, mean);
+    CHECK(scan.points.size() == bins.size(), what);
+    CHECK(scan.seq == 7 && scan.dropped == 2 && scan.stamp == nodes[0].stamp, what);
+    for (size_t b = 0; b < bins.size() && b < scan.points.size(); b++) {
+        const Bin &bin = bins[b];
+        const LaserPoint &point = scan.points[b];
+        float range = bin.valid ? (mean ? bin.sum / 1000.f / bin.valid : bin.nearest / 1000.f) : 0.f;
+        float intensity = static_cast<float>(bin.valid ? bin.quality / (mean ? bin.valid : 1) : 0);
+        CHECK(point.angle == (bin.index + 0.5f) * resolution, what);
+        CHECK(point.range == range, what);
+        CHECK(point.intensity == intensity, what);
+    }
+}
+
+void testBins() {
+    ScanProbe lidar;
+    const float resolutions[] = {0.25f, 1.f, 7.f, 45.f, 360.f};
+    for (int mode = DecimationMinBin; mode <= DecimationMeanBin; mode++) {
+        for (size_t r = 0; r < sizeof(resolutions) / sizeof(resolutions[0]); r++) {
+            std::vector<node_info> nodes;
+            //从格的边界开始，不回绕
+            makeScan(nodes, 0, 20, 1800);
+            compareBins(lidar, nodes, mode, resolutions[r], "bin edge start");
+            //从格的中间开始，首尾两段同一格
+            makeScan(nodes, 1550, 20, 1800);
+            compareBins(lidar, nodes, mode, resolutions[r], "mid bin start");
+            //经过360度回绕，并且随机起点和步长
+            for (int n = 0; n < 50; n++) {
+                uint32_t start = 18000 + nextRandom() % 18000;
+                uint32_t step = 1 + nextRandom() % 30;
+                makeScan(nodes, start, step, 35999 / step);
+                compareBins(lidar, nodes, mode, resolutions[r], "wrap");
+            }
+        }
+    }
+
+    //首段只有无效点也要合并尾段的有效点
+    std::vector<node_info> nodes;
+    makeScan(nodes, 150, 10, 3600);
+    nodes[0].distance_q2 = 0;
+    nodes[1].distance_q2 = 0;
+    nodes[nodes.size() - 1].distance_q2 = 4321;
+    nodes[nodes.size() - 2].distance_q2 = 2000;
+    compareBins(lidar, nodes, DecimationMinBin, 1.f, "invalid head");
+    compareBins(lidar, nodes, DecimationMeanBin, 1.f, "invalid head");
+
+    //只有一格时不重复输出
+    ScanDecimation decimation = {DecimationMinBin, 0, 1.f};
+    scan_sequence sequence = {1, 0, 0};
+    LaserScan scan;
+    makeScan(nodes, 1220, 1, 50);
+    lidar.decimateScan(&nodes[0], nodes.size(), sequence, decimation, scan);
+    CHECK(scan.points.size() == 1 && scan.points[0].angle == 12.5f, "single bin");
+    lidar.decimateScan(NULL, 0, sequence, decimation, scan);
+    CHECK(scan.points.empty() && scan.config.time_increment == 0.f, "empty");
+}
+
+void testEveryNth() {
+    ScanProbe lidar;
+    std::vector<node_info> nodes;
+    makeScan(nodes, 35550, 10, 3600);
+    scan_sequence sequence = {3, 0, 0};
+    LaserScan scan;
+    const int steps[] = {1, 2, 7, 3600, 5000};
+    for (size_t s = 0; s < sizeof(steps) / sizeof(steps[0]); s++) {
+        ScanDecimation decimation = {DecimationEveryNth, steps[s], 0.f};
+        lidar.decimateScan(&nodes[0], nodes.size(), sequence, decimation, scan);
+        CHECK(scan.points.size() == (nodes.size() + steps[s] - 1) / steps[s], "every nth");
+        for (size_t i = 0; i < scan.points.size(); i++) {
+            const node_info &n = nodes[i * steps[s]];
+            CHECK(scan.points[i].angle == n.angle_q6_checkbit / 100.0f, "every nth");
+            CHECK(scan.points[i].range == n.distance_q2 / 1000.f, "every nth");
+            CHECK(scan.points[i].intensity == n.sync_quality, "every nth");
+        }
+        CHECK(scan.seq == 3, "every nth");
+    }
+}
+
+}
+
+int main()
+{
+    testBins();
+    testEveryNth();
+    printf("%d failures\n", g_failures);
+    return g_failures ? 1 : 0;
+}
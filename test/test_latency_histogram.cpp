@@ -0,0 +1,184 @@
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "core/common/LatencyHistogram.h"
+
+using namespace ydlidar::core::common;
+
+//延时直方图：已知分布的p50、p99、p999与排序后的精确值比较，
+//误差在一个桶宽（1/16）以内，32微秒以下精确，包括0和超过uint32_t的值
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond, what) do { \
+        if (!(cond)) { \
+            if (g_failures < 20) { \
+                printf("%s:%d: %s: %s\n", __FILE__, __LINE__, what, #cond); \
+            } \
+            g_failures++; \
+        } \
+    } while (0)
+
+uint32_t g_seed = 20261019;
+
+uint32_t nextRandom() {
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return g_seed >> 8;
+}
+
+//(0, 1]均匀分布
+double uniform() {
+    return (nextRandom() + 1.0) / (1u << 24);
+}
+
+//第permille个千分位的精确值，与snapshot的名次一样向上取整
+uint32_t exact(const std::vector<uint32_t> &sorted, uint64_t permille) {
+    uint64_t rank = (sorted.size() * permille + 999) / 1000;
+    return sorted[rank - 1];
+}
+
+//不小于精确值，小于精确值的17/16，32以下相等
+bool close(uint32_t value, uint32_t expected) {
+    if (expected < 32) {
+        return value == expected;
+    }
+    return value >= expected && value < expected * (17.0 / 16);
+}
+
+void check(const std::vector<uint64_t> &samples, const char *what) {
+    LatencyHistogram histogram;
+    std::vector<uint32_t> sorted;
+    for (size_t i = 0; i < samples.size(); i++) {
+        histogram.record(samples[i]);
+        sorted.push_back(samples[i] > 0xffffffffu ? 0xffffffffu : static_cast<uint32_t>(samples[i]));
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    LidarLatency stats;
+    histogram.snapshot(stats);
+    CHECK(stats.count == samples.size(), what);
+    CHECK(stats.max == sorted.back(), what);
+    CHECK(close(stats.p50, exact(sorted, 500)), what);
+    CHECK(close(stats.p99, exact(sorted, 990)), what);
+    CHECK(close(stats.p999, exact(sorted, 999)), what);
+    CHECK(stats.p50 <= stats.p99 && stats.p99 <= stats.p999 && stats.p999 <= stats.max, what);
+}
+
+void testDistributions() {
+    const size_t N = 100000;
+    std::vector<uint64_t> samples;
+
+    //均匀分布0到2000微秒
+    for (size_t i = 0; i < N; i++) {
+        samples.push_back(nextRandom() % 2001);
+    }
+    check(samples, "uniform");
+
+    //指数分布，均值500微秒，长尾
+    samples.clear();
+    for (size_t i = 0; i < N; i++) {
+        samples.push_back(static_cast<uint64_t>(-500.0 * log(uniform())));
+    }
+    check(samples, "exponential");
+
+    //98%在100微秒附近，2%在20毫秒，p99落在尾部
+    samples.clear();
+    for (size_t i = 0; i < N; i++) {
+        samples.push_back(nextRandom() % 50 ? 90 + nextRandom() % 20 : 20000 + nextRandom() % 1000);
+    }
+    check(samples, "bimodal");
+
+    //对数均匀分布覆盖整个uint32_t，逐个桶边界都会用到
+    samples.clear();
+    for (size_t i = 0; i < N; i++) {
+        samples.push_back(static_cast<uint64_t>(exp(uniform() * log(4294967295.0))));
+    }
+    check(samples, "log uniform");
+
+    //全是0，以及32以下的精确桶
+    samples.assign(1000, 0);
+    check(samples, "zero");
+    samples.clear();
+    for (size_t i = 0; i < N; i++) {
+        samples.push_back(nextRandom() % 32);
+    }
+    check(samples, "small");
+
+    //超过uint32_t的值按0xffffffff计，p50和p99都在最后一个桶
+    samples.clear();
+    for (size_t i = 0; i < 1000; i++) {
+        samples.push_back(i % 4 ? 0xffffffffull + 1 + nextRandom() : 3000000000ull);
+    }
+    check(samples, "huge");
+}
+
+void testEdges() {
+    LatencyHistogram histogram;
+    LidarLatency stats;
+    //没有样本时全为0
+    histogram.snapshot(stats);
+    CHECK(stats.count == 0 && stats.p50 == 0 && stats.p99 == 0 && stats.p999 == 0 && stats.max == 0, "empty");
+
+    //样本少时p99和p999是最大值，不超过最大值
+    histogram.record(10);
+    histogram.record(1000);
+    histogram.record(1001);
+    histogram.snapshot(stats);
+    CHECK(stats.count == 3 && close(stats.p50, 1000) && stats.p50 <= 1001, "few");
+    CHECK(stats.p99 == 1001 && stats.p999 == 1001 && stats.max == 1001, "few");
+
+    histogram.reset();
+    histogram.snapshot(stats);
+    CHECK(stats.count == 0 && stats.max == 0, "reset");
+    //10个样本时p99的名次向上取整为第10个
+    for (uint32_t i = 1; i <= 10; i++) {
+        histogram.record(i * 100);
+    }
+    histogram.snapshot(stats);
+    CHECK(stats.p50 == 511 && stats.p99 == 1000 && stats.max == 1000, "rank");
+
+    //报告的是桶的上界：1024所在的桶是[1024, 1088)
+    histogram.reset();
+    for (int i = 0; i < 10; i++) {
+        histogram.record(1024);
+    }
+    histogram.record(5000);
+    histogram.snapshot(stats);
+    CHECK(stats.p50 == 1087 && stats.p999 == 5000, "bucket upper");
+    histogram.reset();
+
+    //多个线程同时记录，计数不丢
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.push_back(std::thread([&histogram, t]() {
+            for (uint32_t i = 0; i < 100000; i++) {
+                histogram.record(i % 1000 + t);
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+    histogram.snapshot(stats);
+    CHECK(stats.count == 400000 && stats.max == 1002, "threads");
+
+    DriverLatency driver;
+    driver.record(LatencyStageCount, 5);
+    driver.record(0, 5);
+    CHECK(!driver.snapshot(-1, stats) && !driver.snapshot(LatencyStageCount, stats), "stage");
+    CHECK(driver.snapshot(0, stats) && stats.count == 1 && stats.p50 == 5, "stage");
+}
+
+}
+
+int main()
+{
+    testDistributions();
+    testEdges();
+    printf("%d failures\n", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <vector>
+#include "CYdLidarGroup.h"
+
+//多雷达按设备时间戳组成扫描组：时间戳错开、某个雷达丢了一圈或晚到、超过容差，
+//以及按doProcessSimple读取时丢弃的扫描组计数
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            if (g_failures < 20) { \
+                printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            } \
+            g_failures++; \
+        } \
+    } while (0)
+
+const uint64_t PERIOD = 1000000;    ///< scan period in stamp units
+const uint64_t START = 5000000000ULL;
+
+/**
+ * @brief Feeds scans to the set matching of a group without a network
+ */
+class GroupProbe : public CYdLidarGroup {
+public:
+    using CYdLidarGroup::onMemberScan;
+    using CYdLidarGroup::resetMatching;
+
+    GroupProbe(size_t members) {
+        const char *ips[] = {"192.168.0.11", "192.168.0.12", "192.168.0.13"};
+        for (size_t i = 0; i < members; i++) {
+            addLidar(ips[i]);
+        }
+        resetMatching();
+        setSetCallback([this](const ScanSet &set) {
+            sets.push_back(set);
+        });
+    }
+
+    //第turn圈，seq记录圈号
+    void scan(size_t member, uint64_t turn, int64_t skew) {
+        LaserScan scan;
+        scan.stamp = START + turn * PERIOD + skew;
+        scan.seq = turn;
+        onMemberScan(member, scan);
+    }
+
+    std::vector<ScanSet> sets;
+};
+
+void testSkewed() {
+    GroupProbe group(2);
+    const int64_t skew = PERIOD * 3 / 10;
+    for (uint64_t turn = 0; turn < 20; turn++) {
+        group.scan(0, turn, 0);
+        //第5圈雷达1丢了
+        if (turn != 5) {
+            group.scan(1, turn, skew);
+        }
+    }
+    //扫描周期在每个雷达的第二圈后才知道，第0圈不成组；第5圈只有雷达0
+    CHECK(group.sets.size() == 18);
+    uint64_t expected = 1;
+    for (size_t i = 0; i < group.sets.size(); i++) {
+        const ScanSet &set = group.sets[i];
+        if (expected == 5) {
+            expected++;
+        }
+        CHECK(set.seq == i + 1);
+        CHECK(set.scans.size() == 2);
+        CHECK(set.scans[0].seq == expected && set.scans[1].seq == expected);
+        CHECK(set.stamp == START + expected * PERIOD);
+        CHECK(set.stamp_skew[0] == 0 && set.stamp_skew[1] == skew);
+        CHECK(set.arrival_skew[0] == 0 && set.arrival_skew[1] >= 0);
+        expected++;
+    }
+    //回调之外没有人读取，只有最后一组未读
+    CHECK(group.sets.back().dropped == 17);
+    ScanSet set;
+    CHECK(group.doProcessSimple(set, 0) && set.seq == 18);
+    CHECK(!group.doProcessSimple(set, 0));
+}
+
+void testLateMember() {
+    //雷达1比雷达0晚到一圈多，每圈的数据仍按时间戳配对
+    GroupProbe group(3);
+    for (uint64_t turn = 0; turn < 12; turn++) {
+        group.scan(0, turn, 0);
+        group.scan(2, turn, -static_cast<int64_t>(PERIOD / 5));
+        if (turn >= 2) {
+            group.scan(1, turn - 2, PERIOD / 10);
+        }
+    }
+    CHECK(group.sets.size() == 9);
+    for (size_t i = 0; i < group.sets.size(); i++) {
+        const ScanSet &set = group.sets[i];
+        CHECK(set.scans[0].seq == i + 1 && set.scans[1].seq == i + 1 && set.scans[2].seq == i + 1);
+        CHECK(set.stamp_skew[2] == 0 && set.stamp_skew[0] == static_cast<int64_t>(PERIOD / 5));
+    }
+
+    //超过MATCH_DEPTH圈的积压丢掉最早的，剩下的照常配对
+    group.sets.clear();
+    for (uint64_t turn = 12; turn < 20; turn++) {
+        group.scan(0, turn, 0);
+        group.scan(2, turn, 0);
+    }
+    CHECK(group.sets.empty());
+    group.scan(1, 17, 0);
+    CHECK(group.sets.size() == 1 && group.sets[0].scans[0].seq == 17 && group.sets[0].scans[2].seq == 17);
+    group.scan(1, 18, 0);
+    group.scan(1, 19, 0);
+    CHECK(group.sets.size() == 3 && group.sets[2].scans[1].seq == 19);
+}
+
+void testTolerance() {
+    //错开超过半个周期时，自动容差下与下一圈的时间戳更近
+    GroupProbe group(2);
+    for (uint64_t turn = 0; turn < 10; turn++) {
+        group.scan(0, turn, 0);
+        group.scan(1, turn, PERIOD * 6 / 10);
+    }
+    CHECK(group.sets.size() == 8);
+    for (size_t i = 0; i < group.sets.size(); i++) {
+        const ScanSet &set = group.sets[i];
+        CHECK(set.scans[0].seq == i + 2 && set.scans[1].seq == i + 1);
+        CHECK(set.stamp_skew[1] == 0 && set.stamp_skew[0] == static_cast<int64_t>(PERIOD * 4 / 10));
+    }
+
+    //指定容差后成组，没有时间戳的扫描不参与
+    GroupProbe fixed(2);
+    fixed.setTolerance(PERIOD / 10);
+    LaserScan empty;
+    fixed.onMemberScan(0, empty);
+    fixed.scan(0, 0, 0);
+    fixed.scan(1, 0, PERIOD / 10);
+    fixed.scan(0, 1, 0);
+    fixed.scan(1, 1, PERIOD / 10 + 1);
+    CHECK(fixed.sets.size() == 1 && fixed.sets[0].scans[1].seq == 0);
+
+    //重新开始时之前的积压和计数都清掉
+    fixed.resetMatching();
+    fixed.sets.clear();
+    fixed.scan(1, 2, 0);
+    fixed.scan(0, 2, 0);
+    CHECK(fixed.sets.size() == 1 && fixed.sets[0].seq == 1 && fixed.sets[0].dropped == 0);
+}
+
+}
+
+int main()
+{
+    testSkewed();
+    testLateMember();
+    testTolerance();
+    printf("%d failures\n", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/common/Logger.h"
+#include "core/base/timer.h"
+
+using namespace ydlidar::core::common;
+
+//异步日志：每个调用点每秒最多10条，下一个窗口的第一条带上被抑制的条数；
+//后台线程写不出去、本线程的缓存满时丢弃的条数计入Logger::dropped并随输出报告
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            if (g_failures < 20) { \
+                printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            } \
+            g_failures++; \
+        } \
+    } while (0)
+
+/**
+ * @brief Redirects stdout into a pipe, the pipe is only read in finish()
+ * so the background thread blocks once the pipe is full
+ */
+class Capture {
+public:
+    Capture() : m_saved(-1) {
+        fflush(stdout);
+        if (pipe(m_pipe) == 0) {
+            m_saved = dup(STDOUT_FILENO);
+            dup2(m_pipe[1], STDOUT_FILENO);
+            close(m_pipe[1]);
+        }
+    }
+
+    //写出所有日志，恢复stdout，返回输出的行
+    std::vector<std::string> finish() {
+        std::vector<std::string> lines;
+        if (m_saved < 0) {
+            return lines;
+        }
+        std::string output;
+        std::thread reader([this, &output]() {
+            char buffer[4096];
+            ssize_t n;
+            while ((n = read(m_pipe[0], buffer, sizeof(buffer))) > 0) {
+                output.append(buffer, n);
+            }
+        });
+        Logger::flush();
+        fflush(stdout);
+        dup2(m_saved, STDOUT_FILENO);
+        close(m_saved);
+        reader.join();
+        close(m_pipe[0]);
+
+        size_t start = 0;
+        size_t end;
+        while ((end = output.find('\n', start)) != std::string::npos) {
+            lines.push_back(output.substr(start, end - start));
+            start = end + 1;
+        }
+        return lines;
+    }
+
+private:
+    int m_pipe[2];
+    int m_saved;
+};
+
+//以prefix开头的行
+std::vector<std::string> select(const std::vector<std::string> &lines, const char *prefix) {
+    std::vector<std::string> selected;
+    for (size_t i = 0; i < lines.size(); i++) {
+        if (lines[i].compare(0, strlen(prefix), prefix) == 0) {
+            selected.push_back(lines[i]);
+        }
+    }
+    return selected;
+}
+
+LogSite g_burst;
+LogSite g_other;
+
+void testRateLimit() {
+    Capture capture;
+    //同一调用点连续25条只输出前10条，另一个调用点不受影响
+    for (int i = 0; i < 25; i++) {
+        Logger::write(g_burst, LogLevelInfo, "burst %d", i);
+    }
+    for (int i = 0; i < 3; i++) {
+        Logger::write(g_other, LogLevelInfo, "other %d", i);
+    }
+    //下一个窗口的第一条带上前一个窗口被抑制的条数，之后再满10条
+    delay(Logger::RATE_WINDOW + 100);
+    for (int i = 0; i < 12; i++) {
+        Logger::write(g_burst, LogLevelInfo, "again %d", i);
+    }
+    std::vector<std::string> lines = capture.finish();
+
+    std::vector<std::string> burst = select(lines, "burst ");
+    CHECK(burst.size() == Logger::RATE_LIMIT);
+    for (size_t i = 0; i < burst.size(); i++) {
+        char expected[32];
+        snprintf(expected, sizeof(expected), "burst %d", static_cast<int>(i));
+        CHECK(burst[i] == expected);
+    }
+    CHECK(select(lines, "other ").size() == 3);
+    std::vector<std::string> again = select(lines, "again ");
+    CHECK(again.size() == Logger::RATE_LIMIT);
+    if (!again.empty()) {
+        CHECK(again[0] == "again 0 (15 similar messages suppressed)");
+        CHECK(again.back() == "again 9");
+    }
+    CHECK(Logger::dropped() == 0);
+}
+
+const int DROP_MESSAGES = 1000;
+LogSite g_sites[DROP_MESSAGES];
+
+void testDropped() {
+    //每条约400字节，管道和stdout缓存放不下时后台线程阻塞，本线程的缓存随后写满
+    std::string padding(380, 'x');
+    uint64_t before = Logger::dropped();
+    Capture capture;
+    for (int i = 0; i < DROP_MESSAGES; i++) {
+        Logger::write(g_sites[i], LogLevelInfo, "drop %d %s", i, padding.c_str());
+    }
+    uint64_t dropped = Logger::dropped() - before;
+    std::vector<std::string> lines = capture.finish();
+
+    std::vector<std::string> written = select(lines, "drop ");
+    CHECK(dropped > 0);
+    CHECK(written.size() + dropped == DROP_MESSAGES);
+    //输出的按写入顺序，没有被截断
+    int last = -1;
+    for (size_t i = 0; i < written.size(); i++) {
+        int index = -1;
+        CHECK(sscanf(written[i].c_str(), "drop %d", &index) == 1 && index > last);
+        CHECK(written[i].size() == written[i].find('x') + padding.size());
+        last = index;
+    }
+    //丢弃的条数在每次输出时报告，合计与Logger::dropped一致
+    std::vector<std::string> reports = select(lines, "[LIDAR SDK] [WARRING]> ");
+    unsigned long long reported = 0;
+    for (size_t i = 0; i < reports.size(); i++) {
+        unsigned long long count = 0;
+        CHECK(sscanf(reports[i].c_str(), "[LIDAR SDK] [WARRING]> %llu log messages dropped", &count) == 1);
+        reported += count;
+    }
+    CHECK(!reports.empty() && reported == dropped);
+}
+
+}
+
+int main()
+{
+    testRateLimit();
+    testDropped();
+    printf("%d failures\n", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,672 @@
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+#include "filters/NoiseFilter.h"
+#include "filters/StreamingNoiseFilter.h"
+#include "math/angles.h"
+
+//NoiseFilter改为查表和直角坐标计算前的实现，逐点计算三角函数，作为输出的基准；
+//StreamingNoiseFilter按扇区推入同样的扫描，与NoiseFilter的结果比较
+
+/**
+ * @brief NoiseFilter as it was before the sin/cos table, every neighbour
+ * pair goes through sin, cos and atan2. Only filter() differs, the
+ * parameters and setStrategy are inherited.
+ */
+class ReferenceNoiseFilter : public NoiseFilter
+{
+public:
+    void filter(const LaserScan &in,
+                int lidarType,
+                int version,
+                LaserScan &out) override
+    {
+        if (FS_Normal == m_strategy) {
+            filter_noise(in, lidarType, version, out);
+        } else if (FS_Tail == m_strategy) {
+            filter_tail(in, lidarType, version, out);
+        } else {
+            filter_tail2(in, lidarType, version, out);
+        }
+    }
+
+private:
+    void filter_noise(const LaserScan &in, int lidarType, int version, LaserScan &out);
+    void filter_tail(const LaserScan &in, int lidarType, int version, LaserScan &out);
+    void filter_tail2(const LaserScan &in, int lidarType, int version, LaserScan &out);
+    double calcInclineAngle(double reading1, double reading2,
+                            double angleBetweenReadings) const;
+    double calcTargetAngle(double reading1, double angle1,
+                           double reading2, double angle2);
+    double calcTargetOffset(double reading1, double angle1,
+                            double reading2, double angle2);
+};
+
+//计算两点连线和原点的夹角（弧度），输入角度单位为度
+double ReferenceNoiseFilter::calcInclineAngle(
+        double reading1,
+        double reading2,
+        double angleBetweenReadings) const
+{
+    angleBetweenReadings = ydlidar::core::math::from_degrees(angleBetweenReadings);
+    return atan2(sin(angleBetweenReadings) * reading2,
+                 reading1 - (cos(angleBetweenReadings) * reading2));
+}
+
+//计算两点的倾斜角（弧度），输入角度单位为度
+double ReferenceNoiseFilter::calcTargetAngle(
+        double reading1,
+        double angle1,
+        double reading2,
+        double angle2)
+{
+    angle1 = ydlidar::core::math::from_degrees(angle1);
+    angle2 = ydlidar::core::math::from_degrees(angle2);
+    double reading1_x = reading1 * cos(angle1);
+    double reading1_y = reading1 * sin(angle1);
+    double reading2_x = reading2 * cos(angle2);
+    double reading2_y = reading2 * sin(angle2);
+    double dx = reading2_x - reading1_x;
+    double dy = reading2_y - reading1_y;
+    return atan2(dy, dx);
+}
+
+double ReferenceNoiseFilter::calcTargetOffset(
+        double reading1,
+        double angle1,
+        double reading2,
+        double angle2)
+{
+    double target_angle = calcTargetAngle(reading1, angle1, reading2, angle2);
+    double cos_inv_angle = cos(-target_angle);
+    double sin_inv_angle = sin(-target_angle);
+    angle2 = ydlidar::core::math::from_degrees(angle2);
+    double reading2_x = reading2 * cos(angle2);
+    double reading2_y = reading2 * sin(angle2);
+    double offset = reading2_x * sin_inv_angle + reading2_y * cos_inv_angle;
+    return offset;
+}
+
+void ReferenceNoiseFilter::filter_noise(
+        const LaserScan &in,
+        int /*lidarType*/,
+        int /*version*/,
+        LaserScan &out)
+{
+    //range is empty
+    if (in.points.empty()) {
+        if (&out != &in) {
+            out = in;
+        }
+        return;
+    }
+
+    std::vector<bool> &maskedPoints = m_masked;
+    double lastRange = in.points[0].range;
+    double lastAngle = in.points[0].angle;
+    double lastInclineRange = lastRange;
+    const int nrPoints = in.points.size();
+    maskedPoints.assign(nrPoints, false);
+    double lastIncline = 0;
+    bool hasFirst = false;
+
+    //copy attributes to filtered scan, nothing to copy when filtering in place
+    if (&out != &in) {
+        out = in;
+    }
+    int pointCount  = 0;
+    double lastOffset = 0;
+    double lastDistance = lastRange;
+    double preAngle = lastAngle;
+    double lastDiff = 0;
+    bool isIncrease = false;
+    int minIndex = 0;
+    double minIndexDistance = 0;
+    double maxDistance = 0;
+    bool isNoise = false;
+    float filter_offset = 0.05;
+
+    for (int i = 0; i < nrPoints; i++) {
+        double current_range = in.points[i].range;//current lidar distance
+        double current_angle = in.points[i].angle;//current lidar angle
+
+        if (isRangeValid(in.config, current_range)) {
+
+            double offset;
+
+            if (isRangeValid(in.config, lastRange)) {
+                offset = calcTargetOffset(lastRange, lastAngle, current_range,
+                                          current_angle);//calculate offset distance
+            } else {
+                offset = calcTargetOffset(lastDistance, preAngle, current_range,
+                                          current_angle);//calculate offset distance
+            }
+
+            double Diff = current_range - lastDistance;//distance difference
+
+            if (fabs(Diff) > lastDistance * 0.2 && fabs(offset) < 0.2 &&
+                    isRangeValid(in.config, lastDistance)) {
+                isNoise = true;
+                filter_offset = fabs(offset) + 0.05;
+                maxDistance = current_range;
+                maskedPoints[i] = true;
+            }
+
+            if (isNoise && fabs(offset) > filter_offset) {
+                isNoise = false;
+            }
+
+            if (isNoise) {
+                if (pointCount == 0) {
+                    minIndex = i;
+                    minIndexDistance = current_range;
+                }
+
+                if (current_range > maxDistance) {
+                    maxDistance = current_range;
+                }
+
+                pointCount++;
+            } else {
+                if (pointCount >= 2) {
+                    bool isincre = (in.points[minIndex].range - lastDistance) < 0;
+
+                    for (int j = minIndex - nonMaskedNeighbours; j <= i + nonMaskedNeighbours;
+                         j++) {
+                        if (j >= 0 && j < nrPoints) {
+                            double offset = calcTargetOffset(in.points[j].range, in.points[j].angle,
+                                                             lastDistance,
+                                                             preAngle);//calculate offset distance
+
+                            if (in.points[j].range > maxDistance) {
+                                maxDistance = in.points[j].range;
+                            }
+
+                            if (offset < filter_offset && maxDistance > filter_offset &&
+                                    maxDistance > 0.2) {
+                                maskedPoints[j] = true;
+                            }
+                        }
+                    }
+                }
+
+                pointCount = 0;
+                minIndex = 0;
+                maxDistance = 0.0;
+            }
+
+            lastOffset = offset;//last offset
+            lastDiff = Diff;//last distance difference
+            lastDistance = current_range;//last distance
+            preAngle = current_angle;
+        }
+
+        lastAngle = current_angle;//last angle
+        lastRange = current_range;//last range
+    }
+
+    //mark all masked points as invalid in scan
+    for (unsigned int i = 0; i < in.points.size(); i++) {
+        if (maskedPoints[i]) {
+            //as we don't have a better error this is an other range error for now
+            out.points[i].range = 0.0;
+        }
+    }
+}
+
+void ReferenceNoiseFilter::filter_tail(
+        const LaserScan &in,
+        int /*lidarType*/,
+        int /*version*/,
+        LaserScan &out)
+{
+
+    //假设激光的原点是O，对于任何两个点P1和P2，则形成角∠OP1P2，
+    //如果该角度小于最小阈值角度（min_angle）或大于最大阈值角度（max_angle），
+    //我们将该点及其附近符合条件的点移除。
+
+    //range is empty
+    if (in.points.empty()) {
+        if (&out != &in) {
+            out = in;
+        }
+        return;
+    }
+
+    std::vector<bool> &maskedPoints = m_masked;
+    double lastRange = in.points[0].range;
+    double lastAngle = in.points[0].angle;
+    double lastInclineRange = lastRange;
+    const int size = in.points.size();
+    maskedPoints.assign(size, false);
+    double lastIncline = 0;
+    bool hasFirst = false;
+
+    //copy attributes to filtered scan, nothing to copy when filtering in place
+    if (&out != &in) {
+        out = in;
+    }
+    double lastDistance = 0;
+    int max_skip_step = 5 * maskedNeighbours;
+
+    if (max_skip_step > 7) {
+        max_skip_step = 7;
+    }
+
+    std::vector<FilterBlock> m_block_vct;
+    FilterBlock m_block;
+    bool isNextBlock = true;
+    int inValidPointCount = 0;
+
+    for (int i = 0; i < size; i++)
+    {
+        double range = in.points[i].range;//current lidar distance
+        double angle = in.points[i].angle;//current lidar angle
+
+        if (isRangeValid(in.config, range)
+                /*&& isRangeValid(in.config, lastDistance)*/)
+        {
+            if (maskedFilter && isRangeValid(in.config, lastDistance))
+            {
+                const double incline = calcInclineAngle(
+                            in.points[i].range,
+                            lastDistance,
+                            angle - lastAngle);
+
+                if (!hasFirst) {
+                    hasFirst = true;
+                    lastIncline = incline;
+                }
+
+                bool isValid = false;
+
+                //this is a filter for false readings that do occur if one scannes over edgeds of objects
+                //如果计算的夹角超出规定的范围
+                if (incline < minIncline || incline > maxIncline)
+                {
+                    //mask neighbour points
+                    for (int j = -maskedNeighbours; j < maskedNeighbours; j++)
+                    {
+                        if ((int(i) + j < 0)
+                                || ((int(i) + j) >= size)) {
+                            continue;
+                        }
+                        if (i + j - 1 < 0) {
+                            continue;
+                        }
+
+                        //如果当前点相邻N点中有偏移量较大的点则认为是噪点
+                        double offset = calcTargetOffset(in.points[i + j - 1].range,
+                                in.points[i + j - 1].angle,
+                                in.points[i + j].range,
+                                in.points[i + j].angle); //calculate offset distance
+                        if (offset < 0.2) {
+                            maskedPoints[i + j] = true;
+                            isValid = true;
+                        }
+                    }
+
+                    if (isValid) {
+                        if (isNextBlock) {
+                            isNextBlock = false;
+                            m_block.start_index = i;
+                        }
+
+                        m_block.end_index = i;
+                        inValidPointCount = 0;
+                    } else {
+                        inValidPointCount++;
+                    }
+                }
+                else
+                {
+                    inValidPointCount++;
+                }
+
+                //如果上一个夹角和当前夹角差值过大则认为是噪点
+                if (fabs(lastIncline - incline) > maxIncline - minIncline) {
+                    maskedPoints[i] = true;
+                }
+
+                lastInclineRange = range;
+                lastIncline = incline;
+            }
+
+            lastDistance = range;//last distance
+        }
+
+        if (inValidPointCount > max_skip_step) {
+            if (!isNextBlock) {
+                m_block_vct.push_back(m_block);
+                isNextBlock = true;
+            }
+        }
+
+        lastAngle = angle;//last angle
+        lastRange = range;//last range
+    }
+
+    //mark all masked points as invalid in scan
+    for (unsigned int i = 0; i < in.points.size(); i++) {
+        if (maskedPoints[i]) {
+            //as we don't have a better error this is an other range error for now
+            out.points[i].range = 0.0;
+        }
+    }
+
+}
+
+void ReferenceNoiseFilter::filter_tail2(
+        const LaserScan &in,
+        int /*lidarType*/,
+        int /*version*/,
+        LaserScan &out)
+{
+
+    if (&out != &in) {
+        out = in;
+    }
+
+    if (in.points.empty()) {
+        return;
+    }
+
+    //1、找出连续（至少3个）点倾斜角朝向原点（极点）的点序列
+    //2、判断该点序列首尾点组成的角度范围是否在光斑对应角度范围内
+    //3、判断该点序列的强度信息是否满足约定条件（未找到规律，暂未使用）
+    //4、去掉该点序列的首尾点（首尾点是正常的）
+
+    std::vector<bool> &noises = m_masked; //是否为噪点的标记
+    size_t size = in.points.size(); //一圈点数
+    size_t lastIndex = 0; //上一个有效点的索引位置
+    LaserPoint lastP = {0, 0, 0}; //上一个点信息
+    bool hasLast = false; //是否已有上一个有效点
+    float lastIncline = .0; //上一个倾斜角
+    float lastAngle = 90.0; //上一个夹角
+    size_t pos = 0; //标记拖尾起始点下标位置
+    size_t sizeEx = size + (size * 2 / 100 + 1); //将遍历范围扩大到原数组的102%以便处理首尾部分的点
+
+    noises.assign(size, false);
+
+    //主循环函数
+    for (size_t i = 0; i < sizeEx; ++i)
+    {
+        const LaserPoint& p = in.points.at(i % size);
+
+        if (!isRangeValid(in.config, p.range))
+        {
+            continue;
+        }
+
+        if (hasLast)
+        {
+            //计算两点连线、两点中间点到原点连线的倾斜角（弧度值）
+            float incline2 = calcTargetAngle(
+                        lastP.range,
+                        lastP.angle,
+                        p.range,
+                        p.angle);
+            float incline3 = calcTargetAngle(
+                        (lastP.range + p.range) / 2.0f,
+                        (lastP.angle + p.angle) / 2.0f,
+                        0.0f,
+                        0.0f);
+            //转角度值
+            incline2 = ydlidar::core::math::to_degrees(incline2);
+            incline3 = ydlidar::core::math::to_degrees(incline3);
+
+            float incline = incline2;
+
+            //计算两点连线和两点中间点到原点连线的夹角
+            float angle = fabs(incline2 - incline3);
+            if (angle > 180.0f)
+                angle = 360.0f - angle;
+            if (angle > 90.0f)
+                angle = 180.0f - angle;
+
+            //如果倾斜角变化很小则认为是一条直线上的
+            if (fabs(incline - lastIncline) < maxInclineAngle)
+            {
+                //如果上一个夹角不满足要求
+                if (fabs(lastAngle) >= maxIncludeAngle)
+                {
+                    pos = 0;
+                }
+                //TODO: 需要考虑是否是最后一个点
+            }
+            else
+            {
+                if (fabs(lastAngle) < maxIncludeAngle) //判断上一个夹角是否满足要求
+                {
+                    //判断点的个数是否超过2个，超过2个才可能是拖尾噪点
+                    if (0 != pos && i - pos >= MIN_NOISEPOINT_COUNT)
+                    {
+                        //统计从位置pos到i的有效点数
+                        size_t validCount = 0;
+                        for (size_t j=pos; j<=i; ++j)
+                        {
+                            if (isRangeValid(in.config, in.points[j % size].range))
+                                validCount += 1;
+                        }
+                        if (validCount >= MIN_NOISEPOINT_COUNT)
+                        {
+                            for (size_t j=pos; j<=i; ++j)
+                            {
+                                noises[j % size] = true;
+                            }
+                        }
+                    }
+                    pos = 0;
+                }
+                if (0 == pos && fabs(angle) < maxIncludeAngle) //判断当前夹角是否满足要求
+                {
+                    //疑似拖尾点，标记
+                    pos = lastIndex;
+                }
+                else
+                {
+                    pos = 0;
+                }
+            }
+
+            lastIncline = incline;
+            lastAngle = angle;
+        }
+
+        lastIndex = i;
+        lastP = p;
+        hasLast = true;
+    }
+
+    //处理被标记的点
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (noises[i])
+        {
+            out.points[i].range = 0.0f;
+        }
+    }
+}
+
+namespace {
+
+//固定种子，每次运行的扫描相同
+uint32_t g_seed = 20261019;
+
+uint32_t nextRandom() {
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return g_seed >> 8;
+}
+
+double uniform(double lo, double hi) {
+    return lo + (hi - lo) * (nextRandom() / 16777216.0);
+}
+
+/**
+ * @brief A scan of walls at random distances with spikes, holes and
+ * smeared edges, starting anywhere so the angles may cross 360 degrees
+ * @param offGrid   shift the angles off the 0.01 degree grid
+ */
+void makeScan(LaserScan &scan, bool offGrid) {
+    const int size = 500 + nextRandom() % 7001;
+    const int start = nextRandom() % 36000;
+    scan.points.resize(size);
+    scan.config.min_range = 0.01f;
+    scan.config.max_range = 64.f;
+
+    double wall = uniform(0.3, 15.0);
+    double normal = uniform(0, 2 * M_PI);
+    int left = 0;
+    double previous = wall;
+    for (int i = 0; i < size; i++) {
+        LaserPoint &p = scan.points[i];
+        long k = (start + lround(i * 36000.0 / size)) % 36000;
+        p.angle = k / 100.0f + (offGrid ? 0.0037f : 0.f);
+        p.intensity = static_cast<float>(nextRandom() % 256);
+        if (--left <= 0) {
+            previous = wall;
+            wall = uniform(0.3, 15.0);
+            normal = ydlidar::core::math::from_degrees(p.angle) + uniform(-1.2, 1.2);
+            left = 5 + nextRandom() % 200;
+        }
+        double c = cos(ydlidar::core::math::from_degrees(p.angle) - normal);
+        double range = c > 0.2 ? wall / c : wall * 5;
+        uint32_t kind = nextRandom() % 100;
+        if (kind < 3) {
+            range = 0;//无回波
+        } else if (kind < 6) {
+            range *= uniform(0.3, 1.7);//孤立噪点
+        } else if (left > 190) {
+            //墙与墙之间的拖尾
+            double t = (200 - left) / 10.0;
+            range = previous + (range - previous) * t;
+        }
+        p.range = range < 64 ? static_cast<float>(range) : 0.f;
+    }
+}
+
+/**
+ * @brief Push a scan through a streaming filter in sectors of random
+ * size, several revolutions in a row, and collect what it emits
+ */
+void stream(StreamingNoiseFilter &filter, const LaserScan &in, int revolutions,
+            std::vector<LaserPoint> &points) {
+    LaserScan sector;
+    LaserScan out;
+    sector.config = in.config;
+    points.clear();
+    for (int r = 0; r < revolutions; r++) {
+        for (size_t first = 0; first < in.points.size(); first += sector.points.size()) {
+            size_t count = std::min<size_t>(1 + nextRandom() % 400, in.points.size() - first);
+            sector.points.assign(in.points.begin() + first, in.points.begin() + first + count);
+            filter.push(sector, out);
+            points.insert(points.end(), out.points.begin(), out.points.end());
+        }
+    }
+    filter.flush(out);
+    points.insert(points.end(), out.points.begin(), out.points.end());
+}
+
+/**
+ * @brief Compare the masks of StreamingNoiseFilter and NoiseFilter
+ * @param extra      points held beyond minDelay()
+ * @param exact      false if the stream may leave points of a run longer
+ *  than the delay unmasked, it must never mask more
+ * @return mismatches
+ */
+int compareStreaming(int strategy, size_t extra, bool exact) {
+    const int SCANS = 40;
+    NoiseFilter filter;
+    filter.setStrategy(strategy);
+    //拖尾2的整圈滤波首尾回绕，相当于前后都有同样的一圈，流式按连续三圈比较中间一圈
+    const bool wraps = strategy >= NoiseFilter::FS_TailStrong;
+    int failures = 0;
+    size_t missed = 0;
+    for (int n = 0; n < SCANS; n++) {
+        LaserScan in;
+        makeScan(in, n % 4 == 3);
+        LaserScan expected;
+        filter.filter(in, 0, 0, expected);
+
+        StreamingNoiseFilter streaming;
+        streaming.setStrategy(strategy);
+        streaming.setDelay(streaming.minDelay() + extra);
+        std::vector<LaserPoint> points;
+        stream(streaming, in, wraps ? 3 : 1, points);
+        const size_t size = in.points.size();
+        if (points.size() != size * (wraps ? 3 : 1)) {
+            printf("strategy %d scan %d: %zu points emitted\n", strategy, n, points.size());
+            failures++;
+            continue;
+        }
+        const size_t base = wraps ? size : 0;
+        for (size_t i = 0; i < size; i++) {
+            const LaserPoint &p = points[base + i];
+            bool a = p.range == 0.f;
+            bool b = expected.points[i].range == 0.f;
+            bool ok = p.angle == in.points[i].angle && (a || p.range == in.points[i].range);
+            if (a != b) {
+                missed += b;
+                ok = ok && !exact && b;
+            }
+            if (!ok) {
+                if (failures < 10) {
+                    printf("strategy %d delay %zu scan %d point %zu: masked %d, expected %d\n",
+                           strategy, streaming.delay(), n, i, a, b);
+                }
+                failures++;
+            }
+        }
+    }
+    printf("strategy %d streaming, %zu points held beyond the minimum: %zu masks missed\n",
+           strategy, extra, missed);
+    return failures;
+}
+
+}
+
+int main()
+{
+    const int SCANS = 60;
+    int failures = 0;
+    size_t points = 0;
+    for (int strategy = NoiseFilter::FS_Normal; strategy <= NoiseFilter::FS_TailStrong2; strategy++) {
+        NoiseFilter filter;
+        ReferenceNoiseFilter reference;
+        filter.setStrategy(strategy);
+        reference.setStrategy(strategy);
+        size_t masked = 0;
+        for (int n = 0; n < SCANS; n++) {
+            LaserScan in;
+            makeScan(in, n % 4 == 3);
+            LaserScan out;
+            LaserScan expected;
+            filter.filter(in, 0, 0, out);
+            reference.filter(in, 0, 0, expected);
+            for (size_t i = 0; i < in.points.size(); i++) {
+                bool a = out.points[i].range == 0.f;
+                bool b = expected.points[i].range == 0.f;
+                masked += b;
+                if (a != b) {
+                    if (failures < 10) {
+                        printf("strategy %d scan %d point %zu angle %.4f: masked %d, expected %d\n",
+                               strategy, n, i, in.points[i].angle, a, b);
+                    }
+                    failures++;
+                }
+            }
+            points += in.points.size();
+        }
+        printf("strategy %d: %zu points masked by the reference\n", strategy, masked);
+    }
+    printf("%zu points compared, %d mismatches\n", points, failures);
+
+    //最短延迟下拖尾的固定邻域要完全一致，其他策略只会少标记超出延迟的长段；
+    //延迟长于所有噪点段时每个策略都完全一致
+    for (int strategy = NoiseFilter::FS_Normal; strategy <= NoiseFilter::FS_TailStrong2; strategy++) {
+        failures += compareStreaming(strategy, 0, NoiseFilter::FS_Tail == strategy);
+        failures += compareStreaming(strategy, 1000, true);
+    }
+    return failures ? 1 : 0;
+}
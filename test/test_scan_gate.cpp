@@ -0,0 +1,250 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "core/common/ScanGate.h"
+#include "core/common/ydlidar_help.h"
+#include "core/common/ydlidar_protocol.h"
+#include "TEALidarDriver.h"
+
+using namespace ydlidar::core::common;
+
+//按表中的安装方式和窗口检查角度位图、数据块标记和角度映射，
+//再经过解码确认零位标记按映射前的角度判断
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond, name) do { \
+        if (!(cond)) { \
+            if (g_failures < 20) { \
+                printf("%s:%d: %s: %s\n", __FILE__, __LINE__, name, #cond); \
+            } \
+            g_failures++; \
+        } \
+    } while (0)
+
+struct Probe {
+    long decoded;  ///< decoded angle, 0.01 degree
+    bool keep;
+};
+
+struct GateCase {
+    const char *name;
+    float minAngle;
+    float maxAngle;
+    std::vector<float> ignore;
+    bool reversion;
+    bool inverted;
+    float offset;
+    std::vector<Probe> probes;
+};
+
+//安装坐标下的角度，0.01度
+long mounted(const GateCase &c, long decoded) {
+    long shift = lround(c.offset * 100.0) + (c.reversion ? 18000 : 0);
+    long angle = c.inverted ? -(decoded + shift) : decoded + shift;
+    return (angle % 36000 + 36000) % 36000;
+}
+
+//a是否在从start开始、逆时针到end的区间内，单位0.01度
+bool inSector(long a, float start, float end) {
+    long first = (lround(start * 100.0) % 36000 + 36000) % 36000;
+    long span = lround((end - start) * 100.0);
+    if (end - start >= 360.f) {
+        return true;
+    }
+    span = (span % 36000 + 36000) % 36000;
+    return (a - first + 36000) % 36000 <= span;
+}
+
+bool reference(const GateCase &c, long decoded) {
+    long a = mounted(c, decoded);
+    if (c.maxAngle - c.minAngle < 360.f && !inSector(a, c.minAngle, c.maxAngle)) {
+        return false;
+    }
+    for (size_t i = 0; i + 1 < c.ignore.size(); i += 2) {
+        if (inSector(a, c.ignore[i], c.ignore[i + 1])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void configure(const GateCase &c, ScanGate &gate) {
+    gate.setOrientation(c.reversion, c.inverted, c.offset);
+    gate.setWindow(c.minAngle, c.maxAngle, 0.f, 0.f);
+    gate.setIgnore(c.ignore);
+}
+
+const std::vector<GateCase> &cases() {
+    static const std::vector<GateCase> table = {
+        {"window across 0", 300.f, 60.f, {}, false, false, 0.f,
+            {{0, true}, {6000, true}, {6001, false}, {29999, false}, {30000, true},
+             {35999, true}, {36000, true}, {42001, false}, {65535, false}}},
+        {"negative minimum", -60.f, 60.f, {}, false, false, 0.f,
+            {{0, true}, {6000, true}, {6001, false}, {29999, false}, {30000, true}}},
+        {"overlapping ignores", 0.f, 360.f, {10.f, 30.f, 20.f, 40.f, 350.f, 5.f}, false, false, 0.f,
+            {{999, true}, {1000, false}, {2500, false}, {4000, false}, {4001, true},
+             {34999, true}, {35000, false}, {0, false}, {500, false}, {501, true}}},
+        {"ignore of a whole turn", 0.f, 360.f, {0.f, 400.f}, false, false, 0.f,
+            {{0, false}, {18000, false}, {65535, false}}},
+        {"inverted with offset", 0.f, 90.f, {}, false, true, 30.f,
+            {{0, false}, {23999, false}, {24000, true}, {30000, true}, {33000, true}, {33001, false}}},
+        {"reversed with offset and ignore", 0.f, 360.f, {0.f, 10.f}, true, false, -45.5f,
+            {{22549, true}, {22550, false}, {23550, false}, {23551, true}}},
+        {"inverted and reversed across 0", 350.f, 10.f, {355.f, 356.f}, true, true, 12.34f,
+            {}},
+        {"nothing gated", 0.f, 360.f, {}, false, false, 0.f,
+            {{0, true}, {35999, true}, {65535, true}}},
+    };
+    return table;
+}
+
+void testGate() {
+    for (const GateCase &c : cases()) {
+        ScanGate gate;
+        configure(c, gate);
+        for (const Probe &p : c.probes) {
+            CHECK(gate.visible(static_cast<uint16_t>(p.decoded), 1000) == p.keep, c.name);
+        }
+        //每个uint16角度都与按定义计算的结果一致
+        long kept = 0;
+        for (long a = 0; a < ScanGate::ANGLE_MASK_SIZE; a++) {
+            uint16_t angle = static_cast<uint16_t>(a);
+            CHECK(gate.mapAngle(angle) == mounted(c, a), c.name);
+            CHECK(gate.visible(angle, 1000) == reference(c, a), c.name);
+            kept += gate.visible(angle, 1000);
+        }
+        CHECK(gate.isActive() == (kept < ScanGate::ANGLE_MASK_SIZE), c.name);
+
+        //数据块标记不能漏掉窗口内的点，包括跨越窗口边界和uint16回绕的块
+        long skipped = 0;
+        for (long s = 0; s < ScanGate::ANGLE_MASK_SIZE; s++) {
+            bool any = false;
+            for (long k = 0; k <= ScanGate::MAX_BLOCK_SPAN && !any; k++) {
+                any = gate.visible(static_cast<uint16_t>(s + k), 1000);
+            }
+            if (any) {
+                CHECK(gate.blockVisible(static_cast<uint16_t>(s)), c.name);
+            }
+            skipped += !gate.blockVisible(static_cast<uint16_t>(s));
+        }
+        if (!kept) {
+            CHECK(skipped == ScanGate::ANGLE_MASK_SIZE, c.name);
+        }
+    }
+
+    //窗口15到20度：14度起始的块伸入窗口，21度起始的块全在窗口外，
+    //655度起始的块在uint16回绕后不超过10.71度，不在窗口内
+    ScanGate gate;
+    gate.setWindow(15.f, 20.f, 0.f, 0.f);
+    CHECK(gate.blockVisible(1400), "block edge");
+    CHECK(gate.blockVisible(2050), "block edge");
+    CHECK(!gate.blockVisible(2100), "block edge");
+    CHECK(!gate.blockVisible(65500), "block wrap");
+    gate.setWindow(0.f, 20.f, 0.f, 0.f);
+    CHECK(gate.blockVisible(65500), "block wrap");
+
+    //距离边界包含在内
+    gate.setWindow(0.f, 360.f, 0.1f, 10.f);
+    CHECK(!gate.visible(0, 99) && gate.visible(0, 100), "range");
+    CHECK(gate.visible(0, 10000) && !gate.visible(0, 10001), "range");
+    CHECK(!gate.visible(0, 0), "range");
+    gate.clear();
+    CHECK(!gate.isActive() && gate.visible(0, 0), "clear");
+    CHECK(!gate.setIgnore(std::vector<float>(3, 0.f)), "odd ignore");
+}
+
+/**
+ * @brief Exposes the frame decoder of the driver
+ */
+class DecodeProbe : public ydlidar::TEALidarDriver {
+public:
+    using ydlidar::TEALidarDriver::decodeFrame;
+    using ydlidar::TEALidarDriver::resetDecodeState;
+};
+
+/**
+ * @brief Two and a half revolutions of 0.1 degree steps, 16 points per
+ * block, the decoded angles go up to 360.00 before wrapping
+ */
+void makeFrames(std::vector<NetDataFrame> &frames, std::vector<long> &angles) {
+    const uint32_t step = 10;
+    uint32_t start = 0;
+    uint32_t stamp = 0;
+    for (int f = 0; f < 48; f++) {
+        NetDataFrame frame = NetDataFrame();
+        for (int i = 0; i < DATABLOCK_COUNT; i++) {
+            NetDataBlock &block = frame.dataBlock[i];
+            block.frameHead = BigLittleSwap16(0xFFEE);
+            block.startAngle = BigLittleSwap16(start);
+            for (int j = 0; j < DATA_COUNT; j++) {
+                uint32_t distance = 1000 + (start + j) % 500;
+                block.data[j] = BigLittleSwap32((step << 24) | (100u << 16) | distance);
+                angles.push_back(start + step * (j + 1));
+            }
+            start = (start + step * DATA_COUNT) % 36000;
+        }
+        stamp += 10000;
+        frame.timeStamp = BigLittleSwap32(stamp);
+        frame.factory = 0x21436500 | (f & 0x0F);
+        frames.push_back(frame);
+    }
+}
+
+void testSync() {
+    std::vector<NetDataFrame> frames;
+    std::vector<long> angles;
+    makeFrames(frames, angles);
+    for (const GateCase &c : cases()) {
+        DecodeProbe driver;
+        driver.setOrientation(c.reversion, c.inverted, c.offset);
+        driver.setScanWindow(c.minAngle, c.maxAngle, 0.f, 0.f);
+        driver.setIgnoreArray(c.ignore);
+        driver.resetDecodeState();
+
+        //期望的输出：保留的点按顺序，解码角度比上一个保留点小时为零位
+        std::vector<long> expected;
+        std::vector<bool> sync;
+        long last = 0;
+        for (long a : angles) {
+            if (reference(c, a)) {
+                expected.push_back(mounted(c, a));
+                sync.push_back(a < last);
+                last = a;
+            }
+        }
+
+        size_t n = 0;
+        size_t syncs = 0;
+        size_t wraps = 0;
+        for (size_t i = 0; i < sync.size(); i++) {
+            wraps += sync[i];
+        }
+        for (const NetDataFrame &frame : frames) {
+            node_info nodes[DATABLOCK_COUNT * DATA_COUNT];
+            size_t count = 0;
+            CHECK(driver.decodeFrame(frame, nodes, count, 0) == RESULT_OK, c.name);
+            for (size_t i = 0; i < count && n < expected.size(); i++, n++) {
+                CHECK(nodes[i].angle_q6_checkbit == expected[n], c.name);
+                CHECK(((nodes[i].sync_flag & Node_Sync) != 0) == sync[n], c.name);
+                syncs += (nodes[i].sync_flag & Node_Sync) != 0;
+            }
+        }
+        CHECK(n == expected.size(), c.name);
+        //保留的点跨过至少一次回绕
+        CHECK(syncs == wraps && (expected.empty() || wraps > 0), c.name);
+    }
+}
+
+}
+
+int main()
+{
+    testGate();
+    testSync();
+    printf("%zu cases, %d failures\n", cases().size(), g_failures);
+    return g_failures ? 1 : 0;
+}
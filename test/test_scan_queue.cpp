@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include "core/common/ScanQueue.h"
+#include "core/common/ydlidar_def.h"
+#include "core/base/timer.h"
+
+using namespace ydlidar::core::common;
+
+namespace {
+
+const size_t CAPACITY = 16;
+
+int g_failures = 0;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            g_failures++; \
+        } \
+    } while (0)
+
+//第一个节点的距离记录推入时的编号，用来确认弹出的是哪一圈
+uint64_t pushScan(ScanQueue &queue, uint16_t tag, size_t count = 4, uint64_t *pushed = NULL) {
+    node_info nodes[CAPACITY + 4];
+    memset(nodes, 0, sizeof(nodes));
+    for (size_t i = 0; i < count; i++) {
+        nodes[i].distance_q2 = tag;
+        nodes[i].angle_q6_checkbit = static_cast<uint16_t>(i);
+    }
+    return queue.push(nodes, count, pushed);
+}
+
+//弹出一圈，返回它的编号，失败返回-1
+long popScan(ScanQueue &queue, scan_sequence &sequence, uint32_t timeout = 0, size_t *count = NULL) {
+    node_info nodes[CAPACITY];
+    size_t size = count ? *count : CAPACITY;
+    result_t ret = queue.pop(nodes, size, &sequence, timeout);
+    if (count) {
+        *count = size;
+    }
+    return IS_OK(ret) ? nodes[0].distance_q2 : -1;
+}
+
+void testDepthClamp() {
+    ScanQueue queue;
+    scan_sequence sequence;
+    queue.setup(ScanQueue::MAX_DEPTH + 10, ScanQueueFifo, CAPACITY);
+    for (uint16_t i = 1; i <= ScanQueue::MAX_DEPTH + 8; i++) {
+        CHECK(pushScan(queue, i) == i);
+    }
+    CHECK(queue.size() == ScanQueue::MAX_DEPTH);
+    CHECK(queue.dropped() == 8);
+    //先进先出，最早的8圈被覆盖
+    for (long i = 9; i <= ScanQueue::MAX_DEPTH + 8; i++) {
+        CHECK(popScan(queue, sequence) == i);
+        CHECK(sequence.seq == static_cast<uint64_t>(i));
+        CHECK(sequence.dropped == 8);
+    }
+    CHECK(queue.size() == 0);
+
+    //深度0按1处理
+    queue.setup(0, ScanQueueFifo, CAPACITY);
+    pushScan(queue, 1);
+    pushScan(queue, 2);
+    CHECK(queue.size() == 1);
+    CHECK(popScan(queue, sequence) == 2);
+}
+
+void testLatestOnly() {
+    ScanQueue queue;
+    scan_sequence sequence;
+    queue.setup(8, ScanQueueLatestOnly, CAPACITY);
+    for (uint16_t i = 1; i <= 5; i++) {
+        pushScan(queue, i);
+    }
+    //只保留最新一圈，之前的都记为丢弃
+    CHECK(queue.size() == 1);
+    CHECK(queue.dropped() == 4);
+    CHECK(popScan(queue, sequence) == 5);
+    CHECK(sequence.seq == 5);
+    CHECK(sequence.dropped == 4);
+
+    //未知策略按只保留最新处理
+    queue.setup(8, 7, CAPACITY);
+    pushScan(queue, 6);
+    pushScan(queue, 7);
+    CHECK(queue.size() == 1);
+    CHECK(popScan(queue, sequence) == 7);
+    CHECK(sequence.seq == 7);
+    CHECK(sequence.dropped == 5);
+}
+
+void testFifoOrder() {
+    ScanQueue queue;
+    scan_sequence sequence;
+    queue.setup(3, ScanQueueFifo, CAPACITY);
+    uint64_t pushed = 0;
+    pushScan(queue, 1, 4, &pushed);
+    pushScan(queue, 2);
+    CHECK(popScan(queue, sequence) == 1);
+    CHECK(sequence.pushed == pushed);
+    pushScan(queue, 3);
+    pushScan(queue, 4);
+    pushScan(queue, 5);//满了，丢弃最早的2
+    CHECK(queue.dropped() == 1);
+    CHECK(popScan(queue, sequence) == 3);
+    CHECK(sequence.seq == 3 && sequence.dropped == 1);
+    CHECK(popScan(queue, sequence) == 4);
+    CHECK(popScan(queue, sequence) == 5);
+    CHECK(sequence.seq == 5 && sequence.dropped == 1);
+
+    //节点数截断到容量和调用方的缓冲区
+    pushScan(queue, 6, CAPACITY + 4);
+    size_t count = CAPACITY;
+    CHECK(popScan(queue, sequence, 0, &count) == 6);
+    CHECK(count == CAPACITY);
+    pushScan(queue, 7, 8);
+    count = 3;
+    CHECK(popScan(queue, sequence, 0, &count) == 7);
+    CHECK(count == 3);
+
+    //未setup时推入的圈都记为丢弃，编号照常增加
+    ScanQueue empty;
+    CHECK(pushScan(empty, 1) == 1);
+    CHECK(pushScan(empty, 2) == 2);
+    CHECK(empty.dropped() == 2);
+    CHECK(empty.size() == 0);
+}
+
+void testTimeout() {
+    ScanQueue queue;
+    scan_sequence sequence;
+    queue.setup(4, ScanQueueFifo, CAPACITY);
+    pushScan(queue, 1);
+    pushScan(queue, 2);
+    CHECK(popScan(queue, sequence, 50) == 1);
+    CHECK(popScan(queue, sequence, 50) == 2);
+
+    //取空后事件已复位，不会立即返回
+    uint32_t start = getms();
+    size_t count = CAPACITY;
+    node_info nodes[CAPACITY];
+    CHECK(queue.pop(nodes, count, &sequence, 30) == RESULT_TIMEOUT);
+    CHECK(count == 0);
+    CHECK(getms() - start >= 25);
+
+    //clear同样复位事件
+    pushScan(queue, 3);
+    queue.clear();
+    count = CAPACITY;
+    CHECK(queue.pop(nodes, count, &sequence, 10) == RESULT_TIMEOUT);
+
+    //wakeup唤醒等待方但没有数据
+    queue.wakeup();
+    count = CAPACITY;
+    CHECK(queue.pop(nodes, count, &sequence, 1000) == RESULT_FAIL);
+    CHECK(count == 0);
+}
+
+void testWait() {
+    ScanQueue queue;
+    scan_sequence sequence;
+    queue.setup(2, ScanQueueFifo, CAPACITY);
+    //等待中的pop被另一线程的push唤醒
+    std::thread producer([&queue]() {
+        delay(30);
+        pushScan(queue, 42);
+    });
+    CHECK(popScan(queue, sequence, 2000) == 42);
+    CHECK(sequence.seq == 1);
+    producer.join();
+}
+
+}
+
+int main()
+{
+    testDepthClamp();
+    testLatestOnly();
+    testFifoOrder();
+    testTimeout();
+    testWait();
+    printf("%d failures\n", g_failures);
+    return g_failures ? 1 : 0;
+}
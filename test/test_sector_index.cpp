@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "core/common/SectorIndex.h"
+
+using namespace ydlidar::core::common;
+
+//扇区最小值和稀疏表的区间查询与逐点、逐扇区的暴力搜索比较，包括经过0度的区间和没有回波的扇区
+
+namespace {
+
+uint32_t g_seed = 20261019;
+
+uint32_t nextRandom() {
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return g_seed >> 8;
+}
+
+int g_failures = 0;
+
+void check(bool ok, const char *what, size_t sectors, size_t first, size_t last) {
+    if (!ok) {
+        if (g_failures < 10) {
+            printf("%s: %zu sectors, [%zu, %zu]\n", what, sectors, first, last);
+        }
+        g_failures++;
+    }
+}
+
+/**
+ * @brief A revolution with gaps, some arcs have no point or only invalid
+ * ones so whole sectors stay empty, and decoded angles may exceed 360
+ */
+void makeScan(std::vector<node_info> &nodes) {
+    nodes.clear();
+    const uint32_t step = 1 + nextRandom() % 40;
+    const uint32_t gapStart = nextRandom() % 36000;
+    const uint32_t gapSize = nextRandom() % 9000;
+    const uint32_t offset = nextRandom() % 2 ? 36000 : 0;
+    for (uint32_t a = nextRandom() % step; a < 36000; a += step) {
+        if ((a - gapStart + 36000) % 36000 < gapSize) {
+            continue;
+        }
+        node_info node;
+        memset(&node, 0, sizeof(node));
+        //超过360度的解码角度取模后落在同一扇区
+        node.angle_q6_checkbit = static_cast<uint16_t>(a + (a < 29535 ? offset : 0));
+        node.distance_q2 = nextRandom() % 10 ? static_cast<uint16_t>(1 + nextRandom() % 4000) : 0;
+        nodes.push_back(node);
+    }
+}
+
+//逐点求每个扇区最近的回波，距离相同时取角度小的
+std::vector<uint32_t> sectorMinima(const std::vector<node_info> &nodes, size_t sectors) {
+    std::vector<uint32_t> minima(sectors, SectorIndex::EMPTY);
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (!nodes[i].distance_q2) {
+            continue;
+        }
+        uint32_t angle = nodes[i].angle_q6_checkbit % 36000;
+        size_t sector = angle * sectors / 36000;
+        uint32_t packed = (static_cast<uint32_t>(nodes[i].distance_q2) << 16) | angle;
+        if (packed < minima[sector]) {
+            minima[sector] = packed;
+        }
+    }
+    return minima;
+}
+
+//逐个扇区搜索first到last
+uint32_t bruteForce(const std::vector<uint32_t> &minima, size_t first, size_t last) {
+    uint32_t best = SectorIndex::EMPTY;
+    for (size_t k = first; ; k = (k + 1) % minima.size()) {
+        if (minima[k] < best) {
+            best = minima[k];
+        }
+        if (k == last) {
+            break;
+        }
+    }
+    return best;
+}
+
+bool matches(bool found, float range, float angle, uint32_t expected) {
+    if (expected == SectorIndex::EMPTY) {
+        return !found;
+    }
+    return found && range == static_cast<float>((expected >> 16) / 1000.f) &&
+           angle == static_cast<float>((expected & 0xffff) / 100.0f);
+}
+
+}
+
+int main()
+{
+    const size_t counts[] = {1, 2, 3, 7, 64, 360, 1000, 3599, 3600};
+    size_t queries = 0;
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        const size_t sectors = counts[c];
+        SectorIndex index;
+        check(index.setSectors(sectors), "setSectors", sectors, 0, 0);
+        //同一个索引重复使用，上一圈的值必须被reset清掉
+        for (int n = 0; n < 20; n++) {
+            std::vector<node_info> nodes;
+            makeScan(nodes);
+            index.reset();
+            for (size_t i = 0; i < nodes.size(); i++) {
+                index.add(nodes[i]);
+            }
+            index.finish(n + 1, 1000 + n);
+            const std::vector<uint32_t> minima = sectorMinima(nodes, sectors);
+            check(index.seq == static_cast<uint64_t>(n + 1) && index.stamp == static_cast<uint64_t>(1000 + n),
+                  "seq", sectors, 0, 0);
+
+            float range = 0;
+            float angle = 0;
+            for (size_t k = 0; k < sectors; k++) {
+                bool found = index.nearest(k, range, angle);
+                check(matches(found, range, angle, bruteForce(minima, k, k)), "sector", sectors, k, k);
+            }
+            for (int q = 0; q < 300; q++) {
+                size_t first = nextRandom() % sectors;
+                size_t last = nextRandom() % sectors;
+                bool found = index.nearest(first, last, range, angle);
+                check(matches(found, range, angle, bruteForce(minima, first, last)),
+                      "range", sectors, first, last);
+
+                float minAngle = (nextRandom() % 72000) / 100.f - 360.f;
+                float maxAngle = (nextRandom() % 72000) / 100.f - 360.f;
+                found = index.nearestBetween(minAngle, maxAngle, range, angle);
+                size_t from = index.sectorOf(minAngle);
+                size_t to = index.sectorOf(maxAngle);
+                if (maxAngle - minAngle >= 360.f || (from == to && maxAngle < minAngle)) {
+                    from = 0;
+                    to = sectors - 1;
+                }
+                check(matches(found, range, angle, bruteForce(minima, from, to)),
+                      "angles", sectors, from, to);
+                queries += 2;
+            }
+        }
+        float range = 0;
+        float angle = 0;
+        check(!index.nearest(sectors, range, angle), "out of range", sectors, sectors, sectors);
+        check(!index.nearest(0, sectors, range, angle), "out of range", sectors, 0, sectors);
+    }
+
+    //没有点时所有查询都失败
+    SectorIndex index;
+    index.setSectors(360);
+    index.reset();
+    index.finish(1, 0);
+    float range = 0;
+    float angle = 0;
+    check(!index.nearest(350, 10, range, angle), "empty", 360, 350, 10);
+    check(!index.setSectors(SectorIndex::MAX_SECTORS + 1) && index.sectors() == 360, "too many", 0, 0, 0);
+    check(index.setSectors(0) && !index.nearestBetween(0.f, 360.f, range, angle), "disabled", 0, 0, 0);
+
+    printf("%zu queries, %d mismatches\n", queries, g_failures);
+    return g_failures ? 1 : 0;
+}
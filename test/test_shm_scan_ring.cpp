@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <vector>
+#include "core/common/ShmScanRing.h"
+
+using namespace ydlidar::core::common;
+
+//共享内存扫描环：发布和读取、被覆盖或正在写的槽位由seqlock发现，
+//第二个发布者接管同名的环后，前一个关闭时不会删掉新环
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            if (g_failures < 20) { \
+                printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            } \
+            g_failures++; \
+        } \
+    } while (0)
+
+const uint32_t SLOTS = 4;
+const uint32_t CAPACITY = 16;
+
+//第seq圈，每个点的距离记录圈号
+std::vector<node_info> makeScan(uint64_t seq, size_t count) {
+    std::vector<node_info> nodes(count);
+    memset(&nodes[0], 0, count * sizeof(node_info));
+    for (size_t i = 0; i < count; i++) {
+        nodes[i].distance_q2 = static_cast<uint16_t>(seq);
+        nodes[i].angle_q6_checkbit = static_cast<uint16_t>(i);
+        nodes[i].stamp = seq * 1000 + i;
+    }
+    return nodes;
+}
+
+void publish(ShmScanPublisher &publisher, uint64_t seq, size_t count = 10) {
+    std::vector<node_info> nodes = makeScan(seq, count);
+    publisher.publish(&nodes[0], count, seq);
+}
+
+bool isScan(const ShmScanSlot *slot, uint64_t seq, size_t count) {
+    if (slot->seq != seq || slot->count != count || slot->stamp != seq * 1000) {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (slot->nodes[i].distance_q2 != seq || slot->nodes[i].angle_q6_checkbit != i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//名字是否还在
+bool exists(const char *name) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    close(fd);
+    return true;
+}
+
+void testPublish(const char *name) {
+    ShmScanReader reader;
+    CHECK(!reader.attach(name));
+
+    ShmScanPublisher publisher;
+    CHECK(publisher.open(name, SLOTS, CAPACITY));
+    CHECK(publisher.isOpen());
+    CHECK(reader.attach(name));
+    CHECK(reader.slotCount() == SLOTS);
+
+    //还没有发布
+    uint32_t ticket = 0;
+    node_info nodes[CAPACITY];
+    size_t count = CAPACITY;
+    uint64_t seq = 0;
+    CHECK(reader.latestSeq() == 0);
+    CHECK(reader.acquire(0, ticket) == NULL && reader.acquire(1, ticket) == NULL);
+    CHECK(!reader.readLatest(nodes, count, seq) && count == 0);
+
+    for (uint64_t s = 1; s <= 6; s++) {
+        publish(publisher, s);
+    }
+    CHECK(reader.latestSeq() == 6);
+    count = CAPACITY;
+    CHECK(reader.readLatest(nodes, count, seq) && seq == 6 && count == 10);
+    CHECK(nodes[9].distance_q2 == 6 && nodes[9].angle_q6_checkbit == 9);
+
+    //最近SLOTS圈都在，更早的已被覆盖
+    for (uint64_t s = 3; s <= 6; s++) {
+        const ShmScanSlot *slot = reader.acquire(s, ticket);
+        CHECK(slot != NULL && isScan(slot, s, 10) && reader.validate(slot, ticket));
+    }
+    CHECK(reader.acquire(2, ticket) == NULL);
+    CHECK(reader.acquire(7, ticket) == NULL);
+
+    //超出槽位容量的点截断，缓存小时只复制缓存大小
+    publish(publisher, 7, CAPACITY + 5);
+    const ShmScanSlot *slot = reader.acquire(7, ticket);
+    CHECK(slot != NULL && isScan(slot, 7, CAPACITY));
+    count = 4;
+    CHECK(reader.readLatest(nodes, count, seq) && seq == 7 && count == 4);
+
+    //读取时同一槽位被下一轮覆盖，validate发现数据不一致
+    slot = reader.acquire(7, ticket);
+    CHECK(slot != NULL && reader.validate(slot, ticket));
+    publish(publisher, 7 + SLOTS);
+    CHECK(!reader.validate(slot, ticket));
+    CHECK(reader.acquire(7, ticket) == NULL);
+    CHECK(reader.acquire(7 + SLOTS, ticket) == slot);
+
+    //发布者写到一半（lock为奇数）时读不到这一圈
+    int fd = shm_open(name, O_RDWR, 0);
+    CHECK(fd >= 0);
+    if (fd >= 0) {
+        struct stat st;
+        fstat(fd, &st);
+        void *addr = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        CHECK(addr != MAP_FAILED);
+        if (addr != MAP_FAILED) {
+            ShmScanHeader *header = static_cast<ShmScanHeader *>(addr);
+            ShmScanSlot *writing = reinterpret_cast<ShmScanSlot *>(
+                                       reinterpret_cast<uint8_t *>(header + 1) +
+                                       ((7 + SLOTS) % SLOTS) * header->slotSize);
+            writing->lock++;
+            CHECK(reader.acquire(7 + SLOTS, ticket) == NULL);
+            count = CAPACITY;
+            CHECK(!reader.readLatest(nodes, count, seq) && count == 0);
+            writing->lock++;
+            count = CAPACITY;
+            CHECK(reader.readLatest(nodes, count, seq) && seq == 7 + SLOTS);
+            munmap(addr, st.st_size);
+        }
+    }
+
+    //关闭后名字删除，已经映射的读取方仍可读
+    publisher.close();
+    CHECK(!publisher.isOpen());
+    CHECK(!exists(name));
+    CHECK(reader.latestSeq() == 7 + SLOTS);
+    reader.detach();
+    CHECK(reader.latestSeq() == 0 && reader.slotCount() == 0);
+
+    CHECK(!publisher.open(name, 0, CAPACITY));
+    CHECK(!publisher.open(name, SLOTS, 0));
+    CHECK(!publisher.open(NULL, SLOTS, CAPACITY));
+}
+
+void testTakeOver(const char *name) {
+    ShmScanPublisher first;
+    CHECK(first.open(name, SLOTS, CAPACITY));
+    publish(first, 1);
+    ShmScanReader oldReader;
+    CHECK(oldReader.attach(name));
+
+    //同名已存在时不接管就失败，原来的环不受影响
+    ShmScanPublisher second;
+    CHECK(!second.open(name, SLOTS, CAPACITY));
+    CHECK(oldReader.latestSeq() == 1);
+
+    //接管后新的读取方看到新环，旧的读取方留在旧环上
+    CHECK(second.open(name, SLOTS * 2, CAPACITY, true));
+    publish(second, 5);
+    publish(first, 2);
+    ShmScanReader newReader;
+    CHECK(newReader.attach(name));
+    CHECK(newReader.slotCount() == SLOTS * 2 && newReader.latestSeq() == 5);
+    CHECK(oldReader.slotCount() == SLOTS && oldReader.latestSeq() == 2);
+
+    //前一个发布者关闭时名字已属于新环，不删除
+    first.close();
+    CHECK(exists(name));
+    ShmScanReader again;
+    CHECK(again.attach(name) && again.latestSeq() == 5);
+    CHECK(oldReader.latestSeq() == 2);
+
+    second.close();
+    CHECK(!exists(name));
+    CHECK(!again.attach(name));
+}
+
+}
+
+int main()
+{
+    char name[64];
+    snprintf(name, sizeof(name), "/tea_test_scan_ring_%d", static_cast<int>(getpid()));
+    shm_unlink(name);
+    testPublish(name);
+    testTakeOver(name);
+    shm_unlink(name);
+    printf("%d failures\n", g_failures);
+    return g_failures ? 1 : 0;
+}
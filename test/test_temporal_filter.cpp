@@ -0,0 +1,194 @@
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+#include "filters/TemporalFilter.h"
+
+//多圈滤波：静止的墙一直保留，一圈的斑点在得到M圈确认前被去掉，
+//每圈角度抖动一格仍算同一点，中值策略取各圈的中间距离
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            if (g_failures < 20) { \
+                printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            } \
+            g_failures++; \
+        } \
+    } while (0)
+
+uint32_t g_seed = 20261019;
+
+uint32_t nextRandom() {
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return g_seed >> 8;
+}
+
+const float BIN = 0.25f; //默认的角度格宽度
+const int POINTS = 1440;
+
+void addPoint(LaserScan &scan, float angle, float range) {
+    LaserPoint point;
+    point.angle = angle;
+    point.range = range;
+    point.intensity = 100.f;
+    scan.points.push_back(point);
+}
+
+/**
+ * @brief A static wall, one point in the middle of every bin, with a few
+ * millimeters of noise, every 97th point invalid
+ * @param shift      bins the angles of this revolution are shifted by
+ */
+void makeWall(LaserScan &scan, int shift = 0) {
+    scan.points.clear();
+    scan.config.min_range = 0.01f;
+    scan.config.max_range = 64.f;
+    for (int k = 0; k < POINTS; k++) {
+        float angle = (k + shift + 0.5f) * BIN;
+        float range = 3.f + 0.5f * static_cast<float>(sin(k * M_PI / 720));
+        range += (static_cast<int>(nextRandom() % 11) - 5) / 1000.f;
+        addPoint(scan, angle, k % 97 ? range : 0.f);
+    }
+}
+
+//墙上的点都保留，原样输出
+bool wallKept(const LaserScan &in, const LaserScan &out, size_t count = POINTS) {
+    for (size_t i = 0; i < count; i++) {
+        if (out.points[i].range != in.points[i].range) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void testConfirm() {
+    TemporalFilter filter;
+    CHECK(filter.setHistory(5, 3));
+    LaserScan in;
+    LaserScan out;
+    //1.5米处的斑点在这些圈出现：第0圈，第5圈，第10、12、14圈
+    for (int turn = 0; turn < 16; turn++) {
+        makeWall(in);
+        bool speckle = turn == 0 || turn == 5 || turn == 10 || turn == 12 || turn == 14;
+        if (speckle) {
+            addPoint(in, 90.125f, 1.5f);
+        }
+        filter.filter(in, 0, 0, out);
+        CHECK(out.points.size() == in.points.size());
+        //前两圈还不够3次确认，原样输出
+        if (turn < 2) {
+            CHECK(wallKept(in, out, in.points.size()));
+            continue;
+        }
+        CHECK(wallKept(in, out));
+        if (speckle) {
+            //第14圈时最近5圈里第10、12圈也有，够3次
+            CHECK((out.points[POINTS].range == 0.f) == (turn != 14));
+        }
+    }
+
+    //新出现并留下的物体在出现后的第3圈得到确认
+    filter.reset();
+    for (int turn = 0; turn < 8; turn++) {
+        makeWall(in);
+        if (turn >= 4) {
+            addPoint(in, 200.375f, 1.2f);
+        }
+        filter.filter(in, 0, 0, out);
+        CHECK(wallKept(in, out));
+        if (turn >= 4) {
+            CHECK((out.points[POINTS].range == 0.f) == (turn < 6));
+        }
+    }
+    //每圈变远超过容差的点得不到确认；格内最近和最远之间的距离都算确认，所以点在墙后
+    for (int turn = 0; turn < 6; turn++) {
+        makeWall(in);
+        addPoint(in, 200.375f, 4.f + 0.3f * turn);
+        filter.filter(in, 0, 0, out);
+        CHECK(out.points[POINTS].range == 0.f);
+    }
+
+    CHECK(!filter.setHistory(0, 0));
+    CHECK(!filter.setHistory(3, 4));
+    CHECK(!filter.setHistory(MAX_TEMPORAL_HISTORY + 1, 1));
+    CHECK(!filter.setBins(0.f));
+}
+
+void testJitter() {
+    TemporalFilter filter;
+    filter.setHistory(5, 3);
+    LaserScan in;
+    LaserScan out;
+    //每圈的角度随机错开0或1格，墙和细柱子都保留
+    for (int turn = 0; turn < 12; turn++) {
+        int shift = static_cast<int>(nextRandom() % 2);
+        makeWall(in, shift);
+        addPoint(in, 45.125f + shift * BIN, 1.5f);
+        filter.filter(in, 0, 0, out);
+        CHECK(wallKept(in, out, in.points.size()));
+    }
+    //每圈移动两格的点找不到相邻格的确认
+    filter.reset();
+    for (int turn = 0; turn < 12; turn++) {
+        makeWall(in);
+        addPoint(in, 45.125f + turn * 2 * BIN, 1.5f);
+        filter.filter(in, 0, 0, out);
+        CHECK(wallKept(in, out));
+        if (turn >= 2) {
+            CHECK(out.points[POINTS].range == 0.f);
+        }
+    }
+    //格在0度回绕，359.875度与0.125度相邻
+    filter.reset();
+    for (int turn = 0; turn < 6; turn++) {
+        makeWall(in);
+        addPoint(in, turn % 2 ? 359.875f : 0.125f, 1.5f);
+        filter.filter(in, 0, 0, out);
+        CHECK(out.points[POINTS].range == 1.5f);
+    }
+}
+
+void testMedian() {
+    TemporalFilter filter;
+    filter.setHistory(5, 1);
+    filter.setStrategy(TemporalFilter::FS_Median);
+    //同一格的距离依次为下列值，输出为最近5圈的中值，偶数个时取较小的
+    const float ranges[] = {3.0f, 3.2f, 2.9f, 5.0f, 3.1f, 3.3f, 3.4f};
+    const float medians[] = {3.0f, 3.0f, 3.0f, 3.0f, 3.1f, 3.2f, 3.3f};
+    LaserScan in;
+    LaserScan out;
+    in.config.min_range = 0.01f;
+    in.config.max_range = 64.f;
+    for (size_t turn = 0; turn < sizeof(ranges) / sizeof(ranges[0]); turn++) {
+        in.points.clear();
+        addPoint(in, 10.125f, ranges[turn]);
+        //同一格里的近点和远点各自取中值，不会混在一起
+        addPoint(in, 20.125f, 1.f + turn * 0.01f);
+        addPoint(in, 20.125f, 4.f + turn * 0.01f);
+        addPoint(in, 30.125f, 0.f);
+        addPoint(in, 40.125f, 70.f);
+        filter.filter(in, 0, 0, out);
+        CHECK(out.points[0].range == medians[turn]);
+        //最近count圈的值递增，中值是其中第(count - 1) / 2个
+        int count = turn < 5 ? static_cast<int>(turn) + 1 : 5;
+        float median = (static_cast<int>(turn) + 1 - count + (count - 1) / 2) * 0.01f;
+        CHECK(fabs(out.points[1].range - (1.f + median)) < 1e-5);
+        CHECK(fabs(out.points[2].range - (4.f + median)) < 1e-5);
+        //无效和超出量程的点不变
+        CHECK(out.points[3].range == 0.f && out.points[4].range == 70.f);
+    }
+}
+
+}
+
+int main()
+{
+    testConfirm();
+    testJitter();
+    testMedian();
+    printf("%d failures\n", g_failures);
+    return g_failures ? 1 : 0;
+}
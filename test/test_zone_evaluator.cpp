@@ -0,0 +1,204 @@
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+#include "core/common/ZoneEvaluator.h"
+
+using namespace ydlidar::core::common;
+
+//区域边界上的点、经过0度的区域、8个区域同时评估、按帧上报，以及与点在多边形内判断的比较
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            if (g_failures < 20) { \
+                printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            } \
+            g_failures++; \
+        } \
+    } while (0)
+
+//矩形[x0, x1] x [y0, y1]
+std::vector<float> box(float x0, float y0, float x1, float y1) {
+    float polygon[] = {x0, y0, x1, y0, x1, y1, x0, y1};
+    return std::vector<float>(polygon, polygon + 8);
+}
+
+//单个点落在哪些区域，每位一个区域
+uint32_t hits(ZoneEvaluator &zones, uint16_t angle, uint16_t distance) {
+    ZoneEvent events[ZoneEvaluator::MAX_ZONES];
+    zones.check(angle, distance);
+    size_t count = zones.collect(events, 0);
+    uint32_t mask = 0;
+    for (size_t i = 0; i < count; i++) {
+        mask |= 1u << events[i].zone;
+    }
+    return mask;
+}
+
+void testBoundary() {
+    ZoneEvaluator zones;
+    CHECK(zones.addZone(box(1.f, -0.5f, 2.f, 0.5f)) == 0);
+    //0度方向上区域是[1000, 2000]毫米，两端都包含
+    CHECK(hits(zones, 0, 999) == 0);
+    CHECK(hits(zones, 0, 1000) == 1);
+    CHECK(hits(zones, 0, 2000) == 1);
+    CHECK(hits(zones, 0, 2001) == 0);
+    CHECK(hits(zones, 0, 0) == 0);
+    //90度方向上的边y = 0.5
+    CHECK(zones.addZone(box(-0.5f, 0.5f, 0.5f, 1.5f)) == 1);
+    CHECK(hits(zones, 9000, 499) == 0);
+    CHECK(hits(zones, 9000, 500) == 2);
+    CHECK(hits(zones, 9000, 1500) == 2);
+    CHECK(hits(zones, 9000, 1501) == 0);
+    //斜边上：45度方向经过(1, 1)，距离1414.2毫米
+    ZoneEvaluator corner;
+    corner.addZone(box(1.f, 1.f, 2.f, 2.f));
+    CHECK(hits(corner, 4500, 1414) == 0);
+    CHECK(hits(corner, 4500, 1415) == 1);
+    CHECK(hits(corner, 4500, 2828) == 1);
+    CHECK(hits(corner, 4500, 2829) == 0);
+}
+
+void testAcrossZero() {
+    ZoneEvaluator zones;
+    //区域跨过0度，从-26.57度到26.57度
+    zones.addZone(box(1.f, -0.5f, 2.f, 0.5f));
+    CHECK(hits(zones, 35999, 1500) == 1);
+    CHECK(hits(zones, 1, 1500) == 1);
+    CHECK(hits(zones, 33400, 1500) == 0);
+    CHECK(hits(zones, 2700, 1500) == 0);
+    CHECK(hits(zones, 18000, 1500) == 0);
+
+    //包含雷达的区域从1毫米开始，距离0是无效点
+    ZoneEvaluator around;
+    around.addZone(box(-1.f, -1.f, 1.f, 1.f));
+    for (uint16_t angle = 0; angle < ZoneEvaluator::ANGLE_STEPS; angle += 750) {
+        CHECK(hits(around, angle, 0) == 0);
+        CHECK(hits(around, angle, 1) == 1);
+        CHECK(hits(around, angle, 999) == 1);
+    }
+    CHECK(hits(around, 4500, 1414) == 1);
+    CHECK(hits(around, 4500, 1415) == 0);
+}
+
+void testEightZones() {
+    ZoneEvaluator zones;
+    CHECK(!zones.isActive());
+    //8个45度方向的小区域，中心在3米处
+    for (int z = 0; z < ZoneEvaluator::MAX_ZONES; z++) {
+        double rad = z * M_PI / 4;
+        float x = static_cast<float>(3 * cos(rad));
+        float y = static_cast<float>(3 * sin(rad));
+        CHECK(zones.addZone(box(x - 0.2f, y - 0.2f, x + 0.2f, y + 0.2f)) == z);
+    }
+    CHECK(zones.addZone(box(0.f, 0.f, 1.f, 1.f)) == -1);
+    CHECK(zones.size() == ZoneEvaluator::MAX_ZONES && zones.isActive());
+    for (int z = 0; z < ZoneEvaluator::MAX_ZONES; z++) {
+        CHECK(hits(zones, static_cast<uint16_t>(z * 4500), 3000) == 1u << z);
+        CHECK(hits(zones, static_cast<uint16_t>(z * 4500 + 2250), 3000) == 0);
+    }
+    zones.clear();
+    CHECK(!zones.isActive() && zones.size() == 0);
+    CHECK(zones.addZone(std::vector<float>(4, 1.f)) == -1);
+    CHECK(zones.addZone(std::vector<float>(7, 1.f)) == -1);
+}
+
+void testFrames() {
+    ZoneEvaluator zones;
+    zones.addZone(box(1.f, -0.5f, 2.f, 0.5f));
+    zones.addZone(box(-2.f, -0.5f, -1.f, 0.5f));
+    ZoneEvent events[ZoneEvaluator::MAX_ZONES];
+
+    //第一帧：区域0有三个点，最近的是1200毫米、359.5度的点；区域1没有点
+    zones.check(100, 1800);
+    zones.check(35950, 1200);
+    zones.check(200, 1500);
+    zones.check(9000, 1200);
+    size_t count = zones.collect(events, 111);
+    CHECK(count == 1);
+    CHECK(events[0].zone == 0 && events[0].points == 3 && events[0].stamp == 111);
+    CHECK(events[0].range == 1.2f && events[0].angle == 359.5f);
+
+    //计数按帧清零
+    CHECK(zones.collect(events, 222) == 0);
+
+    //第二帧两个区域都有点，距离相同时取角度小的
+    zones.check(18000, 1500);
+    zones.check(17950, 1500);
+    zones.check(0, 1999);
+    count = zones.collect(events, 333);
+    CHECK(count == 2);
+    CHECK(events[0].zone == 0 && events[0].points == 1 && events[0].range == 1.999f);
+    CHECK(events[1].zone == 1 && events[1].points == 2 && events[1].angle == 179.5f);
+    CHECK(events[1].stamp == 333);
+}
+
+//凸多边形内的点，边界附近1毫米以内不比较
+int inside(const std::vector<float> &polygon, double x, double y) {
+    const size_t n = polygon.size() / 2;
+    double minimum = 1e9;
+    bool negative = false;
+    bool positive = false;
+    for (size_t i = 0; i < n; i++) {
+        size_t j = (i + 1) % n;
+        double ex = polygon[2 * j] - polygon[2 * i];
+        double ey = polygon[2 * j + 1] - polygon[2 * i + 1];
+        double cross = (ex * (y - polygon[2 * i + 1]) - ey * (x - polygon[2 * i])) / hypot(ex, ey);
+        minimum = fmin(minimum, fabs(cross));
+        negative |= cross < 0;
+        positive |= cross > 0;
+    }
+    if (minimum < 1e-3) {
+        return -1;
+    }
+    return negative && positive ? 0 : 1;
+}
+
+void testConvex() {
+    uint32_t seed = 20261019;
+    for (int n = 0; n < 20; n++) {
+        //以(cx, cy)为中心、随机大小和朝向的正多边形
+        std::vector<float> polygon;
+        seed = seed * 1664525u + 1013904223u;
+        double cx = (seed >> 8) % 4000 / 1000.0 - 2;
+        seed = seed * 1664525u + 1013904223u;
+        double cy = (seed >> 8) % 4000 / 1000.0 - 2;
+        seed = seed * 1664525u + 1013904223u;
+        const double radius = 0.3 + (seed >> 8) % 1000 / 1000.0;
+        seed = seed * 1664525u + 1013904223u;
+        const double phase = (seed >> 8) % 1000 / 1000.0;
+        const int vertices = 3 + n % 6;
+        for (int v = 0; v < vertices; v++) {
+            double rad = 2 * M_PI * (v + phase) / vertices;
+            polygon.push_back(static_cast<float>(cx + radius * cos(rad)));
+            polygon.push_back(static_cast<float>(cy + radius * sin(rad)));
+        }
+        ZoneEvaluator zones;
+        CHECK(zones.addZone(polygon) == 0);
+        for (uint16_t angle = 0; angle < ZoneEvaluator::ANGLE_STEPS; angle += 37) {
+            double rad = angle * M_PI / 18000;
+            for (uint16_t distance = 1; distance < 5000; distance += 13) {
+                int expected = inside(polygon, distance / 1000.0 * cos(rad), distance / 1000.0 * sin(rad));
+                if (expected >= 0) {
+                    CHECK(hits(zones, angle, distance) == static_cast<uint32_t>(expected));
+                }
+            }
+        }
+    }
+}
+
+}
+
+int main()
+{
+    testBoundary();
+    testAcrossZero();
+    testEightZones();
+    testFrames();
+    testConvex();
+    printf("%d failures\n", g_failures);
+    return g_failures ? 1 : 0;
+}